@@ -10,18 +10,26 @@
 #include "assembler.hpp"
 #include "basic_solver.hpp"
 #include "SolutionProcedure.hpp"
+#include "ExplicitDynamicsProcedure.hpp"
 #include "LoadManager.hpp"
 #include "Scribe.hpp"
 #include "NodalRestraint.hpp"
 #include "tpetra_wrappers.hpp"
 
+constexpr std::array<char, 8> SETUP_SNAPSHOT_MAGIC = {'B', 'L', 'Z', 'S', 'E', 'T', 'U', 'P'}; /**< identifies Blaze setup snapshot files.*/
+constexpr int SETUP_SNAPSHOT_VERSION = 1; /**< layout version of the setup snapshot files; increased whenever the layout changes.*/
+
 class Model
 {
+    protected:
+        bool setup_from_snapshot = false; /**< true if the mesh was read from a setup snapshot, whose nodes already carry their restraints and DoF numbering.*/
+
     public:
         GlobalMesh glob_mesh; 
         Assembler assembler;
         BasicSolver solver;
         SolutionProcedure solution_procedure;
+        ExplicitDynamicsProcedure dynamic_procedure;
         LoadManager load_manager;
         Scribe scribe;
         std::vector<NodalRestraint> restraints;
@@ -41,18 +49,25 @@ class Model
         void initialise_restraints_n_loads()
         {
             // apply the restraints to the global mesh and thus reduce the active freedoms. 
+            // a mesh read from a setup snapshot was restrained and numbered when the snapshot was written.
             #ifdef WITH_MPI
                 comm = Teuchos::rcp(new Teuchos::MpiComm<int>(MPI_COMM_WORLD));
-                for (auto& restraint : restraints)
+                if (!setup_from_snapshot)
                 {
-                    restraint.apply_restraints();
+                    for (auto& restraint : restraints)
+                    {
+                        restraint.apply_restraints();
+                    }
+                    glob_mesh.count_and_exchange_distributed_dofs();
+                    glob_mesh.find_max_num_stiffness_contributions();
                 }
-                glob_mesh.count_and_exchange_distributed_dofs();
-                glob_mesh.find_max_num_stiffness_contributions();
             #else
-                for (auto& restraint : restraints)
+                if (!setup_from_snapshot)
                 {
-                    restraint.apply_restraints(glob_mesh);
+                    for (auto& restraint : restraints)
+                    {
+                        restraint.apply_restraints(glob_mesh);
+                    }
                 }
             #endif
             // initialise all the loads from the load manager
@@ -71,6 +86,7 @@ class Model
             #endif
             assembler.assemble_global_P(glob_mesh);
 
+            glob_mesh.first_touch_element_storage();
             assembler.map_U_to_nodes(glob_mesh);
             glob_mesh.update_elements_states();
             assembler.initialise_stiffness_matrix(glob_mesh);
@@ -86,11 +102,103 @@ class Model
             solver.initialise_solver(assembler);
         }
 
+        /**
+         * @brief switches symmetric storage and \f$\boldsymbol{LDL}^T\f$ factorisation of the stiffness matrix on or off. Must be called before \ref initialise_solution_parameters.
+         * 
+         * @param symmetric true to assemble only the upper triangle of \f$\boldsymbol{K}\f$ and factorise it as symmetric.
+         */
+        void set_symmetric_stiffness(bool symmetric)
+        {
+            assembler.set_symmetric_storage(symmetric);
+        }
+
+        /**
+         * @brief switches the matrix-free Newton-Krylov mode on or off. In this mode the global stiffness matrix is never assembled and \f$\Delta\boldsymbol{U}\f$ is found by the \ref MatrixFreeSolver. Must be called before \ref initialise_restraints_n_loads.
+         * 
+         * @param matrix_free true to solve without assembling \f$\boldsymbol{K}\f$.
+         */
+        void set_matrix_free(bool matrix_free)
+        {
+            assembler.set_matrix_free(matrix_free);
+        }
+
+        /**
+         * @brief switches quasi-Newton iterations on or off. In this mode the factorisation of \f$\boldsymbol{K}\f$ is reused within a load step and corrected with limited-memory BFGS updates; see \ref SolutionProcedure::set_quasi_newton.
+         * 
+         * @param quasi_newton true to use quasi-Newton iterations.
+         * @param max_updates number of BFGS update pairs kept.
+         */
+        void set_quasi_newton(bool quasi_newton, int max_updates = 10)
+        {
+            solution_procedure.set_quasi_newton(quasi_newton);
+            solver.set_max_quasi_newton_updates(max_updates);
+        }
+
+        /**
+         * @brief sets the predictor used at the start of each load step; see \ref SolutionProcedure::set_predictor.
+         * 
+         * @param predictor one of \ref NoPredictor, \ref TangentPredictor or \ref SecantPredictor.
+         */
+        void set_predictor(PredictorType predictor)
+        {
+            solution_procedure.set_predictor(predictor);
+        }
+
+        /**
+         * @brief sets the largest change in element displacements for which an element keeps its cached state; see \ref GlobalMesh::set_element_skip_tolerance.
+         * 
+         * @param tolerance zero to only skip elements that did not move; negative to re-evaluate every element.
+         */
+        void set_element_skip_tolerance(real tolerance)
+        {
+            glob_mesh.set_element_skip_tolerance(tolerance);
+        }
+
+        /**
+         * @brief writes a binary checkpoint of each rank every \p checkpoint_interval load steps; see \ref SolutionProcedure::set_checkpointing.
+         */
+        void set_checkpointing(int checkpoint_interval, std::string file_prefix)
+        {
+            solution_procedure.set_checkpointing(checkpoint_interval, file_prefix);
+        }
+
+        /**
+         * @brief writes the displacements of all nodes and the forces and plastic strains of all elements every \p output_interval load steps; see \ref SolutionProcedure::set_field_output.
+         */
+        void set_field_output(int output_interval, std::string file_prefix)
+        {
+            solution_procedure.set_field_output(output_interval, file_prefix);
+        }
+
+        /**
+         * @brief continues an analysis from the checkpoint written after \p completed_steps load steps. The model must be built and initialised as it was for the original analysis, including \ref initialise_restraints_n_loads and \ref initialise_solution_parameters; \ref solve then runs the remaining steps.
+         */
+        void restart_from_checkpoint(std::string file_prefix, int completed_steps)
+        {
+            solution_procedure.restart_from_checkpoint(file_prefix, completed_steps, glob_mesh, assembler, scribe);
+        }
+
         void solve(int logging_frequency = -1)
         {
             solution_procedure.solve(glob_mesh, assembler, solver, load_manager, scribe, logging_frequency);
         }
 
+        /**
+         * @brief initialises the parameters of an explicit dynamic analysis; see \ref ExplicitDynamicsProcedure::initialise_dynamic_parameters.
+         */
+        void initialise_dynamic_parameters(real max_load_factor, real end_time, real load_ramp_time, real density, real damping_alpha = 0.0, real time_step = 0.0, int record_every = 1, int check_stability_every = 100)
+        {
+            dynamic_procedure.initialise_dynamic_parameters(max_load_factor, end_time, load_ramp_time, density, damping_alpha, time_step, record_every, check_stability_every);
+        }
+
+        /**
+         * @brief runs an explicit dynamic analysis with the \ref ExplicitDynamicsProcedure in stead of the load-controlled Newton solution.
+         */
+        void solve_dynamic(int logging_frequency = -1)
+        {
+            dynamic_procedure.solve(glob_mesh, assembler, load_manager, scribe, logging_frequency);
+        }
+
 
 
         void create_line_mesh(int divisions, std::vector<coords> end_coords, ElementType elem_type, BeamColumnFiberSection& sect)
@@ -125,6 +233,129 @@ class Model
             glob_mesh.create_distributed_frame_mesh(nbays, nfloors, bay_length, floor_height, beam_divisions, column_divisions, elem_type, sect);
         }
 
+        void create_mesh_from_binary_file(std::string file_name, ElementType elem_type, BeamColumnFiberSection& sect)
+        {
+            glob_mesh.create_mesh_from_binary_file(file_name, elem_type, sect);
+        }
+        void create_mesh_from_binary_file(std::string file_name, ElementType elem_type, BasicSection& sect)
+        {
+            glob_mesh.create_mesh_from_binary_file(file_name, elem_type, sect);
+        }
+        void create_distributed_mesh_from_binary_file(std::string file_name, ElementType elem_type, BeamColumnFiberSection& sect)
+        {
+            glob_mesh.create_distributed_mesh_from_binary_file(file_name, elem_type, sect);
+        }
+        void create_distributed_mesh_from_binary_file(std::string file_name, ElementType elem_type, BasicSection& sect)
+        {
+            glob_mesh.create_distributed_mesh_from_binary_file(file_name, elem_type, sect);
+        }
+
+
+        /**
+         * @brief Get the name of the setup snapshot file of \p rank.
+         */
+        static std::string get_setup_snapshot_file_name(std::string file_prefix, int rank)
+        {
+            return file_prefix + "_rank" + std::to_string(rank) + ".blzsetup";
+        }
+
+        /**
+         * @brief writes a setup snapshot of this rank to `<file_prefix>_rank<rank>.blzsetup`. Must be called after \ref initialise_restraints_n_loads.
+         * @details the snapshot holds the mesh as set up on this rank, including the restraints and DoF numbering, and the structure of the stiffness matrix; see \ref GlobalMesh::write_setup_snapshot and \ref Assembler::write_setup_snapshot.
+         * It holds no sections, loads, or results, so analyses that only change these can start from it with \ref create_mesh_from_setup_snapshot.
+         */
+        void write_setup_snapshot(std::string file_prefix)
+        {
+            int rank = glob_mesh.get_mesh_rank();
+            int num_ranks = glob_mesh.get_mesh_num_ranks();
+            std::string file_name = get_setup_snapshot_file_name(file_prefix, rank);
+            std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                std::cout << "Model::write_setup_snapshot: could not open setup snapshot file " << file_name << "." << std::endl;
+                exit(1);
+            }
+            write_binary(out, SETUP_SNAPSHOT_MAGIC);
+            write_binary(out, SETUP_SNAPSHOT_VERSION);
+            write_binary(out, rank);
+            write_binary(out, num_ranks);
+            glob_mesh.write_setup_snapshot(out);
+            assembler.write_setup_snapshot(out, glob_mesh);
+            if (!out)
+            {
+                std::cout << "Model::write_setup_snapshot: could not write setup snapshot file " << file_name << "." << std::endl;
+                exit(1);
+            }
+        }
+
+        /**
+         * @brief creates the mesh of this rank from the setup snapshot written by \ref write_setup_snapshot with the same number of ranks, with elements of \p elem_type made from \p sect.
+         * Loads and records are then assigned as usual; restraints must not be added again, as the snapshot already applied them, and \ref initialise_restraints_n_loads skips numbering the DoFs and finding the structure of the stiffness matrix.
+         */
+        void create_mesh_from_setup_snapshot(std::string file_prefix, ElementType elem_type, BeamColumnFiberSection& sect)
+        {
+            std::ifstream in = open_setup_snapshot(file_prefix);
+            glob_mesh.create_mesh_from_setup_snapshot(in, elem_type, sect);
+            assembler.read_setup_snapshot(in);
+            setup_from_snapshot = true;
+        }
+        void create_mesh_from_setup_snapshot(std::string file_prefix, ElementType elem_type, BasicSection& sect)
+        {
+            std::ifstream in = open_setup_snapshot(file_prefix);
+            glob_mesh.create_mesh_from_setup_snapshot(in, elem_type, sect);
+            assembler.read_setup_snapshot(in);
+            setup_from_snapshot = true;
+        }
+
+        /**
+         * @brief opens the setup snapshot of this rank and checks its header. Exits if it is not a setup snapshot or was written by a different rank or number of ranks.
+         */
+        std::ifstream open_setup_snapshot(std::string file_prefix)
+        {
+            int rank = 0, num_ranks = 1;
+            get_my_rank(rank);
+            get_num_ranks(num_ranks);
+            std::string file_name = get_setup_snapshot_file_name(file_prefix, rank);
+            std::ifstream in(file_name, std::ios::binary);
+            if (!in)
+            {
+                std::cout << "Model::open_setup_snapshot: could not open setup snapshot file " << file_name << "." << std::endl;
+                exit(1);
+            }
+            std::array<char, 8> magic;
+            int version, snapshot_rank, snapshot_num_ranks;
+            read_binary(in, magic);
+            read_binary(in, version);
+            if (magic != SETUP_SNAPSHOT_MAGIC || version != SETUP_SNAPSHOT_VERSION)
+            {
+                std::cout << "Model::open_setup_snapshot: " << file_name << " is not a version " << SETUP_SNAPSHOT_VERSION << " setup snapshot file." << std::endl;
+                exit(1);
+            }
+            read_binary(in, snapshot_rank);
+            read_binary(in, snapshot_num_ranks);
+            if (snapshot_rank != rank || snapshot_num_ranks != num_ranks)
+            {
+                std::cout << "Model::open_setup_snapshot: " << file_name << " was written by rank " << snapshot_rank << " of " << snapshot_num_ranks << ", but this is rank " << rank << " of " << num_ranks << "." << std::endl;
+                exit(1);
+            }
+            return in;
+        }
+
+        /**
+         * @brief sets when the \ref Scribe records the tracked nodes; see \ref Scribe::set_recording_policy.
+         */
+        void set_recording_policy(RecordingPolicy policy, int interval = 1, real tolerance = 0.0)
+        {
+            scribe.set_recording_policy(policy, interval, tolerance);
+        }
+
+        /**
+         * @brief streams the recorded history of each rank to a file; see \ref Scribe::set_history_output.
+         */
+        void set_history_output(std::string file_prefix, HistoryEncoding encoding = XorHistory, real error_bound = 0.0)
+        {
+            scribe.set_history_output(file_prefix, encoding, error_bound);
+        }
 
         void read_all_records()
         {
@@ -153,6 +384,51 @@ class Model
         {
             solution_procedure.read_timers(timers_names, reference_timer);
         }
+
+        /**
+         * @brief collects the durations of the solution timers, and their communication parts, on all ranks on rank 0; a collective call with MPI. See \ref TimeKeeper::collect_rank_durations.
+         * 
+         * @param timers_names the names of the timers to collect.
+         * @param dynamic whether the timers of the \ref ExplicitDynamicsProcedure are collected in stead of those of the \ref SolutionProcedure.
+         */
+        void collect_solution_timers(std::vector<std::string> timers_names, bool dynamic = false)
+        {
+            get_solution_time_keeper(dynamic).collect_rank_durations(timers_names, true);
+        }
+
+        /**
+         * @brief prints on rank 0 the spread over the ranks of the compute and communication time of each solution phase; a collective call with MPI. See \ref TimeKeeper::log_phase_balance.
+         */
+        void log_phase_balance(std::vector<std::string> phase_names, bool dynamic = false)
+        {
+            get_solution_time_keeper(dynamic).log_phase_balance(phase_names);
+        }
+
+        /**
+         * @brief writes the solution timers collected with \ref collect_solution_timers as `rank,timer,duration` rows; only meaningful on rank 0.
+         */
+        void write_solution_timers_csv(std::ostream& out, std::vector<std::string> timers_names, bool dynamic = false, bool write_header = true)
+        {
+            get_solution_time_keeper(dynamic).write_rank_durations_csv(out, timers_names, write_header);
+        }
+
+        /**
+         * @brief Get the \ref TimeKeeper of the static or the dynamic solution procedure.
+         */
+        TimeKeeper& get_solution_time_keeper(bool dynamic = false)
+        {
+            if (dynamic)
+                return dynamic_procedure.get_time_keeper();
+            return solution_procedure.get_time_keeper();
+        }
+
+        /**
+         * @brief calls `log_thread_durations` from the \ref SolutionProcedure, printing the busy and idle time of each thread while updating the element states.
+         */
+        void log_thread_durations()
+        {
+            solution_procedure.log_thread_durations();
+        }
 };
 
 #endif 
\ No newline at end of file
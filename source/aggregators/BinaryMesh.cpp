@@ -0,0 +1 @@
+#include "BinaryMesh.hpp"
\ No newline at end of file
@@ -0,0 +1,326 @@
+/**
+ * @file BinaryMesh.hpp
+ * @brief the native binary mesh format of Blaze: writing a mesh file, and reading either all of it or only the part built by one rank.
+ */
+
+#ifndef BINARY_MESH_HPP
+#define BINARY_MESH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "maths_defaults.hpp"
+#include "binary_io.hpp"
+
+constexpr char BINARY_MESH_MAGIC[8] = "BLZMESH"; /**< the first 8 bytes of every binary mesh file.*/
+constexpr std::uint32_t BINARY_MESH_VERSION = 1; /**< incremented whenever the layout of the file changes.*/
+
+/**
+ * @brief the arrays stored in a binary mesh file, in the order they follow the \ref BinaryMeshHeader. Nodes are stored in increasing ID order and elements in increasing ID order, and the elements refer to their nodes by position rather than ID.
+ */
+enum BinaryMeshSection {
+    NodeIds,            /**< std::uint32_t per node.*/
+    NodeCoords,         /**< three real per node.*/
+    ElementIds,         /**< std::uint32_t per element.*/
+    ElementNodeOffsets, /**< std::uint64_t per element plus one: where the nodes of each element start in \ref ElementNodes.*/
+    ElementNodes,       /**< std::uint32_t position of each node of each element.*/
+    ElementSectionIds,  /**< std::uint32_t section ID of each element.*/
+    ElementMaterialIds, /**< std::uint32_t material ID of each element.*/
+    NodeElementOffsets, /**< std::uint64_t per node plus one: where the elements of each node start in \ref NodeElements.*/
+    NodeElements,       /**< std::uint32_t position of each element connected to each node; the index that lets a rank find its elements from its nodes.*/
+    NumBinaryMeshSections
+};
+
+/**
+ * @brief the fixed-size start of a binary mesh file.
+ * @details the file is written in the byte order of the machine that wrote it, and each section starts on an 8-byte boundary so it can be viewed in place once the file is memory-mapped.
+ */
+struct BinaryMeshHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t real_size; /**< sizeof(real) of the writer, so a build with a different \ref real refuses the file.*/
+    std::uint64_t num_nodes;
+    std::uint64_t num_elements;
+    std::uint64_t num_element_nodes; /**< length of the element connectivity, and of its inverse.*/
+    std::uint64_t section_offsets[NumBinaryMeshSections]; /**< byte offset of each \ref BinaryMeshSection from the start of the file.*/
+};
+
+/**
+ * @brief a mesh, or the part of one, as flat arrays. The nodes of element \f$e\f$ are the IDs \f$[\texttt{elem\_node\_offsets}_e, \texttt{elem\_node\_offsets}_{e+1})\f$ of \ref elem_node_ids.
+ */
+struct BinaryMeshData {
+    std::vector<unsigned> node_ids;
+    std::vector<real> node_coords; /**< x, y, and z of each node.*/
+    std::vector<unsigned> elem_ids;
+    std::vector<std::uint64_t> elem_node_offsets = {0};
+    std::vector<unsigned> elem_node_ids;
+    std::vector<unsigned> elem_section_ids;
+    std::vector<unsigned> elem_material_ids;
+
+    size_t num_nodes() const {return node_ids.size();}
+    size_t num_elements() const {return elem_ids.size();}
+};
+
+/**
+ * @brief the part of a mesh that one rank builds, as read by \ref BinaryMeshReader::read_partition.
+ * @details the nodes in \ref mesh are the ones owned by the rank followed by the interface nodes, i.e. the nodes of the rank's elements that are owned by other ranks, each group in ID order. \ref node_ranks holds the owner of each.
+ */
+struct BinaryMeshPartition {
+    BinaryMeshData mesh;
+    size_t num_owned_nodes = 0;
+    std::vector<int> node_ranks;
+};
+
+/**
+ * @brief writes a mesh to a binary mesh file, sorting its nodes and elements by ID and building the node-to-element index. Exits if an element refers to a node that is not in the mesh.
+ *
+ * @param file_name the file to write.
+ * @param mesh the mesh; if its section or material IDs are empty they are written as zeros.
+ */
+inline void write_binary_mesh(std::string file_name, const BinaryMeshData& mesh)
+{
+    size_t num_nodes = mesh.num_nodes();
+    size_t num_elements = mesh.num_elements();
+    std::vector<size_t> node_order(num_nodes), elem_order(num_elements);
+    std::iota(node_order.begin(), node_order.end(), 0);
+    std::iota(elem_order.begin(), elem_order.end(), 0);
+    std::sort(node_order.begin(), node_order.end(), [&](size_t a, size_t b) {return mesh.node_ids[a] < mesh.node_ids[b];});
+    std::sort(elem_order.begin(), elem_order.end(), [&](size_t a, size_t b) {return mesh.elem_ids[a] < mesh.elem_ids[b];});
+
+    std::vector<std::uint32_t> node_ids(num_nodes);
+    std::vector<real> node_coords(3*num_nodes);
+    for (size_t i = 0; i < num_nodes; ++i)
+    {
+        node_ids[i] = mesh.node_ids[node_order[i]];
+        std::copy_n(mesh.node_coords.begin() + 3*node_order[i], 3, node_coords.begin() + 3*i);
+    }
+
+    std::vector<std::uint32_t> elem_ids(num_elements), elem_section_ids(num_elements, 0), elem_material_ids(num_elements, 0);
+    std::vector<std::uint64_t> elem_node_offsets(num_elements + 1, 0);
+    std::vector<std::uint32_t> elem_nodes;
+    elem_nodes.reserve(mesh.elem_node_ids.size());
+    std::vector<std::uint64_t> node_elem_offsets(num_nodes + 1, 0);
+    for (size_t e = 0; e < num_elements; ++e)
+    {
+        size_t original = elem_order[e];
+        elem_ids[e] = mesh.elem_ids[original];
+        if (!mesh.elem_section_ids.empty())
+            elem_section_ids[e] = mesh.elem_section_ids[original];
+        if (!mesh.elem_material_ids.empty())
+            elem_material_ids[e] = mesh.elem_material_ids[original];
+        for (size_t j = mesh.elem_node_offsets[original]; j < mesh.elem_node_offsets[original + 1]; ++j)
+        {
+            auto node_it = std::lower_bound(node_ids.begin(), node_ids.end(), mesh.elem_node_ids[j]);
+            if (node_it == node_ids.end() || *node_it != mesh.elem_node_ids[j])
+            {
+                std::cout << "write_binary_mesh: element " << elem_ids[e] << " refers to node " << mesh.elem_node_ids[j] << " which is not in the mesh." << std::endl;
+                exit(1);
+            }
+            std::uint32_t position = node_it - node_ids.begin();
+            elem_nodes.push_back(position);
+            ++node_elem_offsets[position + 1];
+        }
+        elem_node_offsets[e + 1] = elem_nodes.size();
+    }
+    std::partial_sum(node_elem_offsets.begin(), node_elem_offsets.end(), node_elem_offsets.begin());
+    std::vector<std::uint32_t> node_elems(elem_nodes.size());
+    std::vector<std::uint64_t> node_elem_fill(node_elem_offsets.begin(), node_elem_offsets.end() - 1);
+    for (size_t e = 0; e < num_elements; ++e)
+    {
+        for (size_t j = elem_node_offsets[e]; j < elem_node_offsets[e + 1]; ++j)
+            node_elems[node_elem_fill[elem_nodes[j]]++] = e;
+    }
+
+    BinaryMeshHeader header{};
+    std::memcpy(header.magic, BINARY_MESH_MAGIC, sizeof(header.magic));
+    header.version = BINARY_MESH_VERSION;
+    header.real_size = sizeof(real);
+    header.num_nodes = num_nodes;
+    header.num_elements = num_elements;
+    header.num_element_nodes = elem_nodes.size();
+    size_t section_bytes[NumBinaryMeshSections] = {
+        num_nodes*sizeof(std::uint32_t), 3*num_nodes*sizeof(real), num_elements*sizeof(std::uint32_t),
+        (num_elements + 1)*sizeof(std::uint64_t), elem_nodes.size()*sizeof(std::uint32_t), num_elements*sizeof(std::uint32_t),
+        num_elements*sizeof(std::uint32_t), (num_nodes + 1)*sizeof(std::uint64_t), node_elems.size()*sizeof(std::uint32_t)};
+    const void* section_data[NumBinaryMeshSections] = {
+        node_ids.data(), node_coords.data(), elem_ids.data(), elem_node_offsets.data(), elem_nodes.data(),
+        elem_section_ids.data(), elem_material_ids.data(), node_elem_offsets.data(), node_elems.data()};
+    size_t offset = sizeof(BinaryMeshHeader);
+    for (int section = 0; section < NumBinaryMeshSections; ++section)
+    {
+        offset = (offset + 7)/8*8;
+        header.section_offsets[section] = offset;
+        offset += section_bytes[section];
+    }
+
+    std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        std::cout << "write_binary_mesh: could not open " << file_name << " for writing." << std::endl;
+        exit(1);
+    }
+    write_binary(out, header);
+    const char padding[8] = {};
+    for (int section = 0; section < NumBinaryMeshSections; ++section)
+    {
+        out.write(padding, header.section_offsets[section] - out.tellp());
+        out.write(static_cast<const char*>(section_data[section]), section_bytes[section]);
+    }
+    if (!out)
+    {
+        std::cout << "write_binary_mesh: failed while writing " << file_name << "." << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * @brief reads binary mesh files written by \ref write_binary_mesh through a memory map, so that a rank only reads the pages holding its own nodes and elements.
+ */
+class BinaryMeshReader
+{
+    private:
+        MappedFile file;
+        BinaryMeshHeader header;
+
+        template <typename T>
+        std::span<const T> get_section(BinaryMeshSection section, size_t count) const
+        {
+            return file.get_span<T>(header.section_offsets[section], count);
+        }
+
+        /**
+         * @brief appends node \p position of the file to \p mesh.
+         */
+        void append_node(BinaryMeshData& mesh, size_t position) const
+        {
+            mesh.node_ids.push_back(get_section<std::uint32_t>(NodeIds, header.num_nodes)[position]);
+            std::span<const real> coords = get_section<real>(NodeCoords, 3*header.num_nodes).subspan(3*position, 3);
+            mesh.node_coords.insert(mesh.node_coords.end(), coords.begin(), coords.end());
+        }
+
+        /**
+         * @brief appends element \p position of the file to \p mesh, with its nodes as IDs.
+         */
+        void append_element(BinaryMeshData& mesh, size_t position) const
+        {
+            std::span<const std::uint32_t> node_ids = get_section<std::uint32_t>(NodeIds, header.num_nodes);
+            std::span<const std::uint64_t> offsets = get_section<std::uint64_t>(ElementNodeOffsets, header.num_elements + 1);
+            std::span<const std::uint32_t> elem_nodes = get_section<std::uint32_t>(ElementNodes, header.num_element_nodes);
+            mesh.elem_ids.push_back(get_section<std::uint32_t>(ElementIds, header.num_elements)[position]);
+            for (size_t j = offsets[position]; j < offsets[position + 1]; ++j)
+                mesh.elem_node_ids.push_back(node_ids[elem_nodes[j]]);
+            mesh.elem_node_offsets.push_back(mesh.elem_node_ids.size());
+            mesh.elem_section_ids.push_back(get_section<std::uint32_t>(ElementSectionIds, header.num_elements)[position]);
+            mesh.elem_material_ids.push_back(get_section<std::uint32_t>(ElementMaterialIds, header.num_elements)[position]);
+        }
+
+    public:
+        /**
+         * @brief maps \p file_name and checks its header. Exits if it is not a binary mesh file this build can read.
+         */
+        BinaryMeshReader(std::string file_name) : file(file_name)
+        {
+            header = file.get_span<BinaryMeshHeader>(0, 1)[0];
+            if (std::memcmp(header.magic, BINARY_MESH_MAGIC, sizeof(header.magic)) != 0 || header.version != BINARY_MESH_VERSION || header.real_size != sizeof(real))
+            {
+                std::cout << "BinaryMeshReader: " << file_name << " is not a version " << BINARY_MESH_VERSION << " binary mesh file with " << sizeof(real) << "-byte reals." << std::endl;
+                exit(1);
+            }
+        }
+
+        size_t get_num_nodes() const {return header.num_nodes;}
+        size_t get_num_elements() const {return header.num_elements;}
+
+        /**
+         * @brief Get the rank that owns the node at \p position of the file. As in \ref GlobalMesh::populate_node_rank_maps, each rank owns an equal contiguous range of nodes in ID order, and the last rank also owns the remainder.
+         */
+        static int get_node_rank(size_t position, size_t num_nodes, int num_ranks)
+        {
+            size_t nodes_per_rank = num_nodes/num_ranks;
+            if (nodes_per_rank == 0)
+                return num_ranks - 1;
+            return std::min<size_t>(position/nodes_per_rank, num_ranks - 1);
+        }
+
+        /**
+         * @brief reads the whole mesh.
+         */
+        BinaryMeshData read_all() const
+        {
+            BinaryMeshData mesh;
+            std::span<const std::uint32_t> node_ids = get_section<std::uint32_t>(NodeIds, header.num_nodes);
+            std::span<const real> node_coords = get_section<real>(NodeCoords, 3*header.num_nodes);
+            mesh.node_ids.assign(node_ids.begin(), node_ids.end());
+            mesh.node_coords.assign(node_coords.begin(), node_coords.end());
+            std::span<const std::uint32_t> elem_ids = get_section<std::uint32_t>(ElementIds, header.num_elements);
+            std::span<const std::uint64_t> offsets = get_section<std::uint64_t>(ElementNodeOffsets, header.num_elements + 1);
+            std::span<const std::uint32_t> elem_nodes = get_section<std::uint32_t>(ElementNodes, header.num_element_nodes);
+            std::span<const std::uint32_t> section_ids = get_section<std::uint32_t>(ElementSectionIds, header.num_elements);
+            std::span<const std::uint32_t> material_ids = get_section<std::uint32_t>(ElementMaterialIds, header.num_elements);
+            mesh.elem_ids.assign(elem_ids.begin(), elem_ids.end());
+            mesh.elem_node_offsets.assign(offsets.begin(), offsets.end());
+            mesh.elem_node_ids.resize(elem_nodes.size());
+            for (size_t j = 0; j < elem_nodes.size(); ++j)
+                mesh.elem_node_ids[j] = node_ids[elem_nodes[j]];
+            mesh.elem_section_ids.assign(section_ids.begin(), section_ids.end());
+            mesh.elem_material_ids.assign(material_ids.begin(), material_ids.end());
+            return mesh;
+        }
+
+        /**
+         * @brief reads only the part of the mesh that \p rank builds: the nodes it owns (see \ref get_node_rank), every element connected to them, and the nodes of those elements owned by other ranks.
+         * @details the elements are found from the node-to-element index, so only the slices of the file belonging to this rank and its interface are touched.
+         */
+        BinaryMeshPartition read_partition(int rank, int num_ranks) const
+        {
+            size_t num_nodes = header.num_nodes;
+            size_t nodes_per_rank = num_nodes/num_ranks;
+            size_t first_node = (rank == num_ranks - 1) ? std::min(num_nodes, rank*nodes_per_rank) : rank*nodes_per_rank;
+            size_t last_node = (rank == num_ranks - 1) ? num_nodes : (rank + 1)*nodes_per_rank;
+
+            std::span<const std::uint64_t> node_elem_offsets = get_section<std::uint64_t>(NodeElementOffsets, num_nodes + 1);
+            std::span<const std::uint32_t> node_elems = get_section<std::uint32_t>(NodeElements, header.num_element_nodes);
+            std::vector<std::uint32_t> elements(node_elems.begin() + node_elem_offsets[first_node], node_elems.begin() + node_elem_offsets[last_node]);
+            std::sort(elements.begin(), elements.end());
+            elements.erase(std::unique(elements.begin(), elements.end()), elements.end());
+
+            std::span<const std::uint64_t> elem_node_offsets = get_section<std::uint64_t>(ElementNodeOffsets, header.num_elements + 1);
+            std::span<const std::uint32_t> elem_nodes = get_section<std::uint32_t>(ElementNodes, header.num_element_nodes);
+            std::vector<std::uint32_t> interface_nodes;
+            for (std::uint32_t e : elements)
+            {
+                for (size_t j = elem_node_offsets[e]; j < elem_node_offsets[e + 1]; ++j)
+                {
+                    if (elem_nodes[j] < first_node || elem_nodes[j] >= last_node)
+                        interface_nodes.push_back(elem_nodes[j]);
+                }
+            }
+            std::sort(interface_nodes.begin(), interface_nodes.end());
+            interface_nodes.erase(std::unique(interface_nodes.begin(), interface_nodes.end()), interface_nodes.end());
+
+            BinaryMeshPartition partition;
+            partition.num_owned_nodes = last_node - first_node;
+            partition.mesh.node_ids.reserve(partition.num_owned_nodes + interface_nodes.size());
+            partition.mesh.node_coords.reserve(3*(partition.num_owned_nodes + interface_nodes.size()));
+            partition.node_ranks.reserve(partition.num_owned_nodes + interface_nodes.size());
+            for (size_t i = first_node; i < last_node; ++i)
+            {
+                append_node(partition.mesh, i);
+                partition.node_ranks.push_back(rank);
+            }
+            for (std::uint32_t i : interface_nodes)
+            {
+                append_node(partition.mesh, i);
+                partition.node_ranks.push_back(get_node_rank(i, num_nodes, num_ranks));
+            }
+            for (std::uint32_t e : elements)
+                append_element(partition.mesh, e);
+            return partition;
+        }
+};
+
+#endif
@@ -0,0 +1 @@
+#include "FieldSnapshot.hpp"
\ No newline at end of file
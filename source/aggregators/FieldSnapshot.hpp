@@ -0,0 +1,39 @@
+/**
+ * @file FieldSnapshot.hpp
+ * @brief defines the \ref FieldSnapshot struct which holds the full-field results of one rank at one load step.
+ */
+
+#ifndef FIELD_SNAPSHOT_HPP
+#define FIELD_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <vector>
+#include "maths_defaults.hpp"
+
+/**
+ * @brief the nodal and element results owned by one rank at one load step, gathered by \ref GlobalMesh::gather_field_snapshot and written by the \ref FieldWriter.
+ * @details each array holds this rank's slice of the global array, which starts at \ref node_offset for nodal arrays and at \ref element_offset for element arrays.
+ * The nodes are in their global order, i.e. by rank and then by ID, and an element is owned by the rank that owns its first node.
+ */
+struct FieldSnapshot {
+    int step = 0; /**< number of load steps completed.*/
+    real load_factor = 0.0; /**< load factor of the step.*/
+    size_t num_nodes = 0; /**< number of nodes in the whole mesh.*/
+    size_t num_elements = 0; /**< number of elements in the whole mesh.*/
+    size_t node_offset = 0; /**< global position of the first node of this rank.*/
+    size_t element_offset = 0; /**< global position of the first element owned by this rank.*/
+    std::vector<std::uint32_t> node_ids; /**< record IDs of the nodes.*/
+    std::vector<real> coordinates; /**< x, y, and z of each node.*/
+    std::vector<real> translations; /**< displacements along x, y, and z of each node, i.e. DoFs 0, 2, and 1.*/
+    std::vector<real> rotations; /**< rotations of each node, i.e. DoFs 3, 4, and 5.*/
+    std::vector<std::uint32_t> element_ids; /**< IDs of the elements.*/
+    std::vector<std::uint32_t> connectivity; /**< global positions of the two nodes of each element.*/
+    size_t num_element_forces = 0; /**< number of local forces per element: six nodal forces for linear elements, and \f$[F, M_1, M_2]\f$ for nonlinear ones.*/
+    std::vector<real> element_forces; /**< the \ref num_element_forces local forces of each element.*/
+    std::vector<real> plastic_strains; /**< largest plastic strain of any fibre of each element.*/
+
+    size_t get_num_rank_nodes() const {return node_ids.size();}
+    size_t get_num_rank_elements() const {return element_ids.size();}
+};
+
+#endif
@@ -0,0 +1 @@
+#include "MeshLayout.hpp"
@@ -0,0 +1,75 @@
+/**
+ * @file MeshLayout.hpp
+ * @brief flat, index-based arrays describing the nodes and elements of a \ref GlobalMesh for use inside parallel kernels.
+ */
+
+#ifndef MESH_LAYOUT_HPP
+#define MESH_LAYOUT_HPP
+
+#include <memory>
+#include <vector>
+#include "node.hpp"
+#include "ElementBaseClass.hpp"
+
+/**
+ * @brief the DoF numbering of the nodes and the node and element objects of a mesh, stored in flat arrays.
+ * @details the node objects hold their active DoFs in std::sets and are owned through std::shared_ptrs, neither of which should be built, copied,
+ * or reference-counted inside a parallel kernel. This layout is built once the DoFs are numbered, and the kernels then only index plain arrays of raw pointers and integers.
+ * The active DoFs are stored in compressed rows: those of node \f$i\f$ are entries \f$[\texttt{dof\_offsets}_i, \texttt{dof\_offsets}_{i+1})\f$ of \ref dofs and \ref U_indices.
+ */
+struct MeshLayout {
+    std::vector<Node*> nodes; /**< the rank-owned nodes followed by the interface nodes.*/
+    std::vector<int> dof_offsets; /**< start of the active DoFs of each node in \ref dofs and \ref U_indices; one more entry than \ref nodes.*/
+    std::vector<int> dofs; /**< the active DoFs of the nodes, from 0 to 5, in increasing order per node.*/
+    std::vector<int> U_indices; /**< the row of \f$\boldsymbol{U}\f$ corresponding to each entry of \ref dofs.*/
+    std::vector<ElementBaseClass*> elements; /**< the elements on this rank.*/
+
+    /**
+     * @brief fills the layout from the nodes and elements of a mesh. Must be repeated whenever the DoFs are renumbered or restrained; see \ref GlobalMesh::invalidate_layout.
+     * @param node_vectors the node containers, in the order their nodes are stored.
+     * @param elem_vector the elements.
+     */
+    template <typename ElementPtr>
+    void build(std::vector<const std::vector<std::shared_ptr<Node>>*> node_vectors, const std::vector<ElementPtr>& elem_vector)
+    {
+        size_t num_nodes = 0;
+        size_t num_dofs = 0;
+        for (auto node_vector : node_vectors)
+        {
+            num_nodes += node_vector->size();
+            for (auto& node : *node_vector)
+                num_dofs += node->get_active_dofs().size();
+        }
+        nodes.assign(num_nodes, nullptr);
+        dof_offsets.assign(num_nodes + 1, 0);
+        dofs.assign(num_dofs, 0);
+        U_indices.assign(num_dofs, 0);
+        size_t i = 0;
+        int j = 0;
+        for (auto node_vector : node_vectors)
+        {
+            for (auto& node : *node_vector)
+            {
+                nodes[i] = node.get();
+                dof_offsets[i] = j;
+                int nz_i = node->get_nz_i();
+                for (int dof : node->get_active_dofs())
+                {
+                    dofs[j] = dof;
+                    U_indices[j] = nz_i + (j - dof_offsets[i]);
+                    ++j;
+                }
+                ++i;
+            }
+        }
+        dof_offsets[num_nodes] = j;
+        elements.assign(elem_vector.size(), nullptr);
+        for (size_t e = 0; e < elem_vector.size(); ++e)
+            elements[e] = elem_vector[e].get();
+    }
+
+    size_t num_nodes() const {return nodes.size();}
+    size_t num_elements() const {return elements.size();}
+};
+
+#endif
@@ -39,6 +39,8 @@ class Assembler {
         Teuchos::RCP<TpetraCrsGraph> matrix_graph; /**<a graph that explains which rows of the \f$\boldsymbol{K}\f$ matrix go on which cores.*/
         Teuchos::RCP<TpetraMap> interface_map; /**< a map that is used for communicating the interface DoFs that are globally not locally allocated. */
         Teuchos::RCP<Tpetra::Import<local_ordinal_type, global_ordinal_type, node_type>> interface_importer; /**< the importer object that is meant for communicating the \f$\boldsymbol{U}\f$ values on different nodes and ranks. */
+        std::map<global_ordinal_type, std::vector<global_ordinal_type>> snapshot_graph_rows; /**< the column indices of each row of \ref matrix_graph read from a setup snapshot; empty unless \ref read_setup_snapshot was called, and cleared once the graph is built.*/
+        bool snapshot_import = false; /**< true if \ref interface_importer should be built from the owning ranks of the interface nodes read from a setup snapshot.*/
 
         Teuchos::RCP<TpetraCrsMatrix> K;
         TpetraMultiVector P;
@@ -55,15 +57,59 @@ class Assembler {
         std::vector<spnz> K_global_triplets; /** The container for the triplets that are used for assembling the global stiffness matrix \f$ \boldsymbol{K}\f$ from element contributions.*/
         std::vector<spnz> R_global_triplets; /** The container for the triplets that are used for assembling the global resistance vector \f$ \boldsymbol{R}\f$ from element contributions.*/
         std::vector<spnz> P_global_triplets;  /** The container for the triplets that are used for assembling the global load matrix \f$ \boldsymbol{P}\f$ from nodal contributions.*/
+        bool symmetric_storage = false; /**< if true, only the upper triangle of \f$\boldsymbol{K}\f$ is assembled in the serial build and \ref BasicSolver factorises it with \f$\boldsymbol{LDL}^T\f$.*/
+        bool matrix_free = false; /**< if true, \f$\boldsymbol{K}\f$ is never assembled and \ref MatrixFreeSolver applies it element-by-element instead.*/
+
+        /**
+         * @brief true if the elements should only emit the upper triangle of their stiffness triplets; the distributed build always stores the full \f$\boldsymbol{K}\f$.
+         */
+        bool upper_triangle_only() const
+        {
+            #ifdef WITH_MPI
+            return false;
+            #else
+            return symmetric_storage;
+            #endif
+        }
     public:
         friend class BasicSolver;
+        friend class MatrixFreeSolver;
+        friend class ExplicitDynamicsProcedure;
+        friend class SolutionProcedure;
+
+        /**
+         * @brief switches symmetric storage of the stiffness matrix on or off. 
+         * @details the tangent stiffness of all the available elements is symmetric, so only the upper triangle needs to be stored and factorised. In the distributed build the full matrix is still stored as the \ref matrix_graph is built from the full set of triplets, and only the choice of Amesos2 backend is affected.
+         * @param symmetric true to assemble only the upper triangle of \f$\boldsymbol{K}\f$.
+         */
+        void set_symmetric_storage(bool symmetric) {symmetric_storage = symmetric;}
+        bool get_symmetric_storage() const {return symmetric_storage;}
+
+        /**
+         * @brief switches matrix-free mode on or off. In matrix-free mode only \f$\boldsymbol{R}\f$ is assembled by \ref assemble_global_K_R and the stiffness is applied by the \ref MatrixFreeSolver. Only available in the serial build.
+         * 
+         * @param use_matrix_free true to skip the assembly of \f$\boldsymbol{K}\f$.
+         */
+        void set_matrix_free(bool use_matrix_free) 
+        {
+            #ifdef WITH_MPI
+            if (use_matrix_free)
+            {
+                std::cout << "Assembler::set_matrix_free: matrix-free mode is not available in the distributed build." << std::endl;
+                exit(1);
+            }
+            #endif
+            matrix_free = use_matrix_free;
+        }
+        bool get_matrix_free() const {return matrix_free;}
         /**
          * @brief initialises the K sparse matrix to the size that correspond to the mesh being used.
          * 
          * @param glob_mesh  the global_mesh object which contains information about the number of nodes and degrees of freedom.
          */
         void initialise_stiffness_matrix(GlobalMesh& glob_mesh) {
-            K_global_triplets.reserve(glob_mesh.nelems*36);
+            if (!matrix_free)
+                K_global_triplets.reserve(glob_mesh.nelems*36);
             #ifndef WITH_MPI
             K = make_spd_mat(glob_mesh.ndofs, glob_mesh.ndofs);
             #else
@@ -88,6 +134,7 @@ class Assembler {
             U = TpetraMultiVector(vector_map, 1);
             dU = TpetraMultiVector(vector_map, 1);
             setup_interface_import(glob_mesh, comm);
+            glob_mesh.build_layout();
         }
         #endif
 
@@ -106,6 +153,7 @@ class Assembler {
             P = make_spd_mat(glob_mesh.ndofs, 1);
             U = make_spd_vec(glob_mesh.ndofs);
             dU = make_spd_vec(glob_mesh.ndofs);            
+            glob_mesh.build_layout();
         }
         #endif
         #ifdef WITH_MPI
@@ -136,8 +184,15 @@ class Assembler {
             #ifdef WITH_MPI
             const local_ordinal_type entriesPerRow = glob_mesh.max_num_stiffness_contributions;
             matrix_graph = Teuchos::rcp(new TpetraCrsGraph(vector_map, entriesPerRow));
-            collect_global_K_triplets(glob_mesh);
-            initialise_from_triplets(matrix_graph, K_global_triplets);
+            if (snapshot_graph_rows.empty())
+            {
+                collect_global_K_triplets(glob_mesh);
+                initialise_from_triplets(matrix_graph, K_global_triplets);
+            } else {
+                // the rows read from a setup snapshot save evaluating the stiffness of every element just to find where it goes.
+                initialise_from_row_columns(matrix_graph, snapshot_graph_rows);
+                snapshot_graph_rows.clear();
+            }
             matrix_graph->fillComplete();
             #endif
         }
@@ -194,43 +249,77 @@ class Assembler {
         #endif
 
         /**
-         * @brief retrieves global load contributions from all nodes.
+         * @brief retrieves global load contributions from all nodes and writes them into the global load vector \f$ \boldsymbol{P}\f$.
          * 
-         * @details creates triplets by retrieving all global contributions from
-         * the nodes and then uses the triplets to create the global load vector \f$ \boldsymbol{P}\f$
-         * Note that as per the documentation of Eigen: "The initial contents of *this is destroyed." 
-         * when calling [setFromTriplets](https://eigen.tuxfamily.org/dox-devel/classEigen_1_1SparseMatrix.html#a8f09e3597f37aa8861599260af6a53e0).
-         * So this means that this function does not add to the existing force vector but recreates it from the contributions of the nodes.
+         * @details the nodes write their contributions from \ref Node::compute_global_load_triplets directly into the values of \f$ \boldsymbol{P}\f$ in parallel; each node owns distinct rows, so no two threads write the same entry.
+         * With MPI, \f$ \boldsymbol{P}\f$ is zeroed and then filled through its local view. Without MPI, \f$ \boldsymbol{P}\f$ is sparse and its pattern - the loaded active DoFs - does not change between load steps, so
+         * only the values are overwritten. If the pattern no longer matches, e.g. on the first assembly or after loads were added or removed, \f$ \boldsymbol{P}\f$ is rebuilt from \ref P_global_triplets. 
          * 
          * @param glob_mesh takes the global_mesh object as input to get the counters and containers for nodes and elements.
          */
         void assemble_global_P(GlobalMesh& glob_mesh)
         {
-            P_global_triplets.clear();
-
-            for (auto& node: glob_mesh.node_vector)
+            const MeshLayout& layout = glob_mesh.get_layout();
+            int num_rank_nodes = glob_mesh.node_vector.size(); // the rank-owned nodes come first in the layout.
+            #ifdef WITH_MPI
             {
-                node->insert_load_triplets(this->P_global_triplets);
+                P.putScalar(0.0);
+                auto P_2d = P.getLocalViewHost(Tpetra::Access::ReadWrite);
+                auto P_local_view = Kokkos::subview (P_2d, Kokkos::ALL (), 0);
+                int rank_starting_nz_i = glob_mesh.rank_starting_nz_i;
+                #pragma omp parallel for
+                for (int i = 0; i < num_rank_nodes; ++i)
+                {
+                    for (const spnz& triplet: layout.nodes[i]->get_load_triplets())
+                    {
+                        P_local_view(triplet.row() - rank_starting_nz_i) = triplet.value();
+                    }
+                }
             }
             if (VERBOSE)
             {
-                std::cout << "Assembler: all triplets are: " << std::endl;
-                for (auto& triplet: P_global_triplets)
+                print_distributed_maths_object("P");
+            }
+            #else
+            int num_load_entries = 0;
+            #pragma omp parallel for reduction(+:num_load_entries)
+            for (int i = 0; i < num_rank_nodes; ++i)
+            {
+                num_load_entries += layout.nodes[i]->get_load_triplets().size();
+            }
+            bool pattern_matches = P.isCompressed() && P.nonZeros() == num_load_entries;
+            if (pattern_matches)
+            {
+                const int* rows_begin = P.innerIndexPtr();
+                const int* rows_end = rows_begin + P.nonZeros();
+                real* values = P.valuePtr();
+                #pragma omp parallel for reduction(&&:pattern_matches)
+                for (int i = 0; i < num_rank_nodes; ++i)
                 {
-                    std::cout << "row, col, val: " << triplet.row() << "," << triplet.col() << "," << triplet.value() << std::endl;
+                    for (const spnz& triplet: layout.nodes[i]->get_load_triplets())
+                    {
+                        const int* row = std::lower_bound(rows_begin, rows_end, triplet.row());
+                        if (row == rows_end || *row != triplet.row())
+                            pattern_matches = false;
+                        else
+                            values[row - rows_begin] = triplet.value();
+                    }
                 }
-                std::cout << "There are " << std::size(P_global_triplets) << " P_global contributions to add up." << std::endl;
             }
-            #ifdef WITH_MPI
-            // std::cout << "Setting P" << std::endl;
-            set_from_triplets(P, P_global_triplets, glob_mesh.rank_starting_nz_i);
+            if (!pattern_matches)
+            {
+                P_global_triplets.clear();
+                for (int i = 0; i < num_rank_nodes; ++i)
+                {
+                    layout.nodes[i]->insert_load_triplets(P_global_triplets);
+                }
+                P.setFromTriplets(P_global_triplets.begin(), P_global_triplets.end());
+                P.makeCompressed();
+            }
             if (VERBOSE)
             {
-                print_distributed_maths_object("P");
+                std::cout << "There are " << num_load_entries << " P_global contributions." << std::endl;
             }
-            #else
-            P.setFromTriplets(P_global_triplets.begin(), P_global_triplets.end());
-            P.makeCompressed();
             if (VERBOSE_NLB)
             {
                 std::cout << "The P vector is:" << std::endl << Eigen::MatrixXd(P) << std::endl;
@@ -269,7 +358,8 @@ class Assembler {
             R_global_triplets.clear();
             for (auto& elem: glob_mesh.elem_vector)
             {   
-                elem->insert_global_stiffness_triplets(K_global_triplets);
+                if (!matrix_free)
+                    elem->insert_global_stiffness_triplets(K_global_triplets, upper_triangle_only());
                 elem->insert_global_resistance_force_triplets(R_global_triplets);
             }
 
@@ -291,6 +381,12 @@ class Assembler {
                 std::cout << std::endl;
             }
             #else
+            if (matrix_free)
+            {
+                R.setFromTriplets(R_global_triplets.begin(), R_global_triplets.end());
+                R.makeCompressed();
+                return;
+            }
             K.setFromTriplets(K_global_triplets.begin(), K_global_triplets.end());
             K.makeCompressed();
             R.setFromTriplets(R_global_triplets.begin(), R_global_triplets.end());
@@ -304,12 +400,57 @@ class Assembler {
             if (VERBOSE_NLB)
             {
                 std::cout << "The R vector is:" << std::endl << Eigen::MatrixXd(R) << std::endl;
-                std::cout << "KU, however, is:" << std::endl << Eigen::MatrixXd(K*U) << std::endl;
+                if (symmetric_storage)
+                    std::cout << "KU, however, is:" << std::endl << Eigen::MatrixXd(K.selfadjointView<Eigen::Upper>()*U) << std::endl;
+                else
+                    std::cout << "KU, however, is:" << std::endl << Eigen::MatrixXd(K*U) << std::endl;
                 std::cout << "and P is:" << std::endl << Eigen::MatrixXd(P) << std::endl;
             }
             #endif
         }
 
+        /**
+         * @brief assembles only the resistance vector \f$\boldsymbol{R}\f$ from the element contributions, leaving \f$\boldsymbol{K}\f$ untouched. Used by quasi-Newton iterations that reuse an earlier factorisation of \f$\boldsymbol{K}\f$.
+         *
+         * @param glob_mesh takes the global_mesh object as input to get the containers for elements.
+         */
+        void assemble_global_R(GlobalMesh& glob_mesh)
+        {
+            R_global_triplets.clear();
+            for (auto& elem: glob_mesh.elem_vector)
+            {
+                elem->insert_global_resistance_force_triplets(R_global_triplets);
+            }
+            #ifdef WITH_MPI
+            set_from_triplets(R, R_global_triplets, glob_mesh.rank_starting_nz_i);
+            #else
+            R.setFromTriplets(R_global_triplets.begin(), R_global_triplets.end());
+            R.makeCompressed();
+            #endif
+        }
+
+        /**
+         * @brief assembles only the stiffness matrix \f$\boldsymbol{K}\f$ from the element contributions; see \ref assemble_global_K_R. Does nothing in matrix-free mode.
+         *
+         * @param glob_mesh takes the global_mesh object as input to get the containers for elements.
+         */
+        void assemble_global_K(GlobalMesh& glob_mesh)
+        {
+            if (matrix_free)
+                return;
+            K_global_triplets.clear();
+            for (auto& elem: glob_mesh.elem_vector)
+            {
+                elem->insert_global_stiffness_triplets(K_global_triplets, upper_triangle_only());
+            }
+            #ifdef WITH_MPI
+            set_from_triplets(K, K_global_triplets);
+            #else
+            K.setFromTriplets(K_global_triplets.begin(), K_global_triplets.end());
+            K.makeCompressed();
+            #endif
+        }
+
         #ifdef WITH_MPI
         /**
          * @brief initialises \ref interface_map and \ref interface_U, and sets up \ref interface_importer for future communication.
@@ -345,8 +486,23 @@ class Assembler {
             interface_map = Teuchos::rcp(new TpetraMap(INVALID, interface_dofs_array, 0, comm));
             
             interface_U = TpetraMultiVector(interface_map, 1);
-            interface_importer = Teuchos::rcp(new Tpetra::Import<local_ordinal_type, global_ordinal_type, node_type>(vector_map, interface_map));
+            if (snapshot_import)
+            {
+                // every interface DoF is owned by the parent rank of its node, which the setup snapshot recorded, so the importer need not ask the other ranks who owns what.
+                Teuchos::Array<int> remote_ranks;
+                remote_ranks.reserve(interface_dofs.size());
+                for (auto& node: glob_mesh.interface_node_vector)
+                {
+                    for (int i = 0; i < node->get_ndof(); ++i)
+                        remote_ranks.push_back(node->get_parent_rank());
+                }
+                interface_importer = Teuchos::rcp(new Tpetra::Import<local_ordinal_type, global_ordinal_type, node_type>(vector_map, interface_map, remote_ranks));
+                snapshot_import = false;
+            } else {
+                interface_importer = Teuchos::rcp(new Tpetra::Import<local_ordinal_type, global_ordinal_type, node_type>(vector_map, interface_map));
+            }
             // since it is initialisation, the Tpetra::CombineMode is INSERT.
+            CommunicationTimer communication("interface_import");
             interface_U.doImport(U, *interface_importer, Tpetra::INSERT);
             #endif
         }
@@ -361,36 +517,41 @@ class Assembler {
         {
             
             #ifdef WITH_MPI
+            // the rank-owned nodes come first in the layout, and their DoFs are numbered in the same order as the local rows of U; the interface nodes follow in the order of the rows of interface_U.
+            const MeshLayout& layout = glob_mesh.get_layout();
+            int num_rank_nodes = glob_mesh.node_vector.size();
+            int num_rank_dofs = layout.dof_offsets[num_rank_nodes];
             // scope to destroy the view.
             {
                 auto U_2d = U.getLocalViewHost(Tpetra::Access::ReadOnly);
                 auto U_local_view = Kokkos::subview (U_2d, Kokkos::ALL (), 0);
-                int nzi = 0;
-                for (auto& node: glob_mesh.node_vector)
+                #pragma omp parallel for
+                for (int i = 0; i < num_rank_nodes; ++i)
                 {
-                    std::set<int> node_active_dofs = node->get_active_dofs();
-                    for (auto& dof: node_active_dofs) {
-                        node->set_nodal_displacement(dof, U_local_view(nzi));
-                        ++nzi;
+                    for (int j = layout.dof_offsets[i]; j < layout.dof_offsets[i + 1]; ++j)
+                    {
+                        layout.nodes[i]->set_nodal_displacement(layout.dofs[j], U_local_view(j));
                     }
-                    
                 }
             }
 
             {
-                interface_U.doImport(U, *interface_importer, Tpetra::REPLACE);
+                {
+                    CommunicationTimer communication("interface_import");
+                    interface_U.doImport(U, *interface_importer, Tpetra::REPLACE);
+                }
 
                 auto interface_U_2d = interface_U.getLocalViewHost(Tpetra::Access::ReadOnly);
                 auto interface_U_local_view = Kokkos::subview (interface_U_2d, Kokkos::ALL (), 0);
-                int nzi = 0;
-                for (auto& node: glob_mesh.interface_node_vector)
+                int num_nodes = layout.num_nodes();
+                #pragma omp parallel for
+                for (int i = num_rank_nodes; i < num_nodes; ++i)
                 {
-                    std::set<int> node_active_dofs = node->get_active_dofs();
-                    for (auto& dof: node_active_dofs) {
-                        node->set_nodal_displacement(dof, interface_U_local_view(nzi));
-                        ++nzi;
+                    for (int j = layout.dof_offsets[i]; j < layout.dof_offsets[i + 1]; ++j)
+                    {
+                        layout.nodes[i]->set_nodal_displacement(layout.dofs[j], interface_U_local_view(j - num_rank_dofs));
                     }
-                }   
+                }
             }
 
             if (VERBOSE_NLB)
@@ -398,49 +559,34 @@ class Assembler {
                 glob_mesh.read_nodal_U();
             }
             #else
-            #ifdef KOKKOS
-                std::vector<std::shared_ptr<Node>>* nodes = &glob_mesh.node_vector;
-                Kokkos::parallel_for( "Assembler::map_U_to_nodes", glob_mesh.node_vector.size(), KOKKOS_LAMBDA (int i) {
-                    int nzi = (*nodes)[i]->get_nz_i(); // where the node displacements start in the U vector.
-                    int num_node_dofs = (*nodes)[i]->get_ndof(); // how many there are to loop over.
-                    std::set<int> node_active_dofs = (*nodes)[i]->get_active_dofs();
-                    int j = 0;
-                    for (auto& dof: node_active_dofs) {
-                        (*nodes)[i]->set_nodal_displacement(dof, U.coeff(j + nzi,0));
-                        ++j;
-                    }
-                });
-            #else
-                for (auto& node: glob_mesh.node_vector)
-                {
-                    int nzi = node->get_nz_i(); // where the node displacements start in the U vector.
-                    int num_node_dofs = node->get_ndof(); // how many there are to loop over.
-                    std::set<int> node_active_dofs = node->get_active_dofs();
-                    int i = 0;
-                    
-                    for (auto& dof: node_active_dofs) {
-                        node->set_nodal_displacement(dof, U.coeff(i + nzi,0));
-                        ++i;
-                    }
-                }
-            #endif
-                // There are only a few interface nodes and these are not worth the overhead of parallelising.
-                for (auto& node: glob_mesh.interface_node_vector)
+                // the rank-owned and interface nodes are both in the layout, and each node only writes its own displacements.
+                const MeshLayout& layout = glob_mesh.get_layout();
+                const vec U_values = U.toDense(); // avoids a search of the sparse vector per DoF.
+                #pragma omp parallel for
+                for (size_t i = 0; i < layout.num_nodes(); ++i)
                 {
-                    int nzi = node->get_nz_i(); // where the node displacements start in the U vector.
-                    int num_node_dofs = node->get_ndof(); // how many there are to loop over.
-                    std::set<int> node_active_dofs = node->get_active_dofs();
-                    int i = 0;
-                    
-                    for (auto& dof: node_active_dofs) {
-                        node->set_nodal_displacement(dof, U.coeff(i + nzi,0));
-                        ++i;
+                    for (int j = layout.dof_offsets[i]; j < layout.dof_offsets[i + 1]; ++j)
+                    {
+                        layout.nodes[i]->set_nodal_displacement(layout.dofs[j], U_values(layout.U_indices[j]));
                     }
                 }
             #endif
         }
 
 
+        /**
+         * @brief sets the out-of-balance force \f$\boldsymbol{G}\f$ to \f$-\Delta\boldsymbol{P}\f$, the load added by the last load increment, so that solving with the tangent of the last converged state predicts the displacements of the new load level.
+         * @param load_increment_fraction \f$\Delta\lambda/\lambda\f$, the fraction of \f$\boldsymbol{P}\f$ added by the last increment, as the loads grow in proportion to the load factor \f$\lambda\f$.
+         */
+        void set_out_of_balance_to_load_increment(real load_increment_fraction)
+        {
+            #ifdef WITH_MPI
+            G.update(-load_increment_fraction, P, 0.0);
+            #else
+            G = -load_increment_fraction*P;
+            #endif
+        }
+
         /**
          * @brief calculates out of balance forces from \f$\boldsymbol{G} =  \boldsymbol{R} - \boldsymbol{P}\f$.
          * 
@@ -490,6 +636,89 @@ class Assembler {
             #endif
         }
 
+        /**
+         * @brief writes the column indices of each row of the stiffness matrix owned by this rank, so that a model read back from a setup snapshot can build \ref matrix_graph without evaluating its elements.
+         * @details the serial build assembles \f$\boldsymbol{K}\f$ straight from the element triplets and has no graph, so it only writes that it has none.
+         */
+        void write_setup_snapshot(std::ostream& out, [[maybe_unused]] GlobalMesh& glob_mesh)
+        {
+            #ifdef WITH_MPI
+            write_binary(out, true);
+            collect_global_K_triplets(glob_mesh);
+            auto row_col_map = map_triplets_to_row_column_positions(K_global_triplets);
+            K_global_triplets.clear();
+            write_binary(out, row_col_map.size());
+            for (auto& [row, columns] : row_col_map)
+            {
+                std::sort(columns.begin(), columns.end());
+                columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+                write_binary(out, row);
+                write_binary_span<global_ordinal_type>(out, columns);
+            }
+            #else
+            write_binary(out, false);
+            #endif
+        }
+
+        /**
+         * @brief reads what \ref write_setup_snapshot wrote, to be used by the following \ref initialise_global_vectors and \ref initialise_stiffness_matrix. Exits if it was written by the other build.
+         */
+        void read_setup_snapshot(std::istream& in)
+        {
+            bool has_graph;
+            read_binary(in, has_graph);
+            #ifdef WITH_MPI
+            if (!has_graph)
+            {
+                std::cout << "Assembler::read_setup_snapshot: the snapshot was written by the serial build and has no stiffness graph." << std::endl;
+                exit(1);
+            }
+            size_t num_rows;
+            read_binary(in, num_rows);
+            snapshot_graph_rows.clear();
+            for (size_t i = 0; i < num_rows; ++i)
+            {
+                global_ordinal_type row;
+                read_binary(in, row);
+                read_binary_vector(in, snapshot_graph_rows[row]);
+            }
+            snapshot_import = true;
+            #else
+            if (has_graph)
+            {
+                std::cout << "Assembler::read_setup_snapshot: the snapshot was written by the distributed build." << std::endl;
+                exit(1);
+            }
+            #endif
+        }
+
+        /**
+         * @brief writes the rank-owned part of \f$\boldsymbol{U}\f$.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary_vector(out, U);
+        }
+
+        /**
+         * @brief restores the rank-owned part of \f$\boldsymbol{U}\f$ written by \ref write_checkpoint. Must be called after \f$\boldsymbol{U}\f$ is initialised for the same mesh.
+         */
+        void read_checkpoint(std::istream& in)
+        {
+            #ifdef WITH_MPI
+            read_binary_vector(in, U);
+            #else
+            spvec U_checkpoint;
+            read_binary_vector(in, U_checkpoint);
+            if (U_checkpoint.size() != U.size())
+            {
+                std::cout << "Assembler::read_checkpoint: checkpoint has " << U_checkpoint.size() << " DoFs but U has " << U.size() << "." << std::endl;
+                exit(1);
+            }
+            U = U_checkpoint;
+            #endif
+        }
+
         /**
          * @brief checks if the maximum square-root of the norm of out-of-balance is smaller than a tolerance.
          * 
@@ -501,8 +730,11 @@ class Assembler {
         {
             #ifdef WITH_MPI
             // had some trouble with the types for the norms, so I used copilot for help with typing here.
-            Teuchos::Array<typename Tpetra::MultiVector<>::mag_type> norms(1);
-            G.norm2(norms);
+            Teuchos::Array<TpetraMultiVector::mag_type> norms(1);
+            {
+                CommunicationTimer communication("convergence_norm");
+                G.norm2(norms);
+            }
             G_max = norms[0];
             #else
             G_max = std::sqrt(calc_l2_norm(G));
@@ -532,6 +764,8 @@ class Assembler {
         {
             return G.getLocalLength();
         }
+        #else
+        const spmat& get_P() const {return P;}
         #endif
 
 };
@@ -16,6 +16,7 @@
 #include <tuple>
 #include <string>
 #include <map>
+#include <unordered_map>
 #include <set>
 #include <algorithm>
 #include <Eigen/SparseLU>
@@ -23,6 +24,7 @@
 #ifdef WITH_MPI
     #include <mpi.h>
     #include <tpetra_wrappers.hpp>
+    #include "CommunicationTimer.hpp"
 #endif
 #ifdef KOKKOS
     #include <Kokkos_Core.hpp>
@@ -42,6 +44,9 @@
 #include "basic_utilities.hpp"
 #include "BeamColumnFiberSection.hpp"
 #include "FrameMesh.hpp"
+#include "MeshLayout.hpp"
+#include "BinaryMesh.hpp"
+#include "FieldSnapshot.hpp"
 
 /**
  * @brief std vector of pairs each of which has an id and a 3-item coords vector.
@@ -72,6 +77,13 @@ class GlobalMesh {
         int rank_interface_nnodes = 0; /**< number of interface nodes on current rank.*/
         int rank_ndofs = 0; /**< number of DOFs on current rank.*/
         int rank_nelems = 0; /**< number of elements on current rank.*/
+        real element_skip_tolerance = 0.0; /**< see \ref set_element_skip_tolerance.*/
+        int num_skipped_elements = 0; /**< number of elements skipped by the last \ref update_elements_states.*/
+        std::vector<std::uint64_t> element_costs; /**< cycles taken by each element in \ref elem_vector at its last update; see \ref read_cycle_counter.*/
+        std::vector<size_t> element_chunk_starts; /**< start of each cost-balanced chunk of \ref elem_vector, followed by its size; see \ref balance_element_chunks.*/
+        int chunks_per_thread = 4; /**< number of element chunks made per thread, so that threads can even out changes in cost since the chunks were balanced.*/
+        std::vector<double> thread_busy_times; /**< time each thread spent updating elements in the last \ref update_elements_states.*/
+        std::vector<double> thread_idle_times; /**< time each thread waited for the others in the last \ref update_elements_states.*/
         unsigned rank_starting_node_id = 1; /**< number at which the id of the first node on this rank starts.*/
         int rank_starting_nz_i = 0; /**< number at which the DoF count starts on this rank. */
         int max_num_stiffness_contributions = 0; /**< finds the maximum number of contributions made to a row of the stiffness matrix */
@@ -81,6 +93,8 @@ class GlobalMesh {
         std::vector<std::shared_ptr<Node>> node_vector;  /**< a vector of shared ptrs referring to all the nodes on the current rank.*/
         std::vector<std::shared_ptr<Node>> interface_node_vector;  /**< a vector of shared ptrs referring to the interface nodes in the problem.*/
         std::vector<std::shared_ptr<ElementBaseClass>> elem_vector; /**< a vector of shared ptrs referring to all the elements in the problem.*/
+        MeshLayout layout; /**< flat copy of the node DoF numbering and of the node and element pointers used by the parallel kernels; see \ref build_layout.*/
+        bool layout_valid = false; /**< false once the nodes, elements, or DoF numbering changed since \ref layout was built; see \ref invalidate_layout.*/
 
         std::set<unsigned> interface_node_id_set_on_rank; //**<a std::set of node ids for those that are interfaces on this rank. */
         std::set<unsigned> node_id_set_owned_by_rank; //**<a std::set of node ids for those that are owned by this rank. */
@@ -118,7 +132,7 @@ class GlobalMesh {
         {
             std::vector<double> coord_vec;
             std::vector<double> parametricCoords;
-            std::vector<std::unsigned> nodeTags;
+            std::vector<std::size_t> nodeTags;
 
             gmsh::model::mesh::getNodes(nodeTags, coord_vec, parametricCoords);
             
@@ -177,32 +191,29 @@ class GlobalMesh {
                 // getting the elements and nodes for each element type
                 // this is because each type has the same number of nodes
                 std::cout << "Mapping element type: " << type_name << std::endl;
-                std::vector<std::unsigned> elem_tags, node_tags;
+                std::vector<std::size_t> elem_tags, node_tags;
                 gmsh::model::mesh::getElementsByType(elem_type, elem_tags, node_tags);
 
-                std::vector<std::unsigned> element_nodes;
+                std::vector<unsigned> element_nodes;
                 element_nodes.reserve(num_nodes_per_elem);
-                auto node_itr = node_tags.begin() ;
+                auto node_itr = node_tags.begin();
                 for (auto& elem_tag: elem_tags)
                 {
-                    element_nodes.clear();
-                    for (int i = 0; i < num_nodes_per_elem; ++i)
-                    {
-                        element_nodes.push_back(*(node_itr + i));
-                        node_itr += i;
-                    }
-                    ++node_itr;
+                    element_nodes.assign(node_itr, node_itr + num_nodes_per_elem);
+                    node_itr += num_nodes_per_elem;
                     elem_nodes_vector.push_back(std::make_pair(elem_tag, element_nodes));
+                    #if VERBOSE
                     std::cout << "added element: " << elem_tag << " with nodes: ";
-                    print_container<std::vector<std::unsigned>>(element_nodes);
+                    print_container(element_nodes);
+                    #endif
                 }
             }
             return elem_nodes_vector;
+        }
 
-            void GlobalMesh::close_mesh_file()
-            {
+        void close_mesh_file()
+        {
             gmsh::finalize();
-            }
         }
         #endif
 
@@ -380,6 +391,125 @@ class GlobalMesh {
            setup_distributed_mesh(mesh_maps.first, mesh_maps.second);
        }
 
+        /**
+         * @brief creates the mesh stored in a binary mesh file written by \ref write_binary_mesh.
+         * @param elem_type an enum referring to the type of element that the mesh will include.
+         * @param sect a \ref BasicSection object that is used to initialise the beam-column elements.
+        **/
+        void create_mesh_from_binary_file(std::string file_name, ElementType elem_type, BasicSection& sect)
+        {
+            element_type = elem_type;
+            basic_section = std::make_unique<BasicSection>(sect);
+            read_binary_mesh(file_name);
+        }
+        void create_mesh_from_binary_file(std::string file_name, ElementType elem_type, BeamColumnFiberSection& sect)
+        {
+            element_type = elem_type;
+            fiber_section = std::make_unique<BeamColumnFiberSection>(sect);
+            read_binary_mesh(file_name);
+        }
+
+        /**
+         * @brief creates the part of the mesh in a binary mesh file that belongs to the current rank; each rank reads only its own part of the file.
+         * @param elem_type an enum referring to the type of element that the mesh will include.
+         * @param sect a \ref BasicSection object that is used to initialise the beam-column elements.
+        **/
+        void create_distributed_mesh_from_binary_file(std::string file_name, ElementType elem_type, BasicSection& sect)
+        {
+            initialise_mpi_variables();
+            element_type = elem_type;
+            basic_section = std::make_unique<BasicSection>(sect);
+            read_distributed_binary_mesh(file_name);
+        }
+        void create_distributed_mesh_from_binary_file(std::string file_name, ElementType elem_type, BeamColumnFiberSection& sect)
+        {
+            initialise_mpi_variables();
+            element_type = elem_type;
+            fiber_section = std::make_unique<BeamColumnFiberSection>(sect);
+            read_distributed_binary_mesh(file_name);
+        }
+
+        /**
+         * @brief recreates the mesh of the current rank from a setup snapshot written by \ref write_setup_snapshot, with new elements of \p elem_type made from \p sect.
+         * @param in stream positioned at the start of the mesh part of the snapshot.
+         * @param elem_type an enum referring to the type of element that the mesh will include.
+         * @param sect a \ref BasicSection object that is used to initialise the beam-column elements.
+        **/
+        void create_mesh_from_setup_snapshot(std::istream& in, ElementType elem_type, BasicSection& sect)
+        {
+            initialise_mpi_variables();
+            element_type = elem_type;
+            basic_section = std::make_unique<BasicSection>(sect);
+            read_setup_snapshot(in);
+        }
+        void create_mesh_from_setup_snapshot(std::istream& in, ElementType elem_type, BeamColumnFiberSection& sect)
+        {
+            initialise_mpi_variables();
+            element_type = elem_type;
+            fiber_section = std::make_unique<BeamColumnFiberSection>(sect);
+            read_setup_snapshot(in);
+        }
+
+        /**
+         * @brief converts mesh data read from a binary mesh file to the node and element vectors used to set up the mesh.
+         * @attention the mesh holds a single section and material, so every element must use section 0.
+         */
+        std::pair<NodeIdCoordsPairsVector, ElemIdNodeIdPairVector> map_binary_mesh_data(const BinaryMeshData& mesh)
+        {
+            NodeIdCoordsPairsVector nodes_coords_vector;
+            nodes_coords_vector.reserve(mesh.num_nodes());
+            for (size_t i = 0; i < mesh.num_nodes(); ++i)
+            {
+                nodes_coords_vector.push_back(std::make_pair(mesh.node_ids[i], coords(mesh.node_coords[3*i], mesh.node_coords[3*i + 1], mesh.node_coords[3*i + 2])));
+            }
+            ElemIdNodeIdPairVector elem_nodes_vector;
+            elem_nodes_vector.reserve(mesh.num_elements());
+            for (size_t e = 0; e < mesh.num_elements(); ++e)
+            {
+                if (mesh.elem_section_ids[e] != 0)
+                {
+                    std::cout << "ERROR: GlobalMesh::map_binary_mesh_data: element " << mesh.elem_ids[e] << " uses section " << mesh.elem_section_ids[e] << " but only section 0 is supported." << std::endl;
+                    exit(1);
+                }
+                elem_nodes_vector.push_back(std::make_pair(mesh.elem_ids[e], std::vector<unsigned>(mesh.elem_node_ids.begin() + mesh.elem_node_offsets[e], mesh.elem_node_ids.begin() + mesh.elem_node_offsets[e + 1])));
+            }
+            return std::make_pair(nodes_coords_vector, elem_nodes_vector);
+        }
+
+        /**
+         * @brief reads the whole of a binary mesh file and sets up the mesh from it.
+         */
+        void read_binary_mesh(std::string file_name)
+        {
+            BinaryMeshReader reader(file_name);
+            std::pair<NodeIdCoordsPairsVector, ElemIdNodeIdPairVector> mesh_maps = map_binary_mesh_data(reader.read_all());
+            setup_mesh(mesh_maps.first, mesh_maps.second);
+        }
+
+        /**
+         * @brief reads the part of a binary mesh file that the current rank builds and sets up the distributed mesh from it, skipping the partitioning of the whole mesh that \ref setup_distributed_mesh does. The nodes are split between ranks exactly as in \ref populate_node_rank_maps.
+         */
+        void read_distributed_binary_mesh(std::string file_name)
+        {
+            BinaryMeshReader reader(file_name);
+            BinaryMeshPartition partition = reader.read_partition(rank, num_ranks);
+            nnodes = reader.get_num_nodes();
+            nelems = reader.get_num_elements();
+            std::pair<NodeIdCoordsPairsVector, ElemIdNodeIdPairVector> mesh_maps = map_binary_mesh_data(partition.mesh);
+
+            std::map<unsigned, int> node_rank_map;
+            node_id_set_owned_by_rank.clear();
+            for (size_t i = 0; i < mesh_maps.first.size(); ++i)
+            {
+                node_rank_map[mesh_maps.first[i].first] = partition.node_ranks[i];
+                if (i < partition.num_owned_nodes)
+                    node_id_set_owned_by_rank.insert(mesh_maps.first[i].first);
+            }
+            NodeIdCoordsPairsVector nodes_coords_vector_on_rank(mesh_maps.first.begin(), mesh_maps.first.begin() + partition.num_owned_nodes);
+            NodeIdCoordsPairsVector interface_nodes_coords_vector_on_rank(mesh_maps.first.begin() + partition.num_owned_nodes, mesh_maps.first.end());
+            build_distributed_mesh(nodes_coords_vector_on_rank, interface_nodes_coords_vector_on_rank, mesh_maps.second, node_rank_map);
+        }
+
         /**
          * @brief creates element objects following the \ref ElemIdNodeIdPairVector object format and adds them to \ref elem_vector.
          * 
@@ -413,6 +543,13 @@ class GlobalMesh {
             #if VERBOSE
                 std::cout << "Rank "<< rank << " -------------GlobalMesh::make_elements-------------" << std::endl;
             #endif
+            // look nodes up by hash in stead of get_node_by_record_id, whose linear search makes building a mesh quadratic in its size.
+            std::unordered_map<unsigned, std::shared_ptr<Node>> record_id_node_map;
+            record_id_node_map.reserve(node_vector.size() + interface_node_vector.size());
+            for (auto& node : interface_node_vector)
+                record_id_node_map[node->get_record_id()] = node;
+            for (auto& node : node_vector)
+                record_id_node_map[node->get_record_id()] = node;
             std::vector<std::shared_ptr<Node>> elem_nodes;
             elem_nodes.reserve(2);
             for (auto& element_data : elem_nodes_vector)
@@ -423,8 +560,13 @@ class GlobalMesh {
                     #if VERBOSE
                         std::cout << "Rank "<< rank << " - GlobalMesh::make_elements: searching for node id = " << node_id << " to make element " << element_data.first << std::endl;
                     #endif
-                    std::shared_ptr<Node> node = get_node_by_record_id(node_id, "all");
-                    elem_nodes.push_back(node);
+                    auto node_it = record_id_node_map.find(node_id);
+                    if (node_it == record_id_node_map.end())
+                    {
+                        std::cout << "ERROR: GlobalMesh::make_elements: rank " << rank << " could not find node " << node_id << " of element " << element_data.first << "." << std::endl;
+                        exit(1);
+                    }
+                    elem_nodes.push_back(node_it->second);
                 }
 
                 switch (element_type)
@@ -444,7 +586,6 @@ class GlobalMesh {
                 }
             }       
         }
-        void close_mesh_file();
 
 
         
@@ -456,6 +597,7 @@ class GlobalMesh {
          */
         void setup_mesh(NodeIdCoordsPairsVector nodes_coords_vector, ElemIdNodeIdPairVector elem_nodes_vector)
         {
+            invalidate_layout();
             nnodes = nodes_coords_vector.size();
             nelems = elem_nodes_vector.size();
             node_vector.clear();
@@ -767,8 +909,6 @@ class GlobalMesh {
         {
             nnodes = nodes_coords_vector.size();
             nelems = elem_nodes_vector.size();
-            ranks_ndofs.resize(num_ranks);
-            ranks_nnodes.resize(num_ranks);
 
             // sort nodes into the ranks that own them
             std::map<unsigned, int> node_rank_map; 
@@ -782,13 +922,46 @@ class GlobalMesh {
             // Based on the nodes we currently have, find all elements that connect to any of these nodes.
             std::set<unsigned> elem_id_set_on_rank; 
             find_rank_elements(elem_id_set_on_rank, node_id_set_owned_by_rank, node_element_map);
-            rank_nelems = elem_id_set_on_rank.size();
             // filter the elem_nodes_vector to only the members that belong on this rank (including those that are duplicated)
             ElemIdNodeIdPairVector elem_nodes_vector_on_rank;
-            elem_nodes_vector_on_rank.reserve(rank_nelems);
+            elem_nodes_vector_on_rank.reserve(elem_id_set_on_rank.size());
             filter_element_vector(elem_nodes_vector_on_rank, elem_id_set_on_rank, elem_nodes_vector);
 
             // Based on the members that will be created on this rank, add the nodes that will also need to be created
+            std::set<unsigned> interface_node_ids;
+            std::set<unsigned> interface_elem_ids;
+            find_rank_interface_nodes_and_elems(interface_node_ids, interface_elem_ids, node_id_set_owned_by_rank, elem_nodes_vector_on_rank);
+            
+            // Add the nodes that officially belong to this rank to the rank nodes coords vector.
+            NodeIdCoordsPairsVector nodes_coords_vector_on_rank;
+            NodeIdCoordsPairsVector interface_nodes_coords_vector_on_rank;
+            nodes_coords_vector_on_rank.reserve(node_id_set_owned_by_rank.size());
+            interface_nodes_coords_vector_on_rank.reserve(interface_node_ids.size());
+            filter_node_vector(nodes_coords_vector_on_rank, nodes_coords_vector, node_id_set_owned_by_rank);
+            filter_node_vector(interface_nodes_coords_vector_on_rank, nodes_coords_vector, interface_node_ids);
+
+            build_distributed_mesh(nodes_coords_vector_on_rank, interface_nodes_coords_vector_on_rank, elem_nodes_vector_on_rank, node_rank_map);
+        }
+
+        /**
+         * @brief creates the nodes and elements of the current rank from its part of the mesh, then renumbers and exchanges them with the other ranks. Shared by \ref setup_distributed_mesh and \ref read_distributed_binary_mesh.
+         * @details \ref nnodes, \ref nelems, and \ref node_id_set_owned_by_rank must be set before calling.
+         * 
+         * @param nodes_coords_vector_on_rank IDs and coordinates of the nodes owned by this rank.
+         * @param interface_nodes_coords_vector_on_rank IDs and coordinates of the nodes of this rank's elements that other ranks own.
+         * @param elem_nodes_vector_on_rank the elements connected to any node owned by this rank.
+         * @param node_rank_map the owning rank of each node in both node vectors.
+         */
+        void build_distributed_mesh(NodeIdCoordsPairsVector& nodes_coords_vector_on_rank,
+                                    NodeIdCoordsPairsVector& interface_nodes_coords_vector_on_rank,
+                                    ElemIdNodeIdPairVector& elem_nodes_vector_on_rank,
+                                    std::map<unsigned, int>& node_rank_map)
+        {
+            invalidate_layout();
+            ranks_ndofs.resize(num_ranks);
+            ranks_nnodes.resize(num_ranks);
+            rank_nelems = elem_nodes_vector_on_rank.size();
+
             // interface and rank-owned node id set will be kept for BC and load operations handling.
             interface_node_id_set_on_rank.clear();
             std::set<unsigned> interface_elem_id_set_on_rank;
@@ -797,16 +970,7 @@ class GlobalMesh {
             rank_interface_nnodes = interface_node_id_set_on_rank.size();
 
             // Find the node IDs that each rank may want from our nodes.
-
             find_nodes_wanted_by_neighbours(wanted_by_neighbour_rank_node_id_map, wanted_from_neighbour_rank_node_id_map, interface_elem_id_set_on_rank, interface_node_id_set_on_rank, elem_nodes_vector_on_rank, node_rank_map);
-            
-            // Add the nodes that officially belong to this rank to the rank nodes coords vector.
-            NodeIdCoordsPairsVector nodes_coords_vector_on_rank;
-            NodeIdCoordsPairsVector interface_nodes_coords_vector_on_rank;
-            nodes_coords_vector_on_rank.reserve(rank_nnodes);
-            interface_nodes_coords_vector_on_rank.reserve(rank_interface_nnodes);
-            filter_node_vector(nodes_coords_vector_on_rank, nodes_coords_vector, node_id_set_owned_by_rank);
-            filter_node_vector(interface_nodes_coords_vector_on_rank, nodes_coords_vector, interface_node_id_set_on_rank);
 
             // populate and sort the node and element object vectors for the rank
             node_vector.clear();
@@ -1063,6 +1227,7 @@ class GlobalMesh {
                         "; send buffer size is " << rank_ids_send_buffers_map[neighbor_rank].size() <<
                         " and receive_buffer size is " << rank_id_receive_buffers_map[neighbor_rank].size() << "." << std::endl;
                 }
+                CommunicationTimer communication("interface_exchange");
                 MPI_Sendrecv(send_buffer, send_buffer_size, MPI_UNSIGNED, neighbor_rank, 0,
                             receive_buffer, receive_buffer_size, MPI_UNSIGNED, neighbor_rank, 0, 
                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
@@ -1136,6 +1301,7 @@ class GlobalMesh {
         void exchange_interface_nodes_nz_i(std::map<int, std::set<unsigned>> wanted_by_neighbour_rank_node_id_map, 
                                                   std::map<int, std::set<unsigned>> wanted_from_neighbour_rank_node_id_map)
         {
+            invalidate_layout();
             // get information about neighbours and buffer sizes
             int num_neighbours = 0;
             std::set<int> neighbours;
@@ -1195,6 +1361,7 @@ class GlobalMesh {
                         << neighbor_rank << "; send buffer size is " << rank_nz_i_send_buffers_map[neighbor_rank].size() <<
                         " and receive_buffer size is " << rank_nz_i_receive_buffers_map[neighbor_rank].size() << "." << std::endl;
                 }
+                CommunicationTimer communication("interface_exchange");
                 MPI_Sendrecv(send_buffer, send_buffer_size, MPI_INT, neighbor_rank, 0,
                             receive_buffer, receive_buffer_size, MPI_INT, neighbor_rank, 0, 
                             MPI_COMM_WORLD, MPI_STATUS_IGNORE);
@@ -1220,6 +1387,7 @@ class GlobalMesh {
          */
         void renumber_nodes()
         {
+            invalidate_layout();
             unsigned* ranks_nnodes_ptr = ranks_nnodes.data();
             #ifdef WITH_MPI
             if (VERBOSE)
@@ -1230,9 +1398,12 @@ class GlobalMesh {
             }
             // Find out what the rank_nnodes is for each rank
             // MPI_Barrier(MPI_COMM_WORLD);
-            MPI_Allgather(&rank_nnodes, 1, MPI_UNSIGNED,
-                        ranks_nnodes_ptr, 1, MPI_UNSIGNED, 
-                        MPI_COMM_WORLD);
+            {
+                CommunicationTimer communication("numbering_allgather");
+                MPI_Allgather(&rank_nnodes, 1, MPI_UNSIGNED,
+                            ranks_nnodes_ptr, 1, MPI_UNSIGNED, 
+                            MPI_COMM_WORLD);
+            }
             #endif
 
             // update the node id for each node
@@ -1271,6 +1442,7 @@ class GlobalMesh {
          */
         void count_distributed_dofs()
         {
+            invalidate_layout();
             int* ranks_ndofs_ptr = ranks_ndofs.data();
             rank_ndofs = 0;
             for (auto& node: node_vector)
@@ -1290,9 +1462,12 @@ class GlobalMesh {
                     << " send buffer size is " << 1 <<
                     " and receive_buffer size is: " << ranks_ndofs.size() << "." << std::endl;
             }
-            MPI_Allgather(&rank_ndofs, 1, MPI_INT,
-                        ranks_ndofs_ptr, 1, MPI_INT, 
-                        MPI_COMM_WORLD);
+            {
+                CommunicationTimer communication("numbering_allgather");
+                MPI_Allgather(&rank_ndofs, 1, MPI_INT,
+                            ranks_ndofs_ptr, 1, MPI_INT, 
+                            MPI_COMM_WORLD);
+            }
             #endif
 
             // update the nz_it for each node
@@ -1328,6 +1503,7 @@ class GlobalMesh {
          */
         void count_dofs()
         {
+            invalidate_layout();
             ndofs = 0;
             for (auto& node: node_vector)
             {
@@ -1366,6 +1542,7 @@ class GlobalMesh {
          */
         void fix_node(int const id, int const dof)
         {
+            invalidate_layout();
             auto node_ptr = get_node_by_record_id(id, "all");
             if (dof < 0)
             {
@@ -1446,6 +1623,23 @@ class GlobalMesh {
             }
         }
 
+        /**
+         * @brief get element shared_ptr by id.
+         * @param id id of the element to get from the \ref elem_vector.
+         * @return std::shared_ptr<ElementBaseClass> a shared pointer to the element with the given id.
+         */
+        std::shared_ptr<ElementBaseClass> get_elem_by_id(int id)
+        {
+            auto elem_it = get_id_iterator<std::vector<std::shared_ptr<ElementBaseClass>>::iterator, std::vector<std::shared_ptr<ElementBaseClass>>>(id, elem_vector);
+            if (elem_it != elem_vector.end())
+            {
+                return *elem_it;
+            } else {
+                std::cout << "Could not find element with id " << id << " in the element vector." << std::endl;
+                exit(1);
+            }
+        }
+
         /**
          * @brief get node shared_ptr by record_id.
          * @param record_id id of the node to get from the \ref node_vector or \ref interface_node_vector or both.
@@ -1517,13 +1711,14 @@ class GlobalMesh {
          */
         void calc_nodal_contributions_to_P()
         {
-            for (auto& node: node_vector)
+            #pragma omp parallel for
+            for (size_t i = 0; i < node_vector.size(); ++i)
             {
                 if (VERBOSE)
                 {
-                    std::cout << "Computing global load triplets for node " << node->get_id() << std::endl;
+                    std::cout << "Computing global load triplets for node " << node_vector[i]->get_id() << std::endl;
                 }
-                node->compute_global_load_triplets();
+                node_vector[i]->compute_global_load_triplets();
             }   
         }
 
@@ -1538,42 +1733,508 @@ class GlobalMesh {
                 node->check_loads();
             }
         }
+        /**
+         * @brief splits \ref elem_vector into contiguous chunks of roughly equal cost, as measured by the last \ref update_elements_states.
+         * @details the chunk boundaries are placed where the running sum of \ref element_costs crosses multiples of the total cost over the number of chunks. Before any costs are measured the chunks have equal numbers of elements.
+         * @param num_threads number of threads that will share the chunks; \ref chunks_per_thread chunks are made per thread.
+         */
+        void balance_element_chunks(int num_threads)
+        {
+            size_t num_elems = elem_vector.size();
+            size_t num_chunks = std::max<size_t>(1, std::min<size_t>(num_elems, num_threads*chunks_per_thread));
+            element_costs.resize(num_elems, 0);
+            std::uint64_t total_cost = 0;
+            for (std::uint64_t cost : element_costs)
+                total_cost += cost;
+            element_chunk_starts.assign(1, 0);
+            if (total_cost == 0)
+            {
+                for (size_t chunk = 1; chunk < num_chunks; ++chunk)
+                    element_chunk_starts.push_back(chunk*num_elems/num_chunks);
+            } else {
+                std::uint64_t running_cost = 0;
+                size_t chunk = 1;
+                for (size_t i = 0; i < num_elems && chunk < num_chunks; ++i)
+                {
+                    running_cost += element_costs[i];
+                    // (running_cost/total_cost >= chunk/num_chunks) without overflow or rounding.
+                    while (chunk < num_chunks && static_cast<long double>(running_cost)*num_chunks >= static_cast<long double>(total_cost)*chunk)
+                    {
+                        if (i + 1 > element_chunk_starts.back() && i + 1 < num_elems)
+                            element_chunk_starts.push_back(i + 1);
+                        ++chunk;
+                    }
+                }
+            }
+            element_chunk_starts.push_back(num_elems);
+        }
+
         /**
          * @brief updates the state of each element after calculating global displacements.
+         * @details elements whose displacements did not move by more than \ref element_skip_tolerance since they were last evaluated keep their cached contributions; see \ref ElementBaseClass::update_state_if_changed. The number of such elements is kept in \ref num_skipped_elements.
          * 
+         * Elements in yielding regions run the fibre integration and cost many times more than elastic ones, so equal numbers of elements per thread leave threads idle. The cycles taken by each element are measured with \ref read_cycle_counter, and the elements
+         * are dealt out dynamically in chunks balanced by the costs of the previous update; see \ref balance_element_chunks. The time each thread spent on elements and waiting for the others is kept in \ref thread_busy_times and \ref thread_idle_times.
          */
         void update_elements_states()
         {
-            #ifdef KOKKOS
-                  Kokkos::parallel_for( "GlobalMesh::update_elements_states", elem_vector.size(), KOKKOS_LAMBDA (int i) {
-                        elem_vector[i]->update_state();
-                        elem_vector[i]->calc_global_stiffness_triplets();
-                    });
-            #else
-                #pragma omp parallel for
-                for (auto& elem: elem_vector)
+            int num_skipped = 0;
+                using clock = std::chrono::steady_clock;
+                int num_threads = get_max_num_threads();
+                if (element_chunk_starts.empty() || element_chunk_starts.back() != elem_vector.size())
+                    balance_element_chunks(num_threads);
+                int num_chunks = element_chunk_starts.size() - 1;
+                thread_busy_times.assign(num_threads, 0.0);
+                clock::time_point region_start = clock::now();
+                #pragma omp parallel reduction(+:num_skipped)
+                {
+                    double busy_time = 0.0;
+                    #pragma omp for schedule(dynamic, 1) nowait
+                    for (int chunk = 0; chunk < num_chunks; ++chunk)
+                    {
+                        clock::time_point chunk_start = clock::now();
+                        for (size_t i = element_chunk_starts[chunk]; i < element_chunk_starts[chunk + 1]; ++i)
+                        {
+                            std::uint64_t element_start = read_cycle_counter();
+                            if (!elem_vector[i]->update_state_if_changed(element_skip_tolerance))
+                                ++num_skipped;
+                            element_costs[i] = read_cycle_counter() - element_start;
+                        }
+                        busy_time += std::chrono::duration<double>(clock::now() - chunk_start).count();
+                    }
+                    thread_busy_times[get_thread_num()] = busy_time;
+                }
+                double region_time = std::chrono::duration<double>(clock::now() - region_start).count();
+                thread_idle_times.resize(num_threads);
+                for (int thread = 0; thread < num_threads; ++thread)
+                    thread_idle_times[thread] = std::max(0.0, region_time - thread_busy_times[thread]);
+                balance_element_chunks(num_threads);
+            num_skipped_elements = num_skipped;
+        }
+
+        /**
+         * @brief Get the time each thread spent updating elements in the last call to \ref update_elements_states.
+         */
+        const std::vector<double>& get_thread_busy_times() const {return thread_busy_times;}
+
+        /**
+         * @brief Get the time each thread waited for the others in the last call to \ref update_elements_states.
+         */
+        const std::vector<double>& get_thread_idle_times() const {return thread_idle_times;}
+
+        /**
+         * @brief Get the element chunks dealt out to the threads by \ref update_elements_states; see \ref element_chunk_starts.
+         */
+        const std::vector<size_t>& get_element_chunk_starts() const {return element_chunk_starts;}
+
+        /**
+         * @brief sets the cost of each element in \ref elem_vector used by the next \ref balance_element_chunks, e.g. to replay the costs measured in an earlier run.
+         */
+        void set_element_costs(std::vector<std::uint64_t> costs) {element_costs = std::move(costs);}
+
+        /**
+         * @brief re-allocates the storage of each element from the thread that will update it, so that on a multi-socket node the element storage is spread over the NUMA domains of the threads.
+         * @details Linux places a page in the NUMA domain of the thread that first writes to it, and the mesh is built by the master thread alone. The elements are visited in the equal chunks that \ref update_elements_states starts with, dealt out
+         * round-robin as its dynamic schedule does while all chunks cost the same. Fibre states that are only materialised once a section yields are allocated within \ref update_elements_states, and so are first touched by the updating thread in any case.
+         */
+        void first_touch_element_storage()
+        {
+                balance_element_chunks(get_max_num_threads());
+                int num_chunks = element_chunk_starts.size() - 1;
+                #pragma omp parallel for schedule(static, 1)
+                for (int chunk = 0; chunk < num_chunks; ++chunk)
                 {
-                    elem->update_state();
-                    elem->calc_global_stiffness_triplets();
+                    for (size_t i = element_chunk_starts[chunk]; i < element_chunk_starts[chunk + 1]; ++i)
+                        elem_vector[i]->first_touch_storage();
                 }
+        }
+
+        /**
+         * @brief rebuilds \ref layout from the current nodes, DoF numbering, and elements. Called by the \ref Assembler once the DoFs are numbered.
+         */
+        void build_layout()
+        {
+            layout.build({&node_vector, &interface_node_vector}, elem_vector);
+            layout_valid = true;
+        }
+
+        /**
+         * @brief marks \ref layout as stale so that \ref get_layout rebuilds it. Called by every function that adds, removes, or reorders nodes or elements, or that changes the active DoFs or their numbering.
+         */
+        void invalidate_layout() {layout_valid = false;}
+
+        /**
+         * @brief Get the flat layout of the mesh used by the parallel kernels, rebuilding it first if it was invalidated since it was built; see \ref invalidate_layout.
+         */
+        const MeshLayout& get_layout()
+        {
+            if (!layout_valid)
+                build_layout();
+            return layout;
+        }
+
+        /**
+         * @brief sets the largest change in element displacements for which \ref update_elements_states keeps an element's cached state. Zero, the default, only skips elements that did not move at all; a negative value re-evaluates every element.
+         */
+        void set_element_skip_tolerance(real tolerance) {element_skip_tolerance = tolerance;}
+
+        /**
+         * @brief Get the number of elements on this rank that were skipped by the last call to \ref update_elements_states.
+         */
+        int get_num_skipped_elements() const {return num_skipped_elements;}
+
+        /**
+         * @brief calculates the product \f$\boldsymbol{K}\boldsymbol{v}\f$ element-by-element without assembling \f$\boldsymbol{K}\f$.
+         * @details serial as elements sharing a node scatter to the same rows of \f$\boldsymbol{K}\boldsymbol{v}\f$.
+         * 
+         * @param v the global vector being multiplied by the stiffness.
+         * @param Kv the product; resized to \ref ndofs and overwritten.
+         */
+        void calc_stiffness_product(const vec& v, vec& Kv)
+        {
+            Kv.setZero(ndofs);
+            for (auto& elem: elem_vector)
+            {
+                elem->add_stiffness_product(v, Kv);
+            }
+        }
+
+        /**
+         * @brief calculates the diagonal of the global stiffness matrix element-by-element without assembling \f$\boldsymbol{K}\f$.
+         * 
+         * @param diagonal the diagonal; resized to \ref ndofs and overwritten.
+         */
+        void calc_stiffness_diagonal(vec& diagonal)
+        {
+            diagonal.setZero(ndofs);
+            for (auto& elem: elem_vector)
+            {
+                elem->add_stiffness_diagonal(diagonal);
+            }
+        }
+
+        /**
+         * @brief calculates the product of the entry-wise absolute stiffness \f$|\boldsymbol{K}|\boldsymbol{v}\f$ element-by-element.
+         * @details in the distributed build only the rows of the rank-owned DoFs are calculated, from the stiffness triplets of the elements, whose columns can also be interface DoFs.
+         * 
+         * @param v the vector being multiplied by the absolute stiffness; in the distributed build, its values at the rank-owned DoFs followed by those at the interface DoFs, in the order of \ref layout.
+         * @param Kv the product; resized to \ref ndofs, or to \ref rank_ndofs in the distributed build, and overwritten.
+         */
+        void calc_abs_stiffness_product(const vec& v, vec& Kv)
+        {
+            #ifdef WITH_MPI
+            const MeshLayout& layout = get_layout();
+            std::unordered_map<int, int> interface_columns; // from the global DoF number of an interface DoF to its position in v.
+            for (size_t i = node_vector.size(); i < layout.num_nodes(); ++i)
+            {
+                for (int j = layout.dof_offsets[i]; j < layout.dof_offsets[i + 1]; ++j)
+                    interface_columns[layout.U_indices[j]] = j;
+            }
+            Kv.setZero(rank_ndofs);
+            std::vector<spnz> element_triplets;
+            for (auto& elem: elem_vector)
+            {
+                element_triplets.clear();
+                elem->insert_global_stiffness_triplets(element_triplets);
+                for (const spnz& triplet: element_triplets)
+                {
+                    int column = triplet.col() - rank_starting_nz_i;
+                    if (column < 0 || column >= rank_ndofs)
+                        column = interface_columns.at(triplet.col());
+                    Kv(triplet.row() - rank_starting_nz_i) += std::abs(triplet.value())*v(column);
+                }
+            }
+            #else
+            Kv.setZero(ndofs);
+            for (auto& elem: elem_vector)
+            {
+                elem->add_abs_stiffness_product(v, Kv);
+            }
             #endif
+        }
 
+        /**
+         * @brief calculates the diagonal lumped mass vector from the element masses (\f$\rho A L\f$) and the point masses of the nodes, which are applied to translational DoFs only.
+         * 
+         * @param density mass density of the elements; can be zero if only nodal masses are used.
+         * @param M the lumped mass vector; resized to \ref ndofs, or to the rank-owned \ref rank_ndofs in the distributed build, and overwritten.
+         */
+        void calc_lumped_masses(real density, vec& M)
+        {
+            #ifdef WITH_MPI
+            int first_row = rank_starting_nz_i;
+            M.setZero(rank_ndofs);
+            #else
+            int first_row = 0;
+            M.setZero(ndofs);
+            #endif
+            for (auto& elem: elem_vector)
+            {
+                elem->add_lumped_mass(density, M, first_row);
+            }
+            for (auto& node: node_vector)
+            {
+                real node_mass = node->get_mass();
+                if (node_mass <= 0.0)
+                    continue;
+                std::set<int> node_active_dofs = node->get_active_dofs();
+                int i = 0;
+                for (auto& dof: node_active_dofs) {
+                    if (dof % 2 == 0)
+                    {
+                        M(node->get_nz_i() - first_row + i) += node_mass;
+                    }
+                    ++i;
+                }
+            }
         }
 
         void update_element_sections_starting_states()
         {
-            #ifdef KOKKOS
-                Kokkos::parallel_for( "GlobalMesh::update_element_sections_starting_states", elem_vector.size(), KOKKOS_LAMBDA (int i) {
-                    elem_vector[i]->update_section_starting_state();
-                });
-            #else
                 #pragma omp parallel for
                 for (auto& elem: elem_vector)
                 {
                     elem->update_section_starting_state();
                 }
+        }
+
+        /**
+         * @brief the same as \ref update_element_sections_starting_states, but spawns the element commits as OpenMP tasks so it can share the threads with other tasks. Must be called from inside a parallel region, e.g. by one thread of a `single` construct; returns when all elements are committed.
+         */
+        void update_element_sections_starting_states_as_tasks()
+        {
+            #pragma omp taskloop
+            for (size_t i = 0; i < elem_vector.size(); ++i)
+            {
+                elem_vector[i]->update_section_starting_state();
+            }
+        }
+
+        /**
+         * @brief writes the rank-owned nodal loads and the committed element states.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary(out, node_vector.size());
+            for (auto& node: node_vector)
+            {
+                node->write_checkpoint(out);
+            }
+            write_binary(out, elem_vector.size());
+            for (auto& elem: elem_vector)
+            {
+                write_binary(out, elem->get_id());
+                elem->write_checkpoint(out);
+            }
+        }
+
+        /**
+         * @brief fills \p snapshot with the coordinates and displacements of the nodes owned by this rank, and the forces and plastic strains of the elements it owns; see \ref FieldSnapshot.
+         * @details in the distributed build the nodes are numbered consecutively across ranks by \ref renumber_nodes, so a node's global position is its ID less one. In the serial build the IDs need not be consecutive and the position is that in \ref node_vector.
+         */
+        void gather_field_snapshot(FieldSnapshot& snapshot) const
+        {
+            snapshot.num_nodes = nnodes;
+            snapshot.num_elements = nelems;
+            snapshot.node_ids.clear();
+            snapshot.coordinates.clear();
+            snapshot.translations.clear();
+            snapshot.rotations.clear();
+            snapshot.element_ids.clear();
+            snapshot.connectivity.clear();
+            snapshot.element_forces.clear();
+            snapshot.plastic_strains.clear();
+            snapshot.node_ids.reserve(node_vector.size());
+            snapshot.coordinates.reserve(3*node_vector.size());
+            snapshot.translations.reserve(3*node_vector.size());
+            snapshot.rotations.reserve(3*node_vector.size());
+            for (auto& node: node_vector)
+            {
+                snapshot.node_ids.push_back(node->get_record_id());
+                coords node_coords = node->get_coords();
+                std::array<real, 6> displacements = node->get_nodal_displacements();
+                snapshot.coordinates.insert(snapshot.coordinates.end(), node_coords.data(), node_coords.data() + 3);
+                // DoF 2 is the in-plane translation along y, and DoF 1 the out-of-plane one along z.
+                snapshot.translations.insert(snapshot.translations.end(), {displacements[0], displacements[2], displacements[1]});
+                snapshot.rotations.insert(snapshot.rotations.end(), displacements.begin() + 3, displacements.end());
+            }
+
+            #ifdef WITH_MPI
+            snapshot.node_offset = rank_starting_node_id - 1;
+            auto get_node_position = [](unsigned node_id) {return node_id - 1;};
+            auto is_owned = [this](unsigned node_id) {return node_id >= rank_starting_node_id && node_id < rank_starting_node_id + rank_nnodes;};
+            #else
+            snapshot.node_offset = 0;
+            std::unordered_map<unsigned, std::uint32_t> node_positions;
+            node_positions.reserve(node_vector.size());
+            for (size_t i = 0; i < node_vector.size(); ++i)
+                node_positions[node_vector[i]->get_id()] = i;
+            auto get_node_position = [&node_positions](unsigned node_id) {return node_positions.at(node_id);};
+            auto is_owned = [](unsigned) {return true;};
+            #endif
+            for (auto& elem: elem_vector)
+            {
+                std::vector<unsigned> elem_node_ids = elem->get_node_ids();
+                if (!is_owned(elem_node_ids.front()))
+                    continue;
+                snapshot.element_ids.push_back(elem->get_id());
+                for (unsigned node_id : elem_node_ids)
+                    snapshot.connectivity.push_back(get_node_position(node_id));
+                vec local_f = elem->get_local_f();
+                snapshot.element_forces.insert(snapshot.element_forces.end(), local_f.data(), local_f.data() + local_f.size());
+                snapshot.plastic_strains.push_back(elem->get_max_plastic_strain());
+            }
+
+            unsigned long num_element_forces = elem_vector.empty() ? 0 : elem_vector.front()->get_local_f().size();
+            #ifdef WITH_MPI
+            unsigned long num_owned_elements = snapshot.element_ids.size();
+            unsigned long element_offset = 0;
+            CommunicationTimer communication("field_output_offsets");
+            MPI_Exscan(&num_owned_elements, &element_offset, 1, MPI_UNSIGNED_LONG, MPI_SUM, MPI_COMM_WORLD);
+            snapshot.element_offset = (rank == 0) ? 0 : element_offset;
+            MPI_Allreduce(MPI_IN_PLACE, &num_element_forces, 1, MPI_UNSIGNED_LONG, MPI_MAX, MPI_COMM_WORLD);
+            #else
+            snapshot.element_offset = 0;
             #endif
+            snapshot.num_element_forces = num_element_forces;
         }
+
+        /**
+         * @brief restores the nodal loads and committed element states written by \ref write_checkpoint into a mesh built the same way. Exits if the nodes or elements differ.
+         */
+        void read_checkpoint(std::istream& in)
+        {
+            size_t num_nodes, num_elems;
+            read_binary(in, num_nodes);
+            if (num_nodes != node_vector.size())
+            {
+                std::cout << "GlobalMesh::read_checkpoint: checkpoint has " << num_nodes << " nodes but the mesh has " << node_vector.size() << " on rank " << rank << "." << std::endl;
+                exit(1);
+            }
+            for (auto& node: node_vector)
+            {
+                node->read_checkpoint(in);
+            }
+            read_binary(in, num_elems);
+            if (num_elems != elem_vector.size())
+            {
+                std::cout << "GlobalMesh::read_checkpoint: checkpoint has " << num_elems << " elements but the mesh has " << elem_vector.size() << " on rank " << rank << "." << std::endl;
+                exit(1);
+            }
+            for (auto& elem: elem_vector)
+            {
+                unsigned elem_id;
+                read_binary(in, elem_id);
+                if (elem_id != elem->get_id())
+                {
+                    std::cout << "GlobalMesh::read_checkpoint: element " << elem->get_id() << " was given the checkpoint of element " << elem_id << "." << std::endl;
+                    exit(1);
+                }
+                elem->read_checkpoint(in);
+            }
+        }
+
+        /**
+         * @brief writes everything the mesh setup decided on this rank: the frame, the counts, node ownership and exchange maps, the nodes with their restraints and DoF numbering, and the connectivity of the elements.
+         * @details must be called after the restraints were applied and the DoFs counted. The sections and loads are not written, so a mesh read back with \ref create_mesh_from_setup_snapshot can take different ones.
+         */
+        void write_setup_snapshot(std::ostream& out) const
+        {
+            write_binary(out, frame);
+            for (int count : {nnodes, ndofs, nelems, rank_nnodes, rank_interface_nnodes, rank_ndofs, rank_nelems, rank_starting_nz_i, max_num_stiffness_contributions})
+                write_binary(out, count);
+            write_binary(out, rank_starting_node_id);
+            write_binary_span<int>(out, ranks_ndofs);
+            write_binary_span<unsigned>(out, ranks_nnodes);
+            write_binary_span<unsigned>(out, std::vector<unsigned>(node_id_set_owned_by_rank.begin(), node_id_set_owned_by_rank.end()));
+            write_binary_span<unsigned>(out, std::vector<unsigned>(interface_node_id_set_on_rank.begin(), interface_node_id_set_on_rank.end()));
+            for (auto* rank_node_id_map : {&wanted_by_neighbour_rank_node_id_map, &wanted_from_neighbour_rank_node_id_map})
+            {
+                write_binary(out, rank_node_id_map->size());
+                for (auto& [neighbour, node_ids] : *rank_node_id_map)
+                {
+                    write_binary(out, neighbour);
+                    write_binary_span<unsigned>(out, std::vector<unsigned>(node_ids.begin(), node_ids.end()));
+                }
+            }
+
+            std::unordered_map<unsigned, unsigned> id_record_id_map;
+            for (auto* nodes : {&node_vector, &interface_node_vector})
+            {
+                write_binary(out, nodes->size());
+                for (auto& node : *nodes)
+                {
+                    node->write_setup_snapshot(out);
+                    id_record_id_map[node->get_id()] = node->get_record_id();
+                }
+            }
+            write_binary(out, elem_vector.size());
+            for (auto& elem : elem_vector)
+            {
+                std::vector<unsigned> node_record_ids = elem->get_node_ids();
+                for (auto& node_id : node_record_ids)
+                    node_id = id_record_id_map.at(node_id);
+                write_binary(out, elem->get_id());
+                write_binary_span<unsigned>(out, node_record_ids);
+            }
+        }
+
+        /**
+         * @brief restores the mesh written by \ref write_setup_snapshot, creating the elements with the current \ref element_type and section. Nothing is communicated.
+         */
+        void read_setup_snapshot(std::istream& in)
+        {
+            invalidate_layout();
+            read_binary(in, frame);
+            for (int* count : {&nnodes, &ndofs, &nelems, &rank_nnodes, &rank_interface_nnodes, &rank_ndofs, &rank_nelems, &rank_starting_nz_i, &max_num_stiffness_contributions})
+                read_binary(in, *count);
+            read_binary(in, rank_starting_node_id);
+            read_binary_vector(in, ranks_ndofs);
+            read_binary_vector(in, ranks_nnodes);
+            std::vector<unsigned> node_ids;
+            read_binary_vector(in, node_ids);
+            node_id_set_owned_by_rank = std::set<unsigned>(node_ids.begin(), node_ids.end());
+            read_binary_vector(in, node_ids);
+            interface_node_id_set_on_rank = std::set<unsigned>(node_ids.begin(), node_ids.end());
+            for (auto* rank_node_id_map : {&wanted_by_neighbour_rank_node_id_map, &wanted_from_neighbour_rank_node_id_map})
+            {
+                size_t num_neighbours;
+                read_binary(in, num_neighbours);
+                rank_node_id_map->clear();
+                for (size_t i = 0; i < num_neighbours; ++i)
+                {
+                    int neighbour;
+                    read_binary(in, neighbour);
+                    read_binary_vector(in, node_ids);
+                    (*rank_node_id_map)[neighbour] = std::set<unsigned>(node_ids.begin(), node_ids.end());
+                }
+            }
+
+            for (auto* nodes : {&node_vector, &interface_node_vector})
+            {
+                size_t num_nodes;
+                read_binary(in, num_nodes);
+                nodes->clear();
+                nodes->reserve(num_nodes);
+                for (size_t i = 0; i < num_nodes; ++i)
+                {
+                    nodes->push_back(std::make_shared<Node>());
+                    nodes->back()->read_setup_snapshot(in, rank);
+                }
+            }
+            size_t num_elems;
+            read_binary(in, num_elems);
+            ElemIdNodeIdPairVector elem_nodes_vector(num_elems);
+            for (auto& [elem_id, elem_node_record_ids] : elem_nodes_vector)
+            {
+                read_binary(in, elem_id);
+                read_binary_vector(in, elem_node_record_ids);
+            }
+            elem_vector.clear();
+            elem_vector.reserve(num_elems);
+            make_elements(elem_nodes_vector);
+        }
+
         /**
          * @brief prints the selected state of each element.
          * 
@@ -1622,6 +2283,7 @@ class GlobalMesh {
          */
         void sort_node_vector(std::string vector_to_sort="all")
         {
+            invalidate_layout();
             if (vector_to_sort == "all")
             {
                 sort_node_vector("rank_owned");
@@ -1656,6 +2318,7 @@ class GlobalMesh {
          */
         void sort_element_vector()
         {
+            invalidate_layout();
         std::sort(elem_vector.begin(), elem_vector.end(), 
                 [](const auto& a, const auto& b) 
                 {
@@ -0,0 +1,56 @@
+/**
+ * @file AssemblyBenchmarks.hpp
+ * @brief benchmarks of the global kernels of each Newton iteration on frames of increasing size: assembly, mapping \f$\boldsymbol{U}\f$ to the nodes, and the linear solution.
+ */
+
+#ifndef ASSEMBLY_BENCHMARKS_HPP
+#define ASSEMBLY_BENCHMARKS_HPP
+
+#include "BenchmarkHelpers.hpp"
+
+/**
+ * @brief the frame sizes, in bays and floors, at which the global kernels are measured; 10 elements per member give 30 to 5280 elements.
+ */
+#define BENCHMARK_FRAME_SIZES ->ArgName("bays_floors")->Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->Unit(benchmark::kMicrosecond)
+
+static void BM_AssembleGlobalKR(benchmark::State& state)
+{
+    BenchmarkFrame frame(state.range(0), NonlinearPlastic);
+    for (auto _ : state)
+    {
+        frame.model.assembler.assemble_global_K_R(frame.model.glob_mesh);
+        benchmark::ClobberMemory();
+    }
+    frame.set_counters(state);
+}
+BENCHMARK(BM_AssembleGlobalKR) BENCHMARK_FRAME_SIZES;
+
+static void BM_MapUToNodes(benchmark::State& state)
+{
+    BenchmarkFrame frame(state.range(0), NonlinearPlastic);
+    for (auto _ : state)
+    {
+        frame.model.assembler.map_U_to_nodes(frame.model.glob_mesh);
+        benchmark::ClobberMemory();
+    }
+    frame.set_counters(state);
+}
+BENCHMARK(BM_MapUToNodes) BENCHMARK_FRAME_SIZES;
+
+/**
+ * @brief factorises the assembled stiffness of the frame and solves for \f$\Delta\boldsymbol{U}\f$, as \ref BasicSolver does at every full Newton iteration.
+ */
+static void BM_BasicSolverFactoriseSolve(benchmark::State& state)
+{
+    BenchmarkFrame frame(state.range(0), NonlinearPlastic);
+    frame.model.assembler.calculate_out_of_balance();
+    for (auto _ : state)
+    {
+        frame.model.solver.solve_for_deltaU(frame.model.assembler);
+        benchmark::ClobberMemory();
+    }
+    frame.set_counters(state);
+}
+BENCHMARK(BM_BasicSolverFactoriseSolve) BENCHMARK_FRAME_SIZES;
+
+#endif
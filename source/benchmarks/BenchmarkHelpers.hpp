@@ -0,0 +1,129 @@
+/**
+ * @file BenchmarkHelpers.hpp
+ * @brief common includes and model factories for the Google Benchmark microbenchmarks of the hot kernels of Blaze.
+ */
+
+#ifndef BENCHMARK_HELPERS_HPP
+#define BENCHMARK_HELPERS_HPP
+/**
+ * @name common inclusions
+ * @brief each benchmark file should only include this file.
+ */
+//@{
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "blaze_config.hpp"
+#include "maths_defaults.hpp"
+#include "MPIWrappers.hpp"
+#include "node.hpp"
+#include "ElasticPlasticMaterial.hpp"
+#include "BeamColumnFiberSection.hpp"
+#include "Linear2DBeamElement.hpp"
+#include "Nonlinear2DBeamElement.hpp"
+#include "Nonlinear2DPlasticBeamElement.hpp"
+#include "NonlinearTransform.hpp"
+#include "NodalRestraint.hpp"
+#include "Model.hpp"
+//@}
+
+/**
+ * @name benchmark definitions
+ * @brief the section and material used by all benchmarks; a UB457x191x89 in S355 steel as in the frames run by Blaze.
+ */
+//@{
+#define BENCHMARK_YOUNGS_MODULUS 2.06e11
+#define BENCHMARK_YIELD_STRENGTH 355e6
+#define BENCHMARK_HARDENING_RATIO 0.02
+#define BENCHMARK_TF 19.6e-3
+#define BENCHMARK_TW 11.4e-3
+#define BENCHMARK_B 192.8e-3
+#define BENCHMARK_H 467.2e-3
+//@}
+
+/**
+ * @brief adds the fibres of an I section to \p section; same as `build_an_I_section` in main.cpp.
+ */
+inline void build_benchmark_I_section(BeamColumnFiberSection& section, ElasticPlasticMaterial& steel, int flange_divisions, int web_divisions)
+{
+    std::vector<real> areas;
+    std::vector<real> ys;
+    real tf = BENCHMARK_TF, tw = BENCHMARK_TW, b = BENCHMARK_B, h = BENCHMARK_H;
+    for (int i = 0; i < flange_divisions; ++i)
+    {
+        ys.push_back((i + 0.5)*tf/flange_divisions);
+        areas.push_back(b*tf/flange_divisions);
+    }
+    for (int i = 0; i < web_divisions; ++i)
+    {
+        ys.push_back(tf + (i + 0.5)*(h - 2*tf)/web_divisions);
+        areas.push_back((h - 2*tf)*tw/web_divisions);
+    }
+    for (int i = 0; i < flange_divisions; ++i)
+    {
+        ys.push_back(h - tf + (i + 0.5)*tf/flange_divisions);
+        areas.push_back(b*tf/flange_divisions);
+    }
+    section.add_fibres(&steel, areas, ys);
+}
+
+/**
+ * @brief the basic section equivalent to \ref build_benchmark_I_section.
+ */
+inline BasicSection make_benchmark_basic_section()
+{
+    real tf = BENCHMARK_TF, tw = BENCHMARK_TW, b = BENCHMARK_B, h = BENCHMARK_H;
+    real moment_of_inertia = tw*pow(h - 2*tf, 3)/12 + 2*b*pow(tf,3)/12 + 2*(tf*b)*pow(0.5*h - 0.5*tf, 2);
+    real area = 2*tf*b + (h - 2*tf)*tw;
+    return BasicSection(BENCHMARK_YOUNGS_MODULUS, area, moment_of_inertia);
+}
+
+/**
+ * @brief a portal frame of \p size bays and \p size floors set up as in main.cpp, with fixed column bases, out-of-plane restraints, and a load on the beams; ready for assembly and solution.
+ */
+struct BenchmarkFrame {
+    ElasticPlasticMaterial steel = ElasticPlasticMaterial(BENCHMARK_YOUNGS_MODULUS, BENCHMARK_YIELD_STRENGTH, BENCHMARK_HARDENING_RATIO*BENCHMARK_YOUNGS_MODULUS);
+    BeamColumnFiberSection fibre_section;
+    BasicSection basic_section = make_benchmark_basic_section();
+    Model model;
+
+    BenchmarkFrame(int size, ElementType elem_type, int divisions = 10)
+    {
+        if (elem_type == NonlinearPlastic)
+        {
+            build_benchmark_I_section(fibre_section, steel, 4, 20);
+            model.create_distributed_frame_mesh(size, size, 6.0, 3.5, divisions, divisions, elem_type, fibre_section);
+        } else {
+            model.create_distributed_frame_mesh(size, size, 6.0, 3.5, divisions, divisions, elem_type, basic_section);
+        }
+        FrameMesh frame = model.glob_mesh.get_frame();
+        NodalRestraint column_bases;
+        column_bases.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4, 5});
+        column_bases.assign_distributed_nodes_by_record_id(frame.get_column_bases(), model.glob_mesh);
+        NodalRestraint out_of_plane_restraint;
+        out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
+        out_of_plane_restraint.assign_distributed_nodes_by_record_id(frame.get_out_of_plane_nodes(), model.glob_mesh);
+        model.restraints.push_back(column_bases);
+        model.restraints.push_back(out_of_plane_restraint);
+
+        std::set<unsigned> loaded_nodes = frame.get_all_beam_line_node_ids(false);
+        std::vector<unsigned> loaded_nodes_v(loaded_nodes.begin(), loaded_nodes.end());
+        model.load_manager.create_a_distributed_nodal_load_by_id(loaded_nodes_v, std::set<int>{2}, std::vector<real>{-1e4}, model.glob_mesh);
+        model.initialise_restraints_n_loads();
+        model.initialise_solution_parameters(1.0, 1, 1e-4, 10);
+    }
+
+    /**
+     * @brief adds the frame size to the counters of a benchmark so that times can be related to the problem size.
+     */
+    void set_counters(benchmark::State& state)
+    {
+        state.counters["elements"] = model.glob_mesh.get_num_elems();
+        state.counters["dofs"] = model.glob_mesh.get_ndofs();
+    }
+};
+
+#endif
@@ -0,0 +1,51 @@
+#include "MaterialBenchmarks.hpp"
+#include "ElementBenchmarks.hpp"
+#include "AssemblyBenchmarks.hpp"
+
+/**
+ * @brief runs the benchmarks and writes their results as JSON to `blaze_benchmarks.json`, unless `--benchmark_out` names another file, so that runs of different versions can be compared with Google Benchmark's `compare.py`.
+ */
+int main(int argc, char** argv)
+{
+    #ifdef KOKKOS
+        Kokkos::initialize(argc, argv);
+    #endif
+    #ifdef WITH_MPI
+    ThreadedMPIGuard mpi_guard(argc, argv);
+    Tpetra::ScopeGuard tpetraScope (&argc, &argv);
+    #endif
+    {
+    std::vector<char*> args(argv, argv + argc);
+    std::string out_arg = "--benchmark_out=blaze_benchmarks.json";
+    std::string format_arg = "--benchmark_out_format=json";
+    bool has_out = false;
+    for (int i = 1; i < argc; ++i)
+        has_out = has_out || std::string(argv[i]).starts_with("--benchmark_out=");
+    if (!has_out)
+    {
+        args.push_back(out_arg.data());
+        args.push_back(format_arg.data());
+    }
+    int num_args = args.size();
+    benchmark::Initialize(&num_args, args.data());
+    if (benchmark::ReportUnrecognizedArguments(num_args, args.data()))
+        return 1;
+    // record how Blaze was built so that only comparable results are compared.
+    std::string build = "serial";
+    #ifdef WITH_MPI
+    build = "mpi";
+    #endif
+    #ifdef KOKKOS
+    build += "+kokkos";
+    #elif defined(OMP)
+    build += "+openmp";
+    #endif
+    benchmark::AddCustomContext("blaze_build", build);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    }
+    #ifdef KOKKOS
+        Kokkos::finalize();
+    #endif
+    return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * @file ElementBenchmarks.hpp
+ * @brief benchmarks of the element state updates and of the corotational transformation they use.
+ */
+
+#ifndef ELEMENT_BENCHMARKS_HPP
+#define ELEMENT_BENCHMARKS_HPP
+
+#include "BenchmarkHelpers.hpp"
+
+/**
+ * @brief the global displacements of a 3 m element bent and stretched into the nonlinear range: the far node moves 1 mm along and 30 mm across and rotates by 0.01 rad.
+ */
+inline vec make_benchmark_element_U()
+{
+    vec U = make_xd_vec(12);
+    U(6) = 1e-3;
+    U(8) = 30e-3;
+    U(11) = 0.01;
+    return U;
+}
+
+/**
+ * @brief calls `update_state` of an element of type \p Element made with \p sect, at the displacements of \ref make_benchmark_element_U.
+ */
+template <typename Element, typename Section>
+void benchmark_element_update(benchmark::State& state, Section& sect)
+{
+    std::vector<std::shared_ptr<Node>> nodes = {std::make_shared<Node>(0.0, 0.0, 0.0), std::make_shared<Node>(3.0, 0.0, 0.0)};
+    Element element(0, nodes, sect);
+    element.set_global_U(make_benchmark_element_U());
+    for (auto _ : state)
+    {
+        element.update_state();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Linear2DBeamElementUpdateState(benchmark::State& state)
+{
+    BasicSection sect = make_benchmark_basic_section();
+    benchmark_element_update<Linear2DBeamElement>(state, sect);
+}
+BENCHMARK(BM_Linear2DBeamElementUpdateState);
+
+static void BM_Nonlinear2DBeamElementUpdateState(benchmark::State& state)
+{
+    BasicSection sect = make_benchmark_basic_section();
+    benchmark_element_update<Nonlinear2DBeamElement>(state, sect);
+}
+BENCHMARK(BM_Nonlinear2DBeamElementUpdateState);
+
+static void BM_Nonlinear2DPlasticBeamElementUpdateState(benchmark::State& state)
+{
+    ElasticPlasticMaterial steel(BENCHMARK_YOUNGS_MODULUS, BENCHMARK_YIELD_STRENGTH, BENCHMARK_HARDENING_RATIO*BENCHMARK_YOUNGS_MODULUS);
+    BeamColumnFiberSection sect;
+    build_benchmark_I_section(sect, steel, 4, 20);
+    benchmark_element_update<Nonlinear2DPlasticBeamElement>(state, sect);
+}
+BENCHMARK(BM_Nonlinear2DPlasticBeamElementUpdateState);
+
+/**
+ * @brief updates the \ref NonlinearTransform of a 3 m element at the displacements of \ref make_benchmark_element_U.
+ */
+static void BM_NonlinearTransformUpdateState(benchmark::State& state)
+{
+    std::vector<std::shared_ptr<Node>> nodes = {std::make_shared<Node>(0.0, 0.0, 0.0), std::make_shared<Node>(3.0, 0.0, 0.0)};
+    NonlinearTransform transform;
+    transform.initialise(nodes);
+    vec U = make_benchmark_element_U();
+    for (auto _ : state)
+    {
+        transform.update_state(U);
+        benchmark::DoNotOptimize(transform.get_L());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NonlinearTransformUpdateState);
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file MaterialBenchmarks.hpp
+ * @brief benchmarks of the material and fibre section state updates, which are evaluated at every fibre of every integration point of every iteration.
+ */
+
+#ifndef MATERIAL_BENCHMARKS_HPP
+#define MATERIAL_BENCHMARKS_HPP
+
+#include "BenchmarkHelpers.hpp"
+
+/**
+ * @brief cycles \ref ElasticPlasticMaterial::increment_strain and commits each increment. Argument 0 stays elastic; argument 1 yields and reverses at every increment.
+ */
+static void BM_ElasticPlasticIncrementStrain(benchmark::State& state)
+{
+    ElasticPlasticMaterial steel(BENCHMARK_YOUNGS_MODULUS, BENCHMARK_YIELD_STRENGTH, BENCHMARK_HARDENING_RATIO*BENCHMARK_YOUNGS_MODULUS);
+    real yield_strain = BENCHMARK_YIELD_STRENGTH/BENCHMARK_YOUNGS_MODULUS;
+    real d_eps = state.range(0) ? 2.5*yield_strain : 0.5*yield_strain;
+    for (auto _ : state)
+    {
+        steel.increment_strain(d_eps);
+        steel.update_starting_state();
+        benchmark::DoNotOptimize(steel.get_stress());
+        d_eps = -d_eps;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ElasticPlasticIncrementStrain)->ArgName("plastic")->Arg(0)->Arg(1);
+
+/**
+ * @brief updates a \ref BeamColumnFiberSection of an I section with the given number of fibres at the given curvature, alternating its sign.
+ * The first argument is the number of fibres; the second is 0 for a curvature at half the yield curvature, which the elastic fast path evaluates without visiting the fibres, and 1 for one that yields most fibres.
+ */
+static void BM_FibreSectionUpdate(benchmark::State& state)
+{
+    ElasticPlasticMaterial steel(BENCHMARK_YOUNGS_MODULUS, BENCHMARK_YIELD_STRENGTH, BENCHMARK_HARDENING_RATIO*BENCHMARK_YOUNGS_MODULUS);
+    BeamColumnFiberSection section;
+    int num_fibres = state.range(0);
+    int flange_divisions = std::max(1, num_fibres/5);
+    build_benchmark_I_section(section, steel, flange_divisions, num_fibres - 2*flange_divisions);
+    real yield_curvature = 2*BENCHMARK_YIELD_STRENGTH/(BENCHMARK_YOUNGS_MODULUS*BENCHMARK_H);
+    vec eps = make_xd_vec(2);
+    eps << 0.0, (state.range(1) ? 4.0 : 0.5)*yield_curvature;
+    for (auto _ : state)
+    {
+        section.update_section_state(eps);
+        benchmark::DoNotOptimize(section.get_moment_yy());
+        eps(1) = -eps(1);
+    }
+    state.SetItemsProcessed(state.iterations()*num_fibres);
+    state.counters["fibres"] = num_fibres;
+}
+BENCHMARK(BM_FibreSectionUpdate)->ArgNames({"fibres", "plastic"})->ArgsProduct({{10, 30, 100, 300, 1000}, {0, 1}});
+
+#endif
@@ -0,0 +1 @@
+#include "CommunicationTimer.hpp"
\ No newline at end of file
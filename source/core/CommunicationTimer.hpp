@@ -0,0 +1,78 @@
+/**
+ * @file CommunicationTimer.hpp
+ * @brief defines the \ref CommunicationTimer class which measures the time this process spends communicating with, or waiting for, other ranks.
+ */
+
+#ifndef COMMUNICATION_TIMER_HPP
+#define COMMUNICATION_TIMER_HPP
+
+#include <sys/time.h>
+#include <map>
+#include <string>
+
+/**
+ * @brief measures the time between its construction and destruction as communication, adding it to a process-wide total and to the total of its call site.
+ * @details wrap each MPI call, Tpetra import, reduction, and distributed solve in a scope with a CommunicationTimer, e.g.
+ * `{CommunicationTimer communication("interface_import"); interface_U.doImport(...);}`. The measured time includes the time spent waiting for the slower ranks to reach the call.
+ * \ref TimeKeeper reads \ref get_total_duration when its timers start and stop to split each timed phase into compute and communication.
+ * Only the master thread may communicate (MPI_THREAD_FUNNELED), so the totals are not protected against concurrent updates.
+ */
+class CommunicationTimer
+{
+    protected:
+        inline static double total_duration = 0.0; /**< communication time of this process over all call sites.*/
+        inline static std::map<std::string, double> site_durations; /**< communication time of this process at each call site.*/
+        std::string site;
+        double start_time;
+
+    public:
+        /**
+         * @brief Get the current time using the `sys/time.h` header, as \ref ExecutionTimer does.
+         */
+        static double get_current_time()
+        {
+            struct timeval tp;
+            gettimeofday(&tp, NULL);
+            return tp.tv_sec + tp.tv_usec/(double)1.0e6;
+        }
+
+        /**
+         * @brief starts timing a communication.
+         * @param site_name the call site, e.g. "interface_import".
+         */
+        explicit CommunicationTimer(std::string site_name) : site(site_name), start_time(get_current_time()) {}
+
+        /**
+         * @brief adds the time since construction to the total and to the call site.
+         */
+        ~CommunicationTimer()
+        {
+            double duration = get_current_time() - start_time;
+            total_duration += duration;
+            site_durations[site] += duration;
+        }
+
+        CommunicationTimer(const CommunicationTimer&) = delete;
+        CommunicationTimer& operator=(const CommunicationTimer&) = delete;
+
+        /**
+         * @brief Get the communication time of this process over all call sites.
+         */
+        static double get_total_duration() {return total_duration;}
+
+        /**
+         * @brief Get the communication time of this process at each call site.
+         */
+        static const std::map<std::string, double>& get_site_durations() {return site_durations;}
+
+        /**
+         * @brief sets all the communication times to zero.
+         */
+        static void reset()
+        {
+            total_duration = 0.0;
+            site_durations.clear();
+        }
+};
+
+#endif
@@ -38,6 +38,31 @@ inline void finalise_MPI()
     MPI_Finalize();
 }
 
+/**
+ * @brief initialises MPI with MPI_THREAD_FUNNELED support for hybrid runs, where threads work inside each rank but only the master thread calls MPI, and finalises it when destroyed.
+ * @details must be created before the `Tpetra::ScopeGuard`, which then leaves MPI to this guard as it finds it initialised. A warning is printed if the MPI library only provides MPI_THREAD_SINGLE.
+ */
+class ThreadedMPIGuard
+{
+    public:
+        int provided = MPI_THREAD_SINGLE; /**< the level of thread support provided by the MPI library.*/
+
+        ThreadedMPIGuard(int& argc, char**& argv)
+        {
+            MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+            int rank;
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+            if (provided < MPI_THREAD_FUNNELED && rank == 0)
+                std::cout << "WARNING: MPI only provides MPI_THREAD_SINGLE; run with one thread per rank." << std::endl;
+        }
+        ~ThreadedMPIGuard()
+        {
+            MPI_Finalize();
+        }
+        ThreadedMPIGuard(const ThreadedMPIGuard&) = delete;
+        ThreadedMPIGuard& operator=(const ThreadedMPIGuard&) = delete;
+};
+
 inline void get_my_rank(int& rank)
 {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -0,0 +1 @@
+#include "ThreadPlacement.hpp"
\ No newline at end of file
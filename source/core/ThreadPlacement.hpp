@@ -0,0 +1,91 @@
+/**
+ * @file ThreadPlacement.hpp
+ * @brief functions for checking where the threads of each rank run when mixing MPI ranks and threads.
+ */
+
+#ifndef THREAD_PLACEMENT_HPP
+#define THREAD_PLACEMENT_HPP
+
+#include <cstdlib>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+#include <iostream>
+#ifdef __linux__
+    #include <sched.h>
+#endif
+#include "basic_utilities.hpp"
+
+/**
+ * @brief Get the CPU the calling thread is running on; -1 where this cannot be queried.
+ */
+inline int get_current_cpu()
+{
+    #ifdef __linux__
+    return sched_getcpu();
+    #else
+    return -1;
+    #endif
+}
+
+/**
+ * @brief Get the NUMA domain that a CPU belongs to, read from the `nodeN` entry Linux keeps in the sysfs directory of each CPU.
+ * @return the number of the NUMA domain, or -1 if it cannot be found.
+ */
+inline int get_numa_domain_of_cpu(int cpu)
+{
+    if (cpu < 0)
+        return -1;
+    std::error_code error;
+    std::filesystem::directory_iterator cpu_dir("/sys/devices/system/cpu/cpu" + std::to_string(cpu), error);
+    if (error)
+        return -1;
+    for (auto& entry : cpu_dir)
+    {
+        std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.rfind("node", 0) == 0 && name.find_first_not_of("0123456789", 4) == std::string::npos)
+            return std::stoi(name.substr(4));
+    }
+    return -1;
+}
+
+/**
+ * @brief Get the CPU each thread of a parallel region runs on, indexed by thread number.
+ */
+inline std::vector<int> get_thread_cpus()
+{
+    std::vector<int> cpus(get_max_num_threads(), -1);
+    #pragma omp parallel
+    {
+        cpus[get_thread_num()] = get_current_cpu();
+    }
+    return cpus;
+}
+
+/**
+ * @brief prints the CPU and NUMA domain of each thread of this rank, and warns if the placement breaks the binding policy described in the README: threads pinned with `OMP_PROC_BIND`, and all threads of a rank inside one NUMA domain.
+ * @details unpinned threads migrate between cores and lose the pages they first touched; a rank whose threads span domains reads part of its element storage across the socket link.
+ * @param rank rank of the calling MPI process.
+ */
+inline void report_thread_placement(int rank)
+{
+    std::vector<int> cpus = get_thread_cpus();
+    std::set<int> domains;
+    std::cout << "rank,thread,cpu,numa_domain" << std::endl;
+    for (size_t thread = 0; thread < cpus.size(); ++thread)
+    {
+        int domain = get_numa_domain_of_cpu(cpus[thread]);
+        domains.insert(domain);
+        std::cout << rank << "," << thread << "," << cpus[thread] << "," << domain << std::endl;
+    }
+    #ifdef OMP
+    const char* proc_bind = std::getenv("OMP_PROC_BIND");
+    if (proc_bind == nullptr || std::string(proc_bind) == "false")
+        std::cout << "WARNING: rank " << rank << " runs " << cpus.size() << " threads without OMP_PROC_BIND; threads may migrate away from the memory they first touched." << std::endl;
+    #endif
+    if (domains.size() > 1)
+        std::cout << "WARNING: the threads of rank " << rank << " span " << domains.size() << " NUMA domains; run one rank per NUMA domain." << std::endl;
+}
+
+#endif
@@ -9,7 +9,13 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <vector>
 
+#include <cstdint>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
 #ifdef KOKKOS
     #include <Kokkos_Core.hpp>
 #endif
@@ -17,6 +23,43 @@
     #include <omp.h>
 #endif
 
+/**
+ * @brief reads a cheap, monotonic cycle counter for measuring the relative cost of short pieces of work. Uses the time-stamp counter on x86, and a nanosecond clock elsewhere.
+ * @warning the counts are only comparable between calls on the same machine, and are not converted to seconds.
+ */
+inline std::uint64_t read_cycle_counter()
+{
+    #if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+    #else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    #endif
+}
+
+/**
+ * @brief Get the number of threads available to parallel regions; 1 without OpenMP.
+ */
+inline int get_max_num_threads()
+{
+    #ifdef OMP
+    return omp_get_max_threads();
+    #else
+    return 1;
+    #endif
+}
+
+/**
+ * @brief Get the number of the calling thread within its parallel region; 0 without OpenMP.
+ */
+inline int get_thread_num()
+{
+    #ifdef OMP
+    return omp_get_thread_num();
+    #else
+    return 0;
+    #endif
+}
+
 /**
  * @defgroup Utility 
  * 
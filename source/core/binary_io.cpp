@@ -0,0 +1 @@
+#include "binary_io.hpp"
@@ -0,0 +1,220 @@
+/**
+ * @file binary_io.hpp
+ * @brief helpers for writing and reading raw binary data, used for checkpointing and binary mesh files.
+ *
+ */
+
+#ifndef BINARY_IO_HPP
+#define BINARY_IO_HPP
+#include <iostream>
+#include <vector>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "maths_defaults.hpp"
+#include "tpetra_wrappers.hpp"
+
+/**
+ * @defgroup BinaryIO
+ *
+ * @brief functions that write and read the raw bytes of trivially-copyable data. The files are only meant to be read back by the same build on the same machine, so no byte-order conversion is done.
+ * @{
+ */
+
+/**
+ * @brief writes the raw bytes of a trivially-copyable value.
+ */
+template <typename T>
+void write_binary(std::ostream& out, const T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "write_binary can only write trivially-copyable types.");
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief reads the raw bytes of a trivially-copyable value. Exits if the stream ends early.
+ */
+template <typename T>
+void read_binary(std::istream& in, T& value)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "read_binary can only read trivially-copyable types.");
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!in)
+    {
+        std::cout << "read_binary: unexpected end of binary stream." << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * @brief writes the size of a contiguous range followed by the raw bytes of its elements.
+ */
+template <typename T>
+void write_binary_span(std::ostream& out, std::span<const T> values)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "write_binary_span can only write trivially-copyable types.");
+    write_binary(out, static_cast<size_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T));
+}
+
+/**
+ * @brief reads a range written by \ref write_binary_span into a std::vector, resizing it.
+ */
+template <typename T>
+void read_binary_vector(std::istream& in, std::vector<T>& values)
+{
+    static_assert(std::is_trivially_copyable_v<T>, "read_binary_vector can only read trivially-copyable types.");
+    size_t size;
+    read_binary(in, size);
+    values.resize(size);
+    in.read(reinterpret_cast<char*>(values.data()), size*sizeof(T));
+    if (!in)
+    {
+        std::cout << "read_binary_vector: unexpected end of binary stream." << std::endl;
+        exit(1);
+    }
+}
+
+/**
+ * @brief reads a range written by \ref write_binary_span into a range of known size. Exits if the sizes do not match.
+ */
+template <typename T>
+void read_binary_span(std::istream& in, std::span<T> values)
+{
+    size_t size;
+    read_binary(in, size);
+    if (size != values.size())
+    {
+        std::cout << "read_binary_span: expected " << values.size() << " values but the stream has " << size << "." << std::endl;
+        exit(1);
+    }
+    in.read(reinterpret_cast<char*>(values.data()), size*sizeof(T));
+    if (!in)
+    {
+        std::cout << "read_binary_span: unexpected end of binary stream." << std::endl;
+        exit(1);
+    }
+}
+
+#ifdef WITH_MPI
+/**
+ * @brief writes the rank-owned values of a single-column Tpetra vector.
+ */
+inline void write_binary_vector(std::ostream& out, const TpetraMultiVector& v)
+{
+    auto v_2d = v.getLocalViewHost(Tpetra::Access::ReadOnly);
+    auto v_local_view = Kokkos::subview(v_2d, Kokkos::ALL(), 0);
+    std::vector<real> values(v_local_view.extent(0));
+    for (size_t i = 0; i < values.size(); ++i)
+        values[i] = v_local_view(i);
+    write_binary_span<real>(out, values);
+}
+
+/**
+ * @brief reads the rank-owned values of a single-column Tpetra vector, which must already have the map it was written with.
+ */
+inline void read_binary_vector(std::istream& in, TpetraMultiVector& v)
+{
+    std::vector<real> values;
+    read_binary_vector(in, values);
+    auto v_2d = v.getLocalViewHost(Tpetra::Access::OverwriteAll);
+    auto v_local_view = Kokkos::subview(v_2d, Kokkos::ALL(), 0);
+    if (values.size() != v_local_view.extent(0))
+    {
+        std::cout << "read_binary_vector: expected " << v_local_view.extent(0) << " values but the stream has " << values.size() << "." << std::endl;
+        exit(1);
+    }
+    for (size_t i = 0; i < values.size(); ++i)
+        v_local_view(i) = values[i];
+}
+#else
+/**
+ * @brief writes a sparse vector as its size followed by its dense values.
+ */
+inline void write_binary_vector(std::ostream& out, const spvec& v)
+{
+    vec dense = v.toDense();
+    write_binary_span<real>(out, std::span<const real>(dense.data(), dense.size()));
+}
+
+/**
+ * @brief reads a sparse vector written by \ref write_binary_vector, keeping only its nonzero entries.
+ */
+inline void read_binary_vector(std::istream& in, spvec& v)
+{
+    std::vector<real> values;
+    read_binary_vector(in, values);
+    v = Eigen::Map<vec>(values.data(), values.size()).sparseView();
+}
+#endif
+
+/**
+ * @brief a read-only memory map of a whole file. Only the pages that are accessed are read from disk, so each rank can read its own part of a large file without reading the rest.
+ */
+class MappedFile
+{
+    private:
+        int file_descriptor = -1;
+        const char* data = nullptr;
+        size_t size = 0;
+
+    public:
+        /**
+         * @brief maps \p file_name into memory. Exits if the file cannot be opened or mapped.
+         */
+        MappedFile(std::string file_name)
+        {
+            file_descriptor = open(file_name.c_str(), O_RDONLY);
+            if (file_descriptor < 0)
+            {
+                std::cout << "MappedFile: could not open " << file_name << "." << std::endl;
+                exit(1);
+            }
+            struct stat file_status;
+            fstat(file_descriptor, &file_status);
+            size = file_status.st_size;
+            if (size > 0)
+            {
+                void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                if (map == MAP_FAILED)
+                {
+                    std::cout << "MappedFile: could not map " << file_name << " into memory." << std::endl;
+                    exit(1);
+                }
+                data = static_cast<const char*>(map);
+            }
+        }
+        ~MappedFile()
+        {
+            if (data)
+                munmap(const_cast<char*>(data), size);
+            if (file_descriptor >= 0)
+                close(file_descriptor);
+        }
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        size_t get_size() const {return size;}
+
+        /**
+         * @brief Get a view of \p count values of type T starting \p offset bytes into the file. Exits if the range is outside the file.
+         */
+        template <typename T>
+        std::span<const T> get_span(size_t offset, size_t count) const
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "MappedFile::get_span can only view trivially-copyable types.");
+            if (offset > size || count > (size - offset)/sizeof(T))
+            {
+                std::cout << "MappedFile: requested " << count << " values at byte " << offset << " of a file of " << size << " bytes." << std::endl;
+                exit(1);
+            }
+            return std::span<const T>(reinterpret_cast<const T*>(data + offset), count);
+        }
+};
+/** @} */ // end of BinaryIO group
+
+#endif
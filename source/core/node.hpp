@@ -10,6 +10,7 @@
 #include "basic_utilities.hpp"
 #include "maths_defaults.hpp"
 #include "blaze_config.hpp"
+#include "binary_io.hpp"
 
 
 /**
@@ -155,13 +156,18 @@ class Node {
             update_dofs_numbers();
         }
         int get_nz_i() {return nz_i;}
+        /**
+         * @brief Set the lumped \ref mass of the node which is applied to its translational DoFs in explicit dynamic analysis.
+         */
+        void set_mass(real new_mass) {mass = new_mass;}
+        real get_mass() const {return mass;}
         void  set_z(real z) { coordinates[2] = z;}
 
         void set_id(unsigned new_id) { id = new_id; }
         void increment_id(unsigned id_increment) { id += id_increment; }
-        void set_parent_rank(int parent_rank, int calling_rank) 
+        void set_parent_rank(int owning_rank, int calling_rank) 
         {
-            parent_rank = parent_rank;
+            parent_rank = owning_rank;
             on_parent_rank = (parent_rank == calling_rank);
         }
         int get_parent_rank() const {return parent_rank;}
@@ -355,6 +361,63 @@ class Node {
             nodal_loads = {0., 0., 0., 0., 0., 0.};
             loaded_dofs.clear();
         }
+
+        /**
+         * @brief writes the node ID and the current \ref nodal_loads, which are accumulated load step by load step.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary(out, id);
+            write_binary(out, nodal_loads);
+        }
+
+        /**
+         * @brief restores the \ref nodal_loads written by \ref write_checkpoint. Exits if they were written by a different node.
+         */
+        void read_checkpoint(std::istream& in)
+        {
+            unsigned checkpoint_id;
+            read_binary(in, checkpoint_id);
+            if (checkpoint_id != id)
+            {
+                std::cout << "Node::read_checkpoint: node " << id << " was given the checkpoint of node " << checkpoint_id << "." << std::endl;
+                exit(1);
+            }
+            read_binary(in, nodal_loads);
+        }
+        /**
+         * @brief writes what the mesh setup decides about the node: its IDs, coordinates, parent rank, restrained DoFs, and \ref nz_i.
+         */
+        void write_setup_snapshot(std::ostream& out) const
+        {
+            write_binary(out, id);
+            write_binary(out, record_id);
+            write_binary(out, std::array<real, 3>{coordinates[0], coordinates[1], coordinates[2]});
+            write_binary(out, parent_rank);
+            write_binary(out, nz_i);
+            write_binary_span<int>(out, std::vector<int>(inactive_dofs.begin(), inactive_dofs.end()));
+        }
+
+        /**
+         * @brief restores a node written by \ref write_setup_snapshot into a default-constructed node living on \p calling_rank.
+         */
+        void read_setup_snapshot(std::istream& in, int calling_rank)
+        {
+            std::array<real, 3> xyz;
+            int snapshot_parent_rank, snapshot_nz_i;
+            std::vector<int> snapshot_inactive_dofs;
+            read_binary(in, id);
+            read_binary(in, record_id);
+            read_binary(in, xyz);
+            read_binary(in, snapshot_parent_rank);
+            read_binary(in, snapshot_nz_i);
+            read_binary_vector(in, snapshot_inactive_dofs);
+            coordinates = coords(xyz[0], xyz[1], xyz[2]);
+            set_parent_rank(snapshot_parent_rank, calling_rank);
+            fix_dofs(snapshot_inactive_dofs);
+            set_nz_i(snapshot_nz_i);
+        }
+
         /**
          * @brief converts the \ref nodal_loads array into a std vector of triplets to be collected by the assembler.
          * 
@@ -383,7 +446,7 @@ class Node {
          * @brief returns the \ref global_nodal_loads_triplets vector.
          * 
          */
-        std::vector<spnz> get_load_triplets() {return global_nodal_loads_triplets;}
+        const std::vector<spnz>& get_load_triplets() const {return global_nodal_loads_triplets;}
 
         /**
          * @brief inserts the contents of \ref global_nodal_loads_triplets into the end of global_load_triplets_vector used to construct \f$\boldsymbol{P}\f$. Used to reduce copying during assembly, still basically a getter function.
@@ -11,17 +11,25 @@
 #include <Tpetra_Version.hpp>
 #include <Teuchos_FancyOStream.hpp>
 #include "MPIWrappers.hpp"
+#include "CommunicationTimer.hpp"
 
 
-using TpetraMultiVector = Tpetra::MultiVector<real, int, long long>;
-using node_type = TpetraMultiVector::node_type;
+/**
+ * @brief the Kokkos node the Tpetra objects run their local kernels on. When built with OpenMP and a Trilinos that instantiates the OpenMP node, the vectors and matrices of each rank are worked on by that rank's threads; otherwise Tpetra's default node is used.
+ */
+#if defined(OMP) && defined(HAVE_TPETRA_INST_OPENMP)
+using node_type = Tpetra::KokkosCompat::KokkosOpenMPWrapperNode;
+#else
+using node_type = Tpetra::Map<>::node_type;
+#endif
+using TpetraMultiVector = Tpetra::MultiVector<real, int, long long, node_type>;
 using scalar_type = TpetraMultiVector::scalar_type;
 using local_ordinal_type = TpetraMultiVector::local_ordinal_type;
 using global_ordinal_type = TpetraMultiVector::global_ordinal_type;
 
-using TpetraCrsMatrix = Tpetra::CrsMatrix<scalar_type, local_ordinal_type, global_ordinal_type>;
-using TpetraCrsGraph = Tpetra::CrsGraph<local_ordinal_type, global_ordinal_type>;
-using TpetraMap = Tpetra::Map<local_ordinal_type, global_ordinal_type>;
+using TpetraCrsMatrix = Tpetra::CrsMatrix<scalar_type, local_ordinal_type, global_ordinal_type, node_type>;
+using TpetraCrsGraph = Tpetra::CrsGraph<local_ordinal_type, global_ordinal_type, node_type>;
+using TpetraMap = Tpetra::Map<local_ordinal_type, global_ordinal_type, node_type>;
 
 
 
@@ -143,19 +151,19 @@ void set_from_triplets(Teuchos::RCP<TpetraCrsMatrix> A, std::vector<spnz>& tripl
         // Replace existing values in CrsMatrix
         A->sumIntoGlobalValues(row, col_view, val_view);
     }
+    // sends the contributions to rows owned by other ranks.
+    CommunicationTimer communication("matrix_fill_complete");
     A->fillComplete();
 }
 
 /**
- * @brief initialises an existing graph with global indices coming from triplets calculated from the contribution of finite elements.
+ * @brief initialises an existing graph with the global column indices of each of its rows.
  * 
  * @param A_graph a Teuchos RCP to Tpetra::CrsGraph that will be used to initialise the stiffness matrix.
- * @param triplets a std::vector of triplets that will be used to update the graph indices - their values will be ignored we only care about their column indices.
+ * @param row_col_map the column indices of each global row; repeated indices are merged by the graph.
  */
-void initialise_from_triplets(Teuchos::RCP<TpetraCrsGraph> A_graph, std::vector<spnz>& triplets)
+void initialise_from_row_columns(Teuchos::RCP<TpetraCrsGraph> A_graph, const std::map<global_ordinal_type, std::vector<global_ordinal_type>>& row_col_map)
 {
-    auto row_col_map = map_triplets_to_row_column_positions(triplets);
-    // std::cout << "initialise_from_triplets: there are " << row_col_map.size() << " entries in glob_mesh.update_elements_states()." << std::endl;
     for (const auto& row_entry : row_col_map)
     {
         global_ordinal_type row = row_entry.first;
@@ -168,5 +176,18 @@ void initialise_from_triplets(Teuchos::RCP<TpetraCrsGraph> A_graph, std::vector<
     }
 }
 
+/**
+ * @brief initialises an existing graph with global indices coming from triplets calculated from the contribution of finite elements.
+ * 
+ * @param A_graph a Teuchos RCP to Tpetra::CrsGraph that will be used to initialise the stiffness matrix.
+ * @param triplets a std::vector of triplets that will be used to update the graph indices - their values will be ignored we only care about their column indices.
+ */
+void initialise_from_triplets(Teuchos::RCP<TpetraCrsGraph> A_graph, std::vector<spnz>& triplets)
+{
+    auto row_col_map = map_triplets_to_row_column_positions(triplets);
+    // std::cout << "initialise_from_triplets: there are " << row_col_map.size() << " entries in glob_mesh.update_elements_states()." << std::endl;
+    initialise_from_row_columns(A_graph, row_col_map);
+}
+
 #endif
 #endif
\ No newline at end of file
@@ -260,6 +260,14 @@ class Linear2DBeamElement : public BeamElementCommonInterface<BasicSection> {
         void update_state() 
         {
             get_U_from_nodes();
+            update_state_from_U();
+        }
+
+        /**
+         * @brief updates the element from the \ref global_ele_U already gathered by \ref get_U_from_nodes.
+         */
+        void update_state_from_U()
+        {
             // need to retrieve local displacement from the global displacement first of all.
             calc_d_from_U();
             // calculating element strain and stress states depends on local displacement d, even though B calculation currently does not.
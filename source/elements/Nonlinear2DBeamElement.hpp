@@ -311,6 +311,14 @@ class Nonlinear2DBeamElement : public BeamElementCommonInterface<BasicSection> {
         void update_state() 
         {
             get_U_from_nodes();
+            update_state_from_U();
+        }
+
+        /**
+         * @brief updates the element from the \ref global_ele_U already gathered by \ref get_U_from_nodes.
+         */
+        void update_state_from_U()
+        {
             // the corotational transformation actually really cares about the global displacements, so we need to update the global displacements first.
             transformation.update_state(global_ele_U);
             // need to retrieve local displacement from the global displacements, which in our case actually uses the transformation object as the relationship is nonlinear!
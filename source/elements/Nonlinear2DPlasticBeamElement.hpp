@@ -287,6 +287,53 @@ class Nonlinear2DPlasticBeamElement : public BeamElementCommonInterface<BeamColu
             }
         }
 
+        /**
+         * @brief writes the committed state of each section; see \ref BeamColumnFiberSection::write_checkpoint.
+         */
+        virtual void write_checkpoint(std::ostream& out) const override
+        {
+            for (auto& fibre_section: section)
+            {
+                fibre_section->write_checkpoint(out);
+            }
+        }
+
+        /**
+         * @brief restores the committed state of each section; see \ref BeamColumnFiberSection::read_checkpoint.
+         */
+        virtual void read_checkpoint(std::istream& in) override
+        {
+            state_evaluated = false;
+            for (auto& fibre_section: section)
+            {
+                fibre_section->read_checkpoint(in);
+            }
+        }
+
+        /**
+         * @brief Get the largest accumulated plastic strain of any fibre at any Gauss point; see \ref BeamColumnFiberSection::get_max_plastic_strain.
+         */
+        virtual real get_max_plastic_strain() const override
+        {
+            real max_plastic_strain = 0.0;
+            for (auto& fibre_section: section)
+            {
+                max_plastic_strain = std::max(max_plastic_strain, fibre_section->get_max_plastic_strain());
+            }
+            return max_plastic_strain;
+        }
+
+        /**
+         * @brief replaces each section with a copy made by the calling thread, so the section and its fibre states are allocated and first written by the thread that updates this element.
+         */
+        virtual void first_touch_storage() override
+        {
+            for (auto& fibre_section: section)
+            {
+                fibre_section = std::make_unique<BeamColumnFiberSection>(*fibre_section);
+            }
+        }
+
         /**
          * @brief calculates strains based on (4.b) and (4.c) from Izzuddin. This is done per Gauss point, which in this case is just at midpoint of element.
          */
@@ -353,6 +400,14 @@ class Nonlinear2DPlasticBeamElement : public BeamElementCommonInterface<BeamColu
         void update_state() 
         {
             get_U_from_nodes();
+            update_state_from_U();
+        }
+
+        /**
+         * @brief updates the element from the \ref global_ele_U already gathered by \ref get_U_from_nodes.
+         */
+        void update_state_from_U()
+        {
             // the corotational transformation actually really cares about the global displacements, so we need to update the global displacements first.
             transformation.update_state(global_ele_U);
             // need to retrieve local displacement from the global displacements, which in our case actually uses the transformation object as the relationship is nonlinear!
@@ -82,6 +82,8 @@ class BeamElementBaseClass : public ElementBaseClass {
         mat local_tangent_stiffness; /**< local element tangent stiffness matrix.*/
         mat elem_global_stiffness; /**< the global contribution of the element - as in, tangent stiffness after transform via \f$ \boldsymbol{K}_t^e = \boldsymbol{T}^T \boldsymbol{k}_t \boldsymbol{T}\f$*/
         std::vector<spnz> global_stiffness_triplets; /**< the global contributions of the element to the global stiffness - made as sparse matrix contributions that would be gatehred to create the global sparse matrix.*/
+        vec evaluated_ele_U; /**< \ref global_ele_U at the last evaluation by \ref update_state_if_changed.*/
+        bool state_evaluated = false; /**< whether the state and triplets correspond to \ref evaluated_ele_U; cleared whenever they may no longer do.*/
         //@}
         
 
@@ -239,6 +241,10 @@ class BeamElementBaseClass : public ElementBaseClass {
          * @warning calculates \f$\boldsymbol{B}\f$ based on mid-length of the beam not Gauss points.
          */
         virtual void update_state() = 0;
+        /**
+         * @brief continues \ref update_state from the \ref global_ele_U already gathered by \ref get_U_from_nodes.
+         */
+        virtual void update_state_from_U() = 0;
 
 
     //@}
@@ -397,8 +403,9 @@ class BeamElementBaseClass : public ElementBaseClass {
          * @brief inserts the contents of \ref global_stiffness_triplets into the end of global_triplets_vector. Used to reduce copying during assembly, still basically a getter function.
          * 
          * @param global_triplets_vector The container for the triplets that are used for assembling the global stiffness matrix \f$ \boldsymbol{K}\f$ from element contributions.
+         * @param upper_triangle_only if true, the triplets below the diagonal of \f$ \boldsymbol{K}\f$ are skipped, as needed for symmetric storage.
          */
-        virtual void insert_global_stiffness_triplets(std::vector<spnz>& global_triplets_vector) = 0;
+        virtual void insert_global_stiffness_triplets(std::vector<spnz>& global_triplets_vector, bool upper_triangle_only = false) = 0;
         virtual mat get_N() const = 0;
         virtual mat get_B() const = 0;
         virtual mat get_T() = 0;
@@ -74,6 +74,42 @@ class BeamElementCommonInterface : public BeamElementBaseClass<BeamSectionClass>
          * @brief updates the starting state of the section after solution convergence. Please see Bhatti's Advanced Topics in Finite Element Analysis of Structures for more on this. Does nothing for all Elastic elements.
          */
         virtual void update_section_starting_state() override {};
+
+        /**
+         * @brief writes the committed section state. Does nothing for all Elastic elements, whose state follows from the nodal displacements.
+         */
+        virtual void write_checkpoint(std::ostream&) const override {}
+
+        /**
+         * @brief restores the committed section state. Does nothing for all Elastic elements.
+         */
+        virtual void read_checkpoint(std::istream&) override {}
+
+        /**
+         * @brief does nothing for all Elastic elements, whose storage is held inside the element object.
+         */
+        virtual void first_touch_storage() override {};
+
+        /**
+         * @brief re-evaluates the element with \ref update_state_from_U and \ref calc_global_stiffness_triplets only if \ref global_ele_U moved by more than \p tolerance since the last evaluation.
+         * @details with a zero tolerance the skipped element would have produced bit-identical contributions. A positive tolerance trades the accuracy of \f$\boldsymbol{R}\f$ for fewer evaluations in regions that barely move.
+         * 
+         * @param tolerance largest change in any element displacement for which the cached state is kept; negative to always re-evaluate.
+         * @return true if the element was re-evaluated.
+         */
+        virtual bool update_state_if_changed(real tolerance) override
+        {
+            this->get_U_from_nodes();
+            if (tolerance >= 0.0 && this->state_evaluated && (this->global_ele_U - this->evaluated_ele_U).cwiseAbs().maxCoeff() <= tolerance)
+            {
+                return false;
+            }
+            this->update_state_from_U(); // global_ele_U was gathered above.
+            this->calc_global_stiffness_triplets();
+            this->evaluated_ele_U = this->global_ele_U;
+            this->state_evaluated = true;
+            return true;
+        }
     //@}
 
     /**
@@ -200,6 +236,74 @@ class BeamElementCommonInterface : public BeamElementBaseClass<BeamSectionClass>
                 this->global_stiffness_triplets.push_back(spnz(kmap[2], kmap[3], val));
             }
         }
+
+        /**
+         * @brief adds \f$\boldsymbol{K}^e\boldsymbol{v}\f$ to the global product using \ref stiffness_map to gather from \f$\boldsymbol{v}\f$ and scatter to \f$\boldsymbol{K}\boldsymbol{v}\f$.
+         * 
+         * @param v the global vector being multiplied by the stiffness.
+         * @param Kv the global product to which the element contribution is added.
+         */
+        virtual void add_stiffness_product(const vec& v, vec& Kv) override
+        {
+            for (auto& kmap: this->stiffness_map)
+            {
+                Kv(kmap[2]) += this->elem_global_stiffness(kmap[0], kmap[1])*v(kmap[3]);
+            }
+        }
+
+        /**
+         * @brief adds the diagonal entries of \ref elem_global_stiffness to the global stiffness diagonal using \ref stiffness_map.
+         * 
+         * @param diagonal the global diagonal to which the element contribution is added.
+         */
+        virtual void add_stiffness_diagonal(vec& diagonal) override
+        {
+            for (auto& kmap: this->stiffness_map)
+            {
+                if (kmap[2] == kmap[3])
+                {
+                    diagonal(kmap[2]) += this->elem_global_stiffness(kmap[0], kmap[1]);
+                }
+            }
+        }
+
+        /**
+         * @brief adds \f$|\boldsymbol{K}^e|\boldsymbol{v}\f$ to the global product using \ref stiffness_map.
+         * 
+         * @param v the global vector being multiplied by the absolute stiffness.
+         * @param Kv the global product to which the element contribution is added.
+         */
+        virtual void add_abs_stiffness_product(const vec& v, vec& Kv) override
+        {
+            for (auto& kmap: this->stiffness_map)
+            {
+                Kv(kmap[2]) += std::abs(this->elem_global_stiffness(kmap[0], kmap[1]))*v(kmap[3]);
+            }
+        }
+
+        /**
+         * @brief adds the HRZ lumped mass of the beam to the global mass vector using \ref resistance_map.
+         * @details each node receives \f$ m/2 \f$ on its translational DoFs (0, 2, 4) and \f$ mL^2/78 \f$ on its rotational DoFs (1, 3, 5), where \f$ m = \rho A L\f$.
+         * 
+         * @param density mass density of the element material.
+         * @param M the lumped mass vector to which the element contribution is added.
+         * @param first_row the global DoF number of the first entry of \p M.
+         */
+        virtual void add_lumped_mass(real density, vec& M, int first_row) override
+        {
+            real length = this->get_L();
+            real element_mass = density*(this->section[0]->get_A())*length;
+            for (std::pair<int, int> resistance_maplet : this->resistance_map)
+            {
+                int local_dof = resistance_maplet.first % 6;
+                if (local_dof % 2 == 0)
+                {
+                    M(resistance_maplet.second - first_row) += 0.5*element_mass;
+                } else {
+                    M(resistance_maplet.second - first_row) += element_mass*length*length/78.0;
+                }
+            }
+        }
         
         /**
          * @brief populates \ref stiffness_map considering active and inactive DOFs for each node of the element. Uses the position vectors of the element to do this. Does not collect row-contributions from interface nodes i.e. those not on their parent rank.
@@ -209,6 +313,7 @@ class BeamElementCommonInterface : public BeamElementBaseClass<BeamSectionClass>
          */
         virtual void map_stiffness() override
         {
+            this->state_evaluated = false; // the cached triplets were mapped with the old positions.
             std::vector<int> local_position_vector_rows;
             std::vector<int> local_position_vector_columns;
             std::vector<int> position_vector_rows;
@@ -330,6 +435,18 @@ class BeamElementCommonInterface : public BeamElementBaseClass<BeamSectionClass>
         virtual int get_nnodes() const override {return this->nnodes;}
         virtual std::string get_elem_type() const override {return this->elem_type;}
         virtual unsigned get_id() const override {return this->id;}
+        virtual std::vector<unsigned> get_node_ids() const override
+        {
+            std::vector<unsigned> node_ids;
+            node_ids.reserve(this->nodes.size());
+            for (auto& node : this->nodes)
+                node_ids.push_back(node->get_id());
+            return node_ids;
+        }
+        /**
+         * @brief returns zero for all Elastic elements, which have no plastic strain.
+         */
+        virtual real get_max_plastic_strain() const override {return 0.0;}
 
         virtual vec get_global_ele_U() const override {return this->global_ele_U;}
         virtual vec get_local_d() const override {return this->local_d;}
@@ -358,9 +475,19 @@ class BeamElementCommonInterface : public BeamElementBaseClass<BeamSectionClass>
          * @brief inserts the contents of \ref global_stiffness_triplets into the end of global_triplets_vector. Used to reduce copying during assembly, still basically a getter function.
          * 
          * @param global_triplets_vector The container for the triplets that are used for assembling the global stiffness matrix \f$ \boldsymbol{K}\f$ from element contributions.
+         * @param upper_triangle_only if true, the triplets below the diagonal of \f$ \boldsymbol{K}\f$ are skipped, as needed for symmetric storage.
          */
-        virtual void insert_global_stiffness_triplets(std::vector<spnz>& global_triplets_vector) override {
-            global_triplets_vector.insert(global_triplets_vector.end(), this->global_stiffness_triplets.begin(), this->global_stiffness_triplets.end());
+        virtual void insert_global_stiffness_triplets(std::vector<spnz>& global_triplets_vector, bool upper_triangle_only = false) override {
+            if (!upper_triangle_only)
+            {
+                global_triplets_vector.insert(global_triplets_vector.end(), this->global_stiffness_triplets.begin(), this->global_stiffness_triplets.end());
+                return;
+            }
+            for (const spnz& triplet : this->global_stiffness_triplets)
+            {
+                if (triplet.row() <= triplet.col())
+                    global_triplets_vector.push_back(triplet);
+            }
         }
         virtual mat get_N() const override {return this->N[0];}
         virtual mat get_B() const override {return this->B[0];}
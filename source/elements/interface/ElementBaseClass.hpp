@@ -5,6 +5,8 @@
  */
 #ifndef ELEMENT_BASE_CLASS_HPP
 #define ELEMENT_BASE_CLASS_HPP
+#include <iostream>
+#include <vector>
 #include "maths_defaults.hpp"
 class ElementBaseClass 
 {
@@ -12,7 +14,26 @@ class ElementBaseClass
         virtual void map_stiffness() = 0;
         virtual void calc_global_stiffness_triplets() = 0;
         virtual void update_state() = 0;
+        /**
+         * @brief gathers the element displacements and re-evaluates the state and stiffness triplets only if they moved since the last evaluation.
+         * 
+         * @param tolerance largest change in any element displacement for which the cached state is kept; negative to always re-evaluate.
+         * @return true if the element was re-evaluated, false if its cached contributions were kept.
+         */
+        virtual bool update_state_if_changed(real tolerance) = 0;
         virtual void update_section_starting_state() = 0;
+        /**
+         * @brief writes the committed state of the element that cannot be recovered from the nodal displacements, i.e. its section history.
+         */
+        virtual void write_checkpoint(std::ostream& out) const = 0;
+        /**
+         * @brief restores a committed state written by \ref write_checkpoint.
+         */
+        virtual void read_checkpoint(std::istream& in) = 0;
+        /**
+         * @brief re-allocates the heap storage of the element from the calling thread, so that its pages are placed in the NUMA domain of that thread; see \ref GlobalMesh::first_touch_element_storage.
+         */
+        virtual void first_touch_storage() = 0;
         virtual void print_info() = 0;
         virtual void print_element_state(bool print_stresses = true, bool print_strains = false,
                                  bool print_nodal_disp = false, bool print_nodal_forces = false) = 0;
@@ -29,9 +50,47 @@ class ElementBaseClass
          * @brief inserts the contents of \ref global_stiffness_triplets into the end of global_triplets_vector. Used to reduce copying during assembly, still basically a getter function.
          * 
          * @param global_triplets_vector The container for the triplets that are used for assembling the global stiffness matrix \f$ \boldsymbol{K}\f$ from element contributions.
+         * @param upper_triangle_only if true, the triplets below the diagonal of \f$ \boldsymbol{K}\f$ are skipped, as needed for symmetric storage.
+         */
+        virtual void insert_global_stiffness_triplets(std::vector<spnz>& global_triplets_vector, bool upper_triangle_only = false) = 0;
+        /**
+         * @brief adds the element contribution \f$\boldsymbol{K}^e\boldsymbol{v}\f$ to a global product without assembling \f$\boldsymbol{K}\f$. Used by the \ref MatrixFreeSolver.
+         * 
+         * @param v the global vector being multiplied by the stiffness.
+         * @param Kv the global product to which the element contribution is added.
          */
-        virtual void insert_global_stiffness_triplets(std::vector<spnz>& global_triplets_vector) = 0;
+        virtual void add_stiffness_product(const vec& v, vec& Kv) = 0;
+        /**
+         * @brief adds the element contribution to the diagonal of the global stiffness matrix. Used for Jacobi preconditioning by the \ref MatrixFreeSolver.
+         * 
+         * @param diagonal the global diagonal to which the element contribution is added.
+         */
+        virtual void add_stiffness_diagonal(vec& diagonal) = 0;
+        /**
+         * @brief adds \f$|\boldsymbol{K}^e|\boldsymbol{v}\f$ (the product with the entry-wise absolute stiffness) to a global product. Used to bound the highest natural frequency for explicit dynamics.
+         * 
+         * @param v the global vector being multiplied by the absolute stiffness.
+         * @param Kv the global product to which the element contribution is added.
+         */
+        virtual void add_abs_stiffness_product(const vec& v, vec& Kv) = 0;
+        /**
+         * @brief adds the lumped mass of the element to the global diagonal mass vector.
+         * 
+         * @param density mass density of the element material.
+         * @param M the lumped mass vector to which the element contribution is added.
+         * @param first_row the global DoF number of the first entry of \p M; the first DoF of the rank in the distributed build, and zero otherwise.
+         */
+        virtual void add_lumped_mass(real density, vec& M, int first_row) = 0;
         virtual unsigned get_id() const = 0;
+        /**
+         * @brief Get the IDs of the nodes of the element, in order.
+         */
+        virtual std::vector<unsigned> get_node_ids() const = 0;
+        virtual vec get_local_f() const = 0;
+        /**
+         * @brief Get the largest accumulated plastic strain of any fibre of the element; zero for elastic elements.
+         */
+        virtual real get_max_plastic_strain() const = 0;
         
 
 };
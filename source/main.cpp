@@ -6,6 +6,7 @@
 #include <iomanip>
 #include <memory>
 #include <numeric>
+#include <fstream>
 #include "blaze_config.hpp"
 #include "maths_defaults.hpp"
 #include "ElementTypes.hpp"
@@ -14,6 +15,7 @@
 #include "BeamColumnFiberSection.hpp"
 #include "basic_utilities.hpp"
 #include "MPIWrappers.hpp"
+#include "ThreadPlacement.hpp"
 #include "tpetra_wrappers.hpp"
 #ifdef KOKKOS
     #include <Kokkos_Core.hpp>
@@ -85,6 +87,34 @@ struct InputOptions {
     int nsteps = 10;
     real tolerance = 1e-2;
     int max_iterations = 10;
+    bool symmetric_stiffness = false;
+    bool matrix_free = false;
+    int quasi_newton_updates = 0; // a positive value uses quasi-Newton iterations keeping this many BFGS pairs.
+    PredictorType predictor = NoPredictor;
+    bool compact_fibre_state = false; // stores the committed fibre states in single precision.
+    real element_skip_tolerance = 0.0; // elements that moved less than this keep their cached state; negative re-evaluates all elements.
+    int checkpoint_every = 0; // a positive value writes a checkpoint every this many load steps.
+    std::string checkpoint_prefix = "blaze_checkpoint";
+    int restart_step = -1; // a non-negative value continues from the checkpoint written after this many load steps.
+    int field_output_every = 0; // a positive value writes all nodal and element results every this many load steps.
+    std::string field_output_prefix = "blaze_field";
+    std::string write_setup_snapshot_prefix = ""; // a non-empty prefix writes a setup snapshot of each rank after initialisation.
+    std::string read_setup_snapshot_prefix = ""; // a non-empty prefix reads the mesh, restraints, and DoF numbering from a setup snapshot in stead of setting them up.
+    bool report_placement = false; // prints the CPU and NUMA domain of each thread of each rank.
+    std::string timers_file = ""; // a non-empty file name receives the duration of each timer on each rank as `rank,timer,duration` rows.
+
+    real dynamic_end_time = 0.0; // a positive value runs an explicit dynamic analysis in stead of load control.
+    real load_ramp_time = 0.0;
+    real density = 7850;
+    real damping_alpha = 0.0;
+    int record_every = 100;
+    int check_stability_every = 100; // steps between re-estimates of the stable time step; zero to estimate it only at the start.
+    RecordingPolicy recording_policy = RecordEveryStep;
+    int recording_interval = 1; // steps between recorded rows for RecordEveryNSteps.
+    real recording_tolerance = 0.0; // change below which nothing is recorded for RecordOnChange.
+    std::string history_file_prefix = ""; // a non-empty prefix streams the recorded history of each rank to a file.
+    HistoryEncoding history_encoding = XorHistory;
+    real history_error_bound = 0.0; // largest absolute error in a recorded value for QuantisedHistory.
 
     ElementType element_type = LinearElastic;
     BasicSection basic_sect;
@@ -176,6 +206,60 @@ InputOptions parse_input(int argc, char* argv[]) {
             opts.tolerance = std::stod(argv[++i]);
         } else if (arg == "--max_iterations" && i + 1 < argc) {
             opts.max_iterations = std::stoi(argv[++i]);
+        } else if (arg == "--symmetric_stiffness" && i + 1 < argc) {
+            opts.symmetric_stiffness = std::stoi(argv[++i]);
+        } else if (arg == "--matrix_free" && i + 1 < argc) {
+            opts.matrix_free = std::stoi(argv[++i]);
+        } else if (arg == "--quasi_newton" && i + 1 < argc) {
+            opts.quasi_newton_updates = std::stoi(argv[++i]);
+        } else if (arg == "--predictor" && i + 1 < argc) {
+            opts.predictor = static_cast<PredictorType>(std::stoi(argv[++i]));
+        } else if (arg == "--compact_fibre_state" && i + 1 < argc) {
+            opts.compact_fibre_state = std::stoi(argv[++i]);
+        } else if (arg == "--element_skip_tolerance" && i + 1 < argc) {
+            opts.element_skip_tolerance = std::stod(argv[++i]);
+        } else if (arg == "--checkpoint_every" && i + 1 < argc) {
+            opts.checkpoint_every = std::stoi(argv[++i]);
+        } else if (arg == "--checkpoint_prefix" && i + 1 < argc) {
+            opts.checkpoint_prefix = argv[++i];
+        } else if (arg == "--field_output_every" && i + 1 < argc) {
+            opts.field_output_every = std::stoi(argv[++i]);
+        } else if (arg == "--field_output_prefix" && i + 1 < argc) {
+            opts.field_output_prefix = argv[++i];
+        } else if (arg == "--restart_step" && i + 1 < argc) {
+            opts.restart_step = std::stoi(argv[++i]);
+        } else if (arg == "--timers_file" && i + 1 < argc) {
+            opts.timers_file = argv[++i];
+        } else if (arg == "--report_placement" && i + 1 < argc) {
+            opts.report_placement = std::stoi(argv[++i]);
+        } else if (arg == "--dynamic_end_time" && i + 1 < argc) {
+            opts.dynamic_end_time = std::stod(argv[++i]);
+        } else if (arg == "--load_ramp_time" && i + 1 < argc) {
+            opts.load_ramp_time = std::stod(argv[++i]);
+        } else if (arg == "--density" && i + 1 < argc) {
+            opts.density = std::stod(argv[++i]);
+        } else if (arg == "--damping_alpha" && i + 1 < argc) {
+            opts.damping_alpha = std::stod(argv[++i]);
+        } else if (arg == "--recording_policy" && i + 1 < argc) {
+            opts.recording_policy = static_cast<RecordingPolicy>(std::stoi(argv[++i]));
+        } else if (arg == "--recording_interval" && i + 1 < argc) {
+            opts.recording_interval = std::stoi(argv[++i]);
+        } else if (arg == "--recording_tolerance" && i + 1 < argc) {
+            opts.recording_tolerance = std::stod(argv[++i]);
+        } else if (arg == "--history_file_prefix" && i + 1 < argc) {
+            opts.history_file_prefix = argv[++i];
+        } else if (arg == "--history_encoding" && i + 1 < argc) {
+            opts.history_encoding = static_cast<HistoryEncoding>(std::stoi(argv[++i]));
+        } else if (arg == "--history_error_bound" && i + 1 < argc) {
+            opts.history_error_bound = std::stod(argv[++i]);
+        } else if (arg == "--write_setup_snapshot" && i + 1 < argc) {
+            opts.write_setup_snapshot_prefix = argv[++i];
+        } else if (arg == "--read_setup_snapshot" && i + 1 < argc) {
+            opts.read_setup_snapshot_prefix = argv[++i];
+        } else if (arg == "--record_every" && i + 1 < argc) {
+            opts.record_every = std::stoi(argv[++i]);
+        } else if (arg == "--check_stability_every" && i + 1 < argc) {
+            opts.check_stability_every = std::stoi(argv[++i]);
         } else if (arg == "--tf" && i + 1 < argc) {
             opts.tf = std::stod(argv[++i]);
         } else if (arg == "--tw" && i + 1 < argc) {
@@ -204,6 +288,7 @@ int main (int argc, char* argv[]) {
     #endif
     
     #ifdef WITH_MPI
+    ThreadedMPIGuard mpi_guard(argc, argv); // threads may run inside each rank, so MPI is initialised before Tpetra with MPI_THREAD_FUNNELED.
     Tpetra::ScopeGuard tpetraScope (&argc, &argv);
     #endif
     {
@@ -222,6 +307,8 @@ int main (int argc, char* argv[]) {
     time_keeper.add_timers(timers_names);
     time_keeper.start_timer("all");
     InputOptions input_options = parse_input(argc, argv);
+    if (input_options.report_placement)
+        report_thread_placement(rank);
     time_keeper.start_timer("mesh_setup");
     // material information
     ElasticPlasticMaterial steel = ElasticPlasticMaterial(input_options.youngs_modulus, input_options.yield_strength, input_options.hardening_ratio*input_options.youngs_modulus);
@@ -230,11 +317,20 @@ int main (int argc, char* argv[]) {
     real moment_of_inertia = input_options.tw*pow(input_options.h - 2*input_options.tf, 3)/12 + 2*input_options.b*pow(input_options.tf,3)/12 + 2*(input_options.tf*input_options.b)*pow(0.5*input_options.h - 0.5*input_options.tf, 2); // m^4 
     real section_area = 2*input_options.tf*input_options.b + (input_options.h - 2*input_options.tf)*input_options.tw;
     build_an_I_section(input_options.fibre_sect, steel, 0.0, input_options.tf, input_options.b, input_options.tw, input_options.h, input_options.flange_divisions, input_options.web_divisions);
+    input_options.fibre_sect.set_compact_state_storage(input_options.compact_fibre_state);
     input_options.basic_sect = BasicSection(input_options.youngs_modulus, section_area, moment_of_inertia);
     
     
     // Definition of the mesh:
-    if (input_options.element_type == NonlinearPlastic)
+    bool from_setup_snapshot = !input_options.read_setup_snapshot_prefix.empty();
+    if (from_setup_snapshot)
+    {
+        if (input_options.element_type == NonlinearPlastic)
+            model.create_mesh_from_setup_snapshot(input_options.read_setup_snapshot_prefix, input_options.element_type, input_options.fibre_sect);
+        else
+            model.create_mesh_from_setup_snapshot(input_options.read_setup_snapshot_prefix, input_options.element_type, input_options.basic_sect);
+    }
+    else if (input_options.element_type == NonlinearPlastic)
     {
         model.create_distributed_frame_mesh(input_options.nbays, input_options.nfloors, input_options.beam_length, input_options.floor_height, input_options.beam_divisions, input_options.column_divisions, input_options.element_type, input_options.fibre_sect);
     }
@@ -255,17 +351,20 @@ int main (int argc, char* argv[]) {
     }
     time_keeper.start_timer("bc_load_records");
     
-    // Boundary conditions
-    NodalRestraint column_bases;
-    column_bases.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4, 5}); // fixed support
-    column_bases.assign_distributed_nodes_by_record_id(the_frame.get_column_bases(), model.glob_mesh);
+    // Boundary conditions; a setup snapshot already has them applied.
+    if (!from_setup_snapshot)
+    {
+        NodalRestraint column_bases;
+        column_bases.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4, 5}); // fixed support
+        column_bases.assign_distributed_nodes_by_record_id(the_frame.get_column_bases(), model.glob_mesh);
 
-    NodalRestraint out_of_plane_restraint;  
-    out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
-    out_of_plane_restraint.assign_distributed_nodes_by_record_id(the_frame.get_out_of_plane_nodes(), model.glob_mesh);
+        NodalRestraint out_of_plane_restraint;  
+        out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
+        out_of_plane_restraint.assign_distributed_nodes_by_record_id(the_frame.get_out_of_plane_nodes(), model.glob_mesh);
 
-    model.restraints.push_back(column_bases);
-    model.restraints.push_back(out_of_plane_restraint);
+        model.restraints.push_back(column_bases);
+        model.restraints.push_back(out_of_plane_restraint);
+    }
 
     // Loads
     std::set<unsigned> loaded_nodes = the_frame.get_all_beam_line_node_ids(false); 
@@ -274,22 +373,57 @@ int main (int argc, char* argv[]) {
 
     // Records
     model.scribe.track_distributed_nodes_by_id(rank, loaded_nodes_v, std::set<int>{2}, model.glob_mesh);
+    model.set_recording_policy(input_options.recording_policy, input_options.recording_interval, input_options.recording_tolerance);
+    if (!input_options.history_file_prefix.empty())
+        model.set_history_output(input_options.history_file_prefix, input_options.history_encoding, input_options.history_error_bound);
     time_keeper.stop_timer("bc_load_records");
     
     // Load and BC initilaisation
     time_keeper.start_timer("initialisation");
+    model.set_matrix_free(input_options.matrix_free);
     model.initialise_restraints_n_loads();
+    model.set_element_skip_tolerance(input_options.element_skip_tolerance);
+    if (!input_options.write_setup_snapshot_prefix.empty())
+        model.write_setup_snapshot(input_options.write_setup_snapshot_prefix);
 
     // initialise solution parameters 
-    model.initialise_solution_parameters(input_options.max_LF, input_options.nsteps, input_options.tolerance, input_options.max_iterations);
+    bool dynamic = input_options.dynamic_end_time > 0.0;
+    if (dynamic)
+    {
+        model.initialise_dynamic_parameters(input_options.max_LF, input_options.dynamic_end_time, input_options.load_ramp_time, input_options.density, input_options.damping_alpha, 0.0, input_options.record_every, input_options.check_stability_every);
+    } else {
+        model.set_symmetric_stiffness(input_options.symmetric_stiffness);
+        model.set_quasi_newton(input_options.quasi_newton_updates > 0, input_options.quasi_newton_updates);
+        model.set_predictor(input_options.predictor);
+        model.initialise_solution_parameters(input_options.max_LF, input_options.nsteps, input_options.tolerance, input_options.max_iterations);
+        model.set_checkpointing(input_options.checkpoint_every, input_options.checkpoint_prefix);
+        model.set_field_output(input_options.field_output_every, input_options.field_output_prefix);
+        if (input_options.restart_step >= 0)
+            model.restart_from_checkpoint(input_options.checkpoint_prefix, input_options.restart_step);
+    }
     time_keeper.stop_timer("initialisation");
     
     // Solution
     time_keeper.start_timer("solution");
-    model.solve(1);
+    if (dynamic)
+        model.solve_dynamic(input_options.record_every);
+    else
+        model.solve(1);
     time_keeper.stop_timer("solution");
     time_keeper.stop_timer("all");
     // timers outputs
+    std::vector<std::string> solution_timers_names = {"U_to_nodes_mapping", 
+                    "element_state_update",
+                    "assembly",
+                    "material_state_update",
+                    "result_recording"};
+    if (dynamic)
+    {
+        solution_timers_names.push_back("time_integration");
+    } else {
+        solution_timers_names.push_back("convergence_check");
+        solution_timers_names.push_back("dU_calculation");
+    }
     #ifdef WITH_MPI
     time_keeper.log_parallel_timers(timers_names);
     model.log_parallel_timers({"U_to_nodes_mapping", 
@@ -300,6 +434,27 @@ int main (int argc, char* argv[]) {
                     "material_state_update",
                     "result_recording",
                     "all"});
+    // splits each phase into compute and communication to tell partitioning from communication problems.
+    time_keeper.log_phase_balance(timers_names);
+    model.log_phase_balance(solution_timers_names, dynamic);
     #endif 
+    if (!dynamic)
+        model.log_thread_durations();
+    if (!input_options.timers_file.empty())
+    {
+        time_keeper.collect_rank_durations(timers_names, true);
+        model.collect_solution_timers(solution_timers_names, dynamic);
+        if (rank == 0)
+        {
+            std::ofstream timers_out(input_options.timers_file);
+            if (!timers_out)
+            {
+                std::cout << "Could not open timers file " << input_options.timers_file << std::endl;
+                exit(1);
+            }
+            time_keeper.write_rank_durations_csv(timers_out, timers_names);
+            model.write_solution_timers_csv(timers_out, solution_timers_names, dynamic, false);
+        }
+    }
     }
 }
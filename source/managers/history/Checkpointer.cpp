@@ -0,0 +1 @@
+#include "Checkpointer.hpp"
@@ -0,0 +1,97 @@
+/**
+ * @file Checkpointer.hpp
+ * @brief defines the \ref Checkpointer class which decides when checkpoints are due and writes them to file in the background.
+ */
+
+#ifndef CHECKPOINTER_HPP
+#define CHECKPOINTER_HPP
+
+#include <string>
+#include <future>
+#include <fstream>
+#include <cstdio>
+#include <iostream>
+
+/**
+ * @brief manages the per-rank binary checkpoint files of an analysis.
+ * @details the state of the analysis is serialised by the \ref SolutionProcedure into an in-memory buffer, which is cheap compared to a load step. The buffer is then written to
+ * `<prefix>_step<N>_rank<r>.bin` by a background task, so the analysis continues while the file is written. The file is first written under a temporary name and then renamed,
+ * so an interrupted write never leaves a truncated checkpoint behind. At most one write is in flight; a new write waits for the previous one. A failed write is reported, and the
+ * analysis stopped, by the main thread in \ref wait.
+ */
+class Checkpointer
+{
+    protected:
+        int interval = 0; /**< number of load steps between checkpoints; zero to disable checkpointing.*/
+        std::string prefix = "checkpoint"; /**< prefix of the checkpoint file names, including any directory.*/
+        int rank = 0; /**< rank whose state is written.*/
+        std::future<std::string> pending_write; /**< the write that is in flight, if any; holds the reason it failed, or nothing if it succeeded.*/
+
+    public:
+        Checkpointer() = default;
+        ~Checkpointer() {wait();}
+
+        /**
+         * @brief enables checkpointing every \p checkpoint_interval load steps.
+         * @param checkpoint_interval number of load steps between checkpoints; zero to disable checkpointing.
+         * @param file_prefix prefix of the checkpoint file names.
+         * @param checkpoint_rank rank whose state is written.
+         */
+        void set_checkpointing(int checkpoint_interval, std::string file_prefix, int checkpoint_rank)
+        {
+            interval = checkpoint_interval;
+            prefix = file_prefix;
+            rank = checkpoint_rank;
+        }
+
+        /**
+         * @brief Check if a checkpoint is due after \p completed_steps load steps.
+         */
+        bool is_due(int completed_steps) const {return interval > 0 && completed_steps % interval == 0;}
+
+        /**
+         * @brief Get the name of the checkpoint file of \p checkpoint_rank after \p completed_steps load steps.
+         */
+        static std::string get_file_name(std::string file_prefix, int completed_steps, int checkpoint_rank)
+        {
+            return file_prefix + "_step" + std::to_string(completed_steps) + "_rank" + std::to_string(checkpoint_rank) + ".bin";
+        }
+
+        /**
+         * @brief writes \p buffer as the checkpoint after \p completed_steps load steps in the background, after waiting for any earlier write.
+         */
+        void write_async(int completed_steps, std::string&& buffer)
+        {
+            wait();
+            std::string file_name = get_file_name(prefix, completed_steps, rank);
+            pending_write = std::async(std::launch::async, [file_name, data = std::move(buffer)]() -> std::string {
+                std::string temporary_name = file_name + ".tmp";
+                {
+                    std::ofstream file(temporary_name, std::ios::binary | std::ios::trunc);
+                    file.write(data.data(), data.size());
+                    if (!file)
+                        return "could not write checkpoint file " + temporary_name + ".";
+                }
+                if (std::rename(temporary_name.c_str(), file_name.c_str()) != 0)
+                    return "could not rename " + temporary_name + " to " + file_name + ".";
+                return std::string();
+            });
+        }
+
+        /**
+         * @brief blocks until the write in flight, if any, is on disk, and stops the analysis if it failed.
+         */
+        void wait()
+        {
+            if (!pending_write.valid())
+                return;
+            std::string error = pending_write.get();
+            if (!error.empty())
+            {
+                std::cout << "Checkpointer: rank " << rank << " " << error << std::endl;
+                exit(1);
+            }
+        }
+};
+
+#endif
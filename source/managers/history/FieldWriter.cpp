@@ -0,0 +1 @@
+#include "FieldWriter.hpp"
\ No newline at end of file
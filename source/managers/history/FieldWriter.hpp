@@ -0,0 +1,288 @@
+/**
+ * @file FieldWriter.hpp
+ * @brief defines the \ref FieldWriter class which writes full-field snapshots of the model to one shared binary file per snapshot, described by an XDMF file.
+ */
+
+#ifndef FIELD_WRITER_HPP
+#define FIELD_WRITER_HPP
+
+#include <array>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef WITH_MPI
+    #include <mpi.h>
+#endif
+#include "maths_defaults.hpp"
+#include "FieldSnapshot.hpp"
+
+/**
+ * @brief the arrays of a snapshot file, in the order they are stored.
+ */
+enum FieldSection {
+    FieldCoordinates = 0,
+    FieldTranslations,
+    FieldRotations,
+    FieldElementForces,
+    FieldPlasticStrains,
+    FieldNodeIds,
+    FieldElementIds,
+    FieldConnectivity,
+    NumFieldSections
+};
+
+/**
+ * @brief writes \ref FieldSnapshot objects to `<prefix>_step<N>.bin`, with an XDMF file `<prefix>.xdmf` that lets ParaView or VisIt read the snapshots as a time series.
+ * @details a snapshot file holds each global array of \ref FieldSection in turn, with no header, so that the XDMF file can point at each array directly. Each rank writes its own
+ * slice of every array at the position given by its node and element offsets. In the distributed build all ranks write to the same file with non-blocking collective MPI-IO,
+ * and without MPI the file is written by a background task. Either way \ref write_async returns once the write is started and the analysis continues; the snapshot is kept
+ * until the write completes, which is awaited before the next snapshot is written and by \ref wait. The XDMF file is rewritten by rank 0 after each snapshot. A failed write is reported, and the analysis stopped, by the calling thread in \ref wait.
+ */
+class FieldWriter
+{
+    protected:
+        int interval = 0; /**< number of load steps between snapshots; zero to disable full-field output.*/
+        std::string prefix = "blaze_field"; /**< prefix of the snapshot and XDMF file names, including any directory.*/
+        int rank = 0; /**< rank of the calling process.*/
+        FieldSnapshot pending_snapshot; /**< the snapshot being written; its arrays must outlive the write.*/
+        std::vector<std::pair<int, real>> written_steps; /**< load step and load factor of each snapshot written so far.*/
+        #ifdef WITH_MPI
+        MPI_File pending_file; /**< the shared file being written.*/
+        std::string pending_file_name; /**< name of \ref pending_file, for error messages.*/
+        std::vector<MPI_Request> pending_requests; /**< the writes in flight, one per \ref FieldSection.*/
+        #else
+        std::future<std::string> pending_write; /**< the write that is in flight, if any; holds the reason it failed, or nothing if it succeeded.*/
+        #endif
+
+        /**
+         * @brief a part of the calling rank's slice that is written to a snapshot file.
+         */
+        struct SliceWrite {
+            size_t file_offset; /**< byte position in the file.*/
+            const char* data;
+            size_t num_bytes;
+        };
+
+        #ifdef WITH_MPI
+        /**
+         * @brief stops the analysis if the MPI-IO call \p call_name returned \p error_code other than MPI_SUCCESS. File operations return their errors rather than aborting by default.
+         */
+        void check_mpi_io(int error_code, std::string call_name, std::string file_name) const
+        {
+            if (error_code == MPI_SUCCESS)
+                return;
+            char error_string[MPI_MAX_ERROR_STRING];
+            int length = 0;
+            MPI_Error_string(error_code, error_string, &length);
+            std::cout << "FieldWriter: rank " << rank << " " << call_name << " failed for field output file " << file_name << ": " << std::string(error_string, length) << std::endl;
+            exit(1);
+        }
+        #endif
+
+        /**
+         * @brief Get the byte position of each \ref FieldSection in a snapshot file holding \p snapshot, followed by the size of the file.
+         */
+        static std::array<size_t, NumFieldSections + 1> get_section_offsets(const FieldSnapshot& snapshot)
+        {
+            std::array<size_t, NumFieldSections> sizes;
+            sizes[FieldCoordinates] = 3*snapshot.num_nodes*sizeof(real);
+            sizes[FieldTranslations] = 3*snapshot.num_nodes*sizeof(real);
+            sizes[FieldRotations] = 3*snapshot.num_nodes*sizeof(real);
+            sizes[FieldElementForces] = snapshot.num_element_forces*snapshot.num_elements*sizeof(real);
+            sizes[FieldPlasticStrains] = snapshot.num_elements*sizeof(real);
+            sizes[FieldNodeIds] = snapshot.num_nodes*sizeof(std::uint32_t);
+            sizes[FieldElementIds] = snapshot.num_elements*sizeof(std::uint32_t);
+            sizes[FieldConnectivity] = 2*snapshot.num_elements*sizeof(std::uint32_t);
+            std::array<size_t, NumFieldSections + 1> offsets;
+            offsets[0] = 0;
+            for (int section = 0; section < NumFieldSections; ++section)
+                offsets[section + 1] = offsets[section] + sizes[section];
+            return offsets;
+        }
+
+        /**
+         * @brief Get the position and contents of this rank's slice of each \ref FieldSection of \p snapshot.
+         */
+        static std::array<SliceWrite, NumFieldSections> get_slice_writes(const FieldSnapshot& snapshot)
+        {
+            std::array<size_t, NumFieldSections + 1> offsets = get_section_offsets(snapshot);
+            auto slice = [&](FieldSection section, size_t first_entry, const auto& values) {
+                using T = typename std::decay_t<decltype(values)>::value_type;
+                return SliceWrite{offsets[section] + first_entry*sizeof(T), reinterpret_cast<const char*>(values.data()), values.size()*sizeof(T)};
+            };
+            std::array<SliceWrite, NumFieldSections> writes;
+            writes[FieldCoordinates] = slice(FieldCoordinates, 3*snapshot.node_offset, snapshot.coordinates);
+            writes[FieldTranslations] = slice(FieldTranslations, 3*snapshot.node_offset, snapshot.translations);
+            writes[FieldRotations] = slice(FieldRotations, 3*snapshot.node_offset, snapshot.rotations);
+            writes[FieldElementForces] = slice(FieldElementForces, snapshot.num_element_forces*snapshot.element_offset, snapshot.element_forces);
+            writes[FieldPlasticStrains] = slice(FieldPlasticStrains, snapshot.element_offset, snapshot.plastic_strains);
+            writes[FieldNodeIds] = slice(FieldNodeIds, snapshot.node_offset, snapshot.node_ids);
+            writes[FieldElementIds] = slice(FieldElementIds, snapshot.element_offset, snapshot.element_ids);
+            writes[FieldConnectivity] = slice(FieldConnectivity, 2*snapshot.element_offset, snapshot.connectivity);
+            return writes;
+        }
+
+        /**
+         * @brief writes an XDMF data item pointing at a \ref FieldSection of the snapshot file \p file_name.
+         */
+        static void write_xdmf_data_item(std::ostream& out, std::string file_name, size_t offset, size_t rows, size_t columns, bool is_real)
+        {
+            out << "          <DataItem Dimensions=\"" << rows;
+            if (columns > 1)
+                out << " " << columns;
+            out << "\" NumberType=\"" << (is_real ? "Float" : "UInt") << "\" Precision=\"" << (is_real ? sizeof(real) : sizeof(std::uint32_t))
+                << "\" Format=\"Binary\" Endian=\"Native\" Seek=\"" << offset << "\">" << file_name << "</DataItem>" << std::endl;
+        }
+
+        /**
+         * @brief rewrites `<prefix>.xdmf` as a temporal collection of all snapshots written so far, with the load factor as time.
+         */
+        void write_xdmf(const FieldSnapshot& snapshot) const
+        {
+            std::array<size_t, NumFieldSections + 1> offsets = get_section_offsets(snapshot);
+            std::ofstream out(prefix + ".xdmf", std::ios::trunc);
+            out << "<?xml version=\"1.0\" ?>" << std::endl;
+            out << "<Xdmf Version=\"3.0\">" << std::endl;
+            out << "  <Domain>" << std::endl;
+            out << "    <Grid Name=\"Blaze\" GridType=\"Collection\" CollectionType=\"Temporal\">" << std::endl;
+            for (auto& [step, load_factor] : written_steps)
+            {
+                // the data files are referred to relative to the XDMF file, which sits in the same directory.
+                std::string file_name = std::filesystem::path(get_file_name(prefix, step)).filename().string();
+                out << "      <Grid Name=\"step_" << step << "\" GridType=\"Uniform\">" << std::endl;
+                out << "        <Time Value=\"" << load_factor << "\"/>" << std::endl;
+                out << "        <Topology TopologyType=\"Polyline\" NodesPerElement=\"2\" NumberOfElements=\"" << snapshot.num_elements << "\">" << std::endl;
+                write_xdmf_data_item(out, file_name, offsets[FieldConnectivity], snapshot.num_elements, 2, false);
+                out << "        </Topology>" << std::endl;
+                out << "        <Geometry GeometryType=\"XYZ\">" << std::endl;
+                write_xdmf_data_item(out, file_name, offsets[FieldCoordinates], snapshot.num_nodes, 3, true);
+                out << "        </Geometry>" << std::endl;
+                auto write_attribute = [&](std::string name, std::string type, std::string centre, FieldSection section, size_t rows, size_t columns, bool is_real) {
+                    out << "        <Attribute Name=\"" << name << "\" AttributeType=\"" << type << "\" Center=\"" << centre << "\">" << std::endl;
+                    write_xdmf_data_item(out, file_name, offsets[section], rows, columns, is_real);
+                    out << "        </Attribute>" << std::endl;
+                };
+                write_attribute("translation", "Vector", "Node", FieldTranslations, snapshot.num_nodes, 3, true);
+                write_attribute("rotation", "Vector", "Node", FieldRotations, snapshot.num_nodes, 3, true);
+                write_attribute("node_id", "Scalar", "Node", FieldNodeIds, snapshot.num_nodes, 1, false);
+                write_attribute("element_forces", "Matrix", "Cell", FieldElementForces, snapshot.num_elements, snapshot.num_element_forces, true);
+                write_attribute("plastic_strain", "Scalar", "Cell", FieldPlasticStrains, snapshot.num_elements, 1, true);
+                write_attribute("element_id", "Scalar", "Cell", FieldElementIds, snapshot.num_elements, 1, false);
+                out << "      </Grid>" << std::endl;
+            }
+            out << "    </Grid>" << std::endl;
+            out << "  </Domain>" << std::endl;
+            out << "</Xdmf>" << std::endl;
+        }
+
+    public:
+        FieldWriter() = default;
+        ~FieldWriter() {wait();}
+
+        /**
+         * @brief enables full-field output every \p output_interval load steps.
+         * @param output_interval number of load steps between snapshots; zero to disable full-field output.
+         * @param file_prefix prefix of the snapshot and XDMF file names.
+         * @param output_rank rank of the calling process.
+         */
+        void set_field_output(int output_interval, std::string file_prefix, int output_rank)
+        {
+            interval = output_interval;
+            prefix = file_prefix;
+            rank = output_rank;
+        }
+
+        /**
+         * @brief Check if a snapshot is due after \p completed_steps load steps.
+         */
+        bool is_due(int completed_steps) const {return interval > 0 && completed_steps % interval == 0;}
+
+        /**
+         * @brief Get the name of the snapshot file after \p completed_steps load steps.
+         */
+        static std::string get_file_name(std::string file_prefix, int completed_steps)
+        {
+            return file_prefix + "_step" + std::to_string(completed_steps) + ".bin";
+        }
+
+        /**
+         * @brief starts writing \p snapshot to its file after waiting for any earlier write, and returns without waiting for it. Collective over all ranks in the distributed build.
+         */
+        void write_async(FieldSnapshot&& snapshot)
+        {
+            wait();
+            pending_snapshot = std::move(snapshot);
+            written_steps.push_back({pending_snapshot.step, pending_snapshot.load_factor});
+            std::string file_name = get_file_name(prefix, pending_snapshot.step);
+            std::array<SliceWrite, NumFieldSections> writes = get_slice_writes(pending_snapshot);
+            #ifdef WITH_MPI
+            pending_file_name = file_name;
+            check_mpi_io(MPI_File_open(MPI_COMM_WORLD, file_name.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &pending_file), "MPI_File_open", file_name);
+            check_mpi_io(MPI_File_set_size(pending_file, get_section_offsets(pending_snapshot)[NumFieldSections]), "MPI_File_set_size", file_name);
+            pending_requests.resize(NumFieldSections);
+            for (int section = 0; section < NumFieldSections; ++section)
+            {
+                if (writes[section].num_bytes > INT_MAX)
+                {
+                    std::cout << "FieldWriter: rank " << rank << " cannot write " << writes[section].num_bytes << " bytes in one MPI-IO call." << std::endl;
+                    exit(1);
+                }
+                check_mpi_io(MPI_File_iwrite_at_all(pending_file, writes[section].file_offset, writes[section].data, static_cast<int>(writes[section].num_bytes), MPI_BYTE, &pending_requests[section]),
+                             "MPI_File_iwrite_at_all", file_name);
+            }
+            #else
+            size_t file_size = get_section_offsets(pending_snapshot)[NumFieldSections];
+            pending_write = std::async(std::launch::async, [file_name, writes, file_size]() -> std::string {
+                std::ofstream file(file_name, std::ios::binary | std::ios::trunc);
+                for (auto& write : writes)
+                {
+                    file.seekp(write.file_offset);
+                    file.write(write.data, write.num_bytes);
+                }
+                if (!file || static_cast<size_t>(file.tellp()) != file_size)
+                    return "could not write field output file " + file_name + ".";
+                return std::string();
+            });
+            #endif
+            if (rank == 0)
+                write_xdmf(pending_snapshot);
+        }
+
+        /**
+         * @brief blocks until the write in flight, if any, is complete, and stops the analysis if it failed. Collective over all ranks in the distributed build.
+         */
+        void wait()
+        {
+            #ifdef WITH_MPI
+            if (!pending_requests.empty())
+            {
+                std::vector<MPI_Status> statuses(pending_requests.size());
+                int error_code = MPI_Waitall(pending_requests.size(), pending_requests.data(), statuses.data());
+                if (error_code == MPI_ERR_IN_STATUS)
+                {
+                    for (auto& status : statuses)
+                        if (status.MPI_ERROR != MPI_SUCCESS)
+                            error_code = status.MPI_ERROR;
+                }
+                pending_requests.clear();
+                check_mpi_io(error_code, "MPI_Waitall", pending_file_name);
+                check_mpi_io(MPI_File_close(&pending_file), "MPI_File_close", pending_file_name);
+            }
+            #else
+            if (!pending_write.valid())
+                return;
+            std::string error = pending_write.get();
+            if (!error.empty())
+            {
+                std::cout << "FieldWriter: rank " << rank << " " << error << std::endl;
+                exit(1);
+            }
+            #endif
+        }
+};
+
+#endif
@@ -0,0 +1 @@
+#include "HistoryWriter.hpp"
\ No newline at end of file
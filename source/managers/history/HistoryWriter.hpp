@@ -0,0 +1,414 @@
+/**
+ * @file HistoryWriter.hpp
+ * @brief defines the \ref HistoryWriter class which streams the recorded histories of a \ref Scribe to a file, and the encodings used to compress them.
+ */
+
+#ifndef HISTORY_WRITER_HPP
+#define HISTORY_WRITER_HPP
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "maths_defaults.hpp"
+#include "binary_io.hpp"
+
+constexpr std::array<char, 8> HISTORY_MAGIC = {'B', 'L', 'Z', 'H', 'I', 'S', 'T', '\0'}; /**< identifies Blaze history files.*/
+constexpr int HISTORY_VERSION = 1; /**< layout version of the history files.*/
+
+/**
+ * @brief an enum that defines how the values of a recorded history are encoded in a history file.
+ *
+ */
+enum HistoryEncoding {
+    RawHistory = 0, /**< the raw bytes of each value.*/
+    XorHistory = 1, /**< lossless: each value is XORed with its linear extrapolation from the previous two and only the meaningful bits are stored, as in Gorilla.*/
+    QuantisedHistory = 2 /**< lossy: each value is rounded to a multiple of twice the error bound and the second differences are stored as variable-length integers.*/
+};
+
+/**
+ * @brief appends bit fields, most significant bit first, to a byte buffer.
+ */
+class BitWriter
+{
+    protected:
+        std::string bytes;
+        int free_bits = 0; /**< unused low bits of the last byte.*/
+
+    public:
+        void write_bits(std::uint64_t value, int num_bits)
+        {
+            while (num_bits > 0)
+            {
+                if (free_bits == 0)
+                {
+                    bytes.push_back(0);
+                    free_bits = 8;
+                }
+                int num_written = std::min(num_bits, free_bits);
+                std::uint64_t chunk = (value >> (num_bits - num_written)) & ((std::uint64_t(1) << num_written) - 1);
+                bytes.back() = static_cast<char>(static_cast<std::uint8_t>(bytes.back()) | (chunk << (free_bits - num_written)));
+                free_bits -= num_written;
+                num_bits -= num_written;
+            }
+        }
+        std::string& get_bytes() {return bytes;}
+};
+
+/**
+ * @brief reads bit fields written by a \ref BitWriter.
+ */
+class BitReader
+{
+    protected:
+        std::span<const char> bytes;
+        size_t bit_position = 0;
+
+    public:
+        BitReader(std::span<const char> encoded) : bytes(encoded) {}
+
+        std::uint64_t read_bits(int num_bits)
+        {
+            std::uint64_t value = 0;
+            while (num_bits > 0)
+            {
+                size_t byte = bit_position/8;
+                if (byte >= bytes.size())
+                {
+                    std::cout << "BitReader: unexpected end of encoded history." << std::endl;
+                    exit(1);
+                }
+                int bit_in_byte = bit_position%8;
+                int num_read = std::min(num_bits, 8 - bit_in_byte);
+                std::uint64_t chunk = (static_cast<std::uint8_t>(bytes[byte]) >> (8 - bit_in_byte - num_read)) & ((1u << num_read) - 1);
+                value = (value << num_read) | chunk;
+                bit_position += num_read;
+                num_bits -= num_read;
+            }
+            return value;
+        }
+};
+
+/**
+ * @brief appends an unsigned integer in 7-bit groups, with the high bit of each byte marking that more follow.
+ */
+inline void write_varint(std::string& out, std::uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief reads an integer written by \ref write_varint starting at \p position, and advances \p position past it.
+ */
+inline std::uint64_t read_varint(std::span<const char> in, size_t& position)
+{
+    std::uint64_t value = 0;
+    for (int shift = 0; ; shift += 7)
+    {
+        if (position >= in.size())
+        {
+            std::cout << "read_varint: unexpected end of encoded history." << std::endl;
+            exit(1);
+        }
+        std::uint8_t byte = static_cast<std::uint8_t>(in[position++]);
+        value |= std::uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+inline std::uint64_t zigzag_encode(std::int64_t value) {return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);}
+inline std::int64_t zigzag_decode(std::uint64_t value) {return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);}
+
+/**
+ * @brief Get the value that \ref XorHistory and \ref QuantisedHistory predict for entry \p i, extrapolating linearly from the previous two.
+ */
+template <typename T>
+T predict_history_value(const std::vector<T>& values, size_t i)
+{
+    if (i == 0)
+        return T(0);
+    if (i == 1)
+        return values[0];
+    return values[i-1] + (values[i-1] - values[i-2]);
+}
+
+/**
+ * @brief encodes \p values with \p encoding.
+ *
+ * @param error_bound largest absolute error of \ref QuantisedHistory; ignored by the lossless encodings.
+ */
+inline std::string encode_history(const std::vector<real>& values, HistoryEncoding encoding, real error_bound)
+{
+    std::string out;
+    switch (encoding)
+    {
+    case RawHistory:
+        out.assign(reinterpret_cast<const char*>(values.data()), values.size()*sizeof(real));
+        break;
+    case XorHistory:
+    {
+        // a zero XOR takes 1 bit; a XOR whose meaningful bits fit in the previous window takes 2 bits and the window; anything else takes 13 bits, its new window, and its meaningful bits.
+        BitWriter bits;
+        int window_leading = -1;
+        int window_trailing = 0;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            std::uint64_t x = std::bit_cast<std::uint64_t>(values[i]) ^ std::bit_cast<std::uint64_t>(predict_history_value(values, i));
+            if (x == 0)
+            {
+                bits.write_bits(0, 1);
+                continue;
+            }
+            int leading = std::min(std::countl_zero(x), 31);
+            int trailing = std::countr_zero(x);
+            if (window_leading >= 0 && leading >= window_leading && trailing >= window_trailing)
+            {
+                bits.write_bits(0b10, 2);
+                bits.write_bits(x >> window_trailing, 64 - window_leading - window_trailing);
+            } else {
+                int meaningful = 64 - leading - trailing;
+                bits.write_bits(0b11, 2);
+                bits.write_bits(leading, 5);
+                bits.write_bits(meaningful - 1, 6);
+                bits.write_bits(x >> trailing, meaningful);
+                window_leading = leading;
+                window_trailing = trailing;
+            }
+        }
+        out = std::move(bits.get_bytes());
+        break;
+    }
+    case QuantisedHistory:
+    {
+        if (error_bound <= 0.0)
+        {
+            std::cout << "encode_history: QuantisedHistory needs a positive error bound, but got " << error_bound << "." << std::endl;
+            exit(1);
+        }
+        std::vector<std::int64_t> quantised(values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            quantised[i] = std::llround(values[i]/(2*error_bound));
+            write_varint(out, zigzag_encode(quantised[i] - predict_history_value(quantised, i)));
+        }
+        break;
+    }
+    default:
+        std::cout << "encode_history: unknown encoding " << encoding << "." << std::endl;
+        exit(1);
+    }
+    return out;
+}
+
+/**
+ * @brief decodes \p num_values values encoded by \ref encode_history.
+ */
+inline std::vector<real> decode_history(std::span<const char> encoded, size_t num_values, HistoryEncoding encoding, real error_bound)
+{
+    std::vector<real> values(num_values);
+    switch (encoding)
+    {
+    case RawHistory:
+        if (encoded.size() != num_values*sizeof(real))
+        {
+            std::cout << "decode_history: expected " << num_values*sizeof(real) << " bytes but got " << encoded.size() << "." << std::endl;
+            exit(1);
+        }
+        std::copy(encoded.begin(), encoded.end(), reinterpret_cast<char*>(values.data()));
+        break;
+    case XorHistory:
+    {
+        BitReader bits(encoded);
+        int window_leading = 0;
+        int window_trailing = 0;
+        for (size_t i = 0; i < num_values; ++i)
+        {
+            std::uint64_t x = 0;
+            if (bits.read_bits(1))
+            {
+                if (bits.read_bits(1))
+                {
+                    window_leading = bits.read_bits(5);
+                    int meaningful = bits.read_bits(6) + 1;
+                    window_trailing = 64 - window_leading - meaningful;
+                }
+                x = bits.read_bits(64 - window_leading - window_trailing) << window_trailing;
+            }
+            values[i] = std::bit_cast<real>(x ^ std::bit_cast<std::uint64_t>(predict_history_value(values, i)));
+        }
+        break;
+    }
+    case QuantisedHistory:
+    {
+        std::vector<std::int64_t> quantised(num_values);
+        size_t position = 0;
+        for (size_t i = 0; i < num_values; ++i)
+        {
+            quantised[i] = zigzag_decode(read_varint(encoded, position)) + predict_history_value(quantised, i);
+            values[i] = quantised[i]*(2*error_bound);
+        }
+        break;
+    }
+    default:
+        std::cout << "decode_history: unknown encoding " << encoding << "." << std::endl;
+        exit(1);
+    }
+    return values;
+}
+
+/**
+ * @brief streams blocks of recorded history to a file, encoding the values of each DoF with a \ref HistoryEncoding.
+ * @details the file starts with \ref HISTORY_MAGIC, \ref HISTORY_VERSION, the encoding, and the error bound. Each call to \ref write_block then appends the node ID, the number of rows,
+ * the steps of the rows as variable-length differences, and for each DoF its number and encoded values. A node has one block per flush of the \ref Scribe; \ref read_history_file joins them.
+ */
+class HistoryWriter
+{
+    protected:
+        std::ofstream file;
+        HistoryEncoding encoding = XorHistory;
+        real error_bound = 0.0;
+        size_t num_value_bytes = 0; /**< bytes taken by the encoded values written so far.*/
+        size_t num_values = 0; /**< number of values written so far.*/
+
+    public:
+        /**
+         * @brief creates \p file_name, replacing any existing file, and writes its header.
+         */
+        HistoryWriter(std::string file_name, HistoryEncoding history_encoding, real history_error_bound)
+            : file(file_name, std::ios::binary | std::ios::trunc), encoding(history_encoding), error_bound(history_error_bound)
+        {
+            if (!file)
+            {
+                std::cout << "HistoryWriter: could not open history file " << file_name << "." << std::endl;
+                exit(1);
+            }
+            write_binary(file, HISTORY_MAGIC);
+            write_binary(file, HISTORY_VERSION);
+            write_binary(file, static_cast<int>(encoding));
+            write_binary(file, error_bound);
+        }
+
+        /**
+         * @brief appends the rows recorded for one node.
+         *
+         * @param node_id ID of the tracked node.
+         * @param steps the step of each row.
+         * @param dofs_values the tracked DoFs, each with its value at each row.
+         */
+        void write_block(unsigned node_id, const std::vector<int>& steps, const std::vector<std::pair<int, const std::vector<real>*>>& dofs_values)
+        {
+            std::string encoded_steps;
+            int previous_step = 0;
+            for (int step : steps)
+            {
+                write_varint(encoded_steps, zigzag_encode(step - previous_step));
+                previous_step = step;
+            }
+            write_binary(file, node_id);
+            write_binary(file, steps.size());
+            write_binary_span<char>(file, encoded_steps);
+            write_binary(file, dofs_values.size());
+            for (auto& [dof, values] : dofs_values)
+            {
+                std::string encoded_values = encode_history(*values, encoding, error_bound);
+                write_binary(file, dof);
+                write_binary_span<char>(file, encoded_values);
+                num_value_bytes += encoded_values.size();
+                num_values += values->size();
+            }
+            if (!file)
+            {
+                std::cout << "HistoryWriter: could not write history block of node " << node_id << "." << std::endl;
+                exit(1);
+            }
+        }
+
+        void flush() {file.flush();}
+
+        /**
+         * @brief Get the ratio of the raw size of the values written so far to their encoded size.
+         */
+        real get_compression_ratio() const {return num_value_bytes ? real(num_values*sizeof(real))/num_value_bytes : 1.0;}
+};
+
+/**
+ * @brief the history of one DoF of a node read back from a history file.
+ */
+struct DoFHistory {
+    std::vector<int> steps;
+    std::vector<real> values;
+};
+
+/**
+ * @brief reads a history file written by a \ref HistoryWriter.
+ *
+ * @return std::map<std::pair<unsigned, int>, DoFHistory> the history of each recorded node ID and DoF pair.
+ */
+inline std::map<std::pair<unsigned, int>, DoFHistory> read_history_file(std::string file_name)
+{
+    std::ifstream file(file_name, std::ios::binary);
+    std::array<char, 8> magic;
+    int version, encoding;
+    real error_bound;
+    if (!file)
+    {
+        std::cout << "read_history_file: could not open " << file_name << "." << std::endl;
+        exit(1);
+    }
+    read_binary(file, magic);
+    read_binary(file, version);
+    if (magic != HISTORY_MAGIC || version != HISTORY_VERSION)
+    {
+        std::cout << "read_history_file: " << file_name << " is not a version " << HISTORY_VERSION << " history file." << std::endl;
+        exit(1);
+    }
+    read_binary(file, encoding);
+    read_binary(file, error_bound);
+
+    std::map<std::pair<unsigned, int>, DoFHistory> histories;
+    unsigned node_id;
+    while (file.peek() != std::char_traits<char>::eof())
+    {
+        size_t num_rows, num_dofs;
+        std::vector<char> encoded_steps;
+        read_binary(file, node_id);
+        read_binary(file, num_rows);
+        read_binary_vector(file, encoded_steps);
+        std::vector<int> steps(num_rows);
+        size_t position = 0;
+        int previous_step = 0;
+        for (auto& step : steps)
+        {
+            step = previous_step + zigzag_decode(read_varint(encoded_steps, position));
+            previous_step = step;
+        }
+        read_binary(file, num_dofs);
+        for (size_t i = 0; i < num_dofs; ++i)
+        {
+            int dof;
+            std::vector<char> encoded_values;
+            read_binary(file, dof);
+            read_binary_vector(file, encoded_values);
+            std::vector<real> values = decode_history(encoded_values, num_rows, static_cast<HistoryEncoding>(encoding), error_bound);
+            DoFHistory& history = histories[{node_id, dof}];
+            history.steps.insert(history.steps.end(), steps.begin(), steps.end());
+            history.values.insert(history.values.end(), values.begin(), values.end());
+        }
+    }
+    return histories;
+}
+
+#endif
@@ -7,10 +7,54 @@
 #include "maths_defaults.hpp"
 #include "node.hpp"
 #include "basic_utilities.hpp"
+#include "binary_io.hpp"
+#include "HistoryWriter.hpp"
 #include <set>
 #include <utility>
 #include <map>
 #include <memory>
+#include <limits>
+#include <cmath>
+
+/**
+ * @brief the running minimum and maximum of a recorded DoF and the steps at which they occurred, kept by a \ref Record in place of its history.
+ */
+struct DoFReduction {
+    real min = std::numeric_limits<real>::max();
+    real max = std::numeric_limits<real>::lowest();
+    int min_step = -1; /**< step at which \ref min occurred; -1 if nothing has been recorded.*/
+    int max_step = -1; /**< step at which \ref max occurred; -1 if nothing has been recorded.*/
+
+    void add(real value, int step)
+    {
+        if (value < min)
+        {
+            min = value;
+            min_step = step;
+        }
+        if (value > max)
+        {
+            max = value;
+            max_step = step;
+        }
+    }
+
+    /**
+     * @brief merges the reduction of another DoF into this one, to reduce over a group of DoFs.
+     */
+    void merge(const DoFReduction& other)
+    {
+        if (other.min_step >= 0)
+            add(other.min, other.min_step);
+        if (other.max_step >= 0)
+            add(other.max, other.max_step);
+    }
+
+    /**
+     * @brief Get the envelope, i.e. the largest magnitude reached.
+     */
+    real get_envelope() const {return (max_step < 0) ? 0.0 : std::max(std::abs(min), std::abs(max));}
+};
 
 
 class Record {
@@ -18,6 +62,9 @@ class Record {
         std::shared_ptr<Node> tracked_node; /**< a shared pointer to the node that is being tracked by this record.*/
         unsigned tracked_node_id; /**< the ID of the node that is being tracked by this record.*/
         std::array<std::vector<real>, 6> recorded_data; /**< the data that is recorded in this record by the scribe.*/
+        std::vector<int> recorded_steps; /**< the step at which each row of \ref recorded_data was recorded.*/
+        std::array<real, 6> last_recorded = {0., 0., 0., 0., 0., 0.}; /**< the last value recorded for each DoF, against which \ref write_to_record_if_changed compares.*/
+        std::array<DoFReduction, 6> reductions; /**< running reductions of each tracked DoF, updated by \ref reduce_record.*/
         std::set<int> tracked_dofs; /**< a std set of tracked DoFs as decided by the scribe.*/
         
         bool full = false; /**< tells if the record is full and requires flushing. */
@@ -45,20 +92,73 @@ class Record {
         }
         
         /**
-         * @brief writes the current state of the tracked node to the record and checks if it is full.
+         * @brief writes the current state of the tracked node to the record.
          * 
+         * @param step the step being recorded.
          */
-        void write_to_record(int row)
+        void write_to_record(int step)
         {
-            int i = 0;
             for (auto& dof : tracked_dofs)
             {
                 real displacement = tracked_node->get_nodal_displacement(dof);
                 (this->recorded_data[dof]).push_back(displacement);
-                ++i;
+                last_recorded[dof] = displacement;
+            }
+            recorded_steps.push_back(step);
+        }
+
+        /**
+         * @brief writes the current state of the tracked node to the record only if any tracked DoF moved by more than \p tolerance since the last row written.
+         * 
+         * @param step the step being recorded.
+         * @param tolerance the change below which nothing is written.
+         * @return true if a row was written.
+         */
+        bool write_to_record_if_changed(int step, real tolerance)
+        {
+            bool changed = recorded_steps.empty();
+            for (auto& dof : tracked_dofs)
+            {
+                changed = changed || std::abs(tracked_node->get_nodal_displacement(dof) - last_recorded[dof]) > tolerance;
+            }
+            if (changed)
+                write_to_record(step);
+            return changed;
+        }
+
+        /**
+         * @brief updates the running reductions of the tracked DoFs with their current values without storing them.
+         * 
+         * @param step the step being recorded.
+         */
+        void reduce_record(int step)
+        {
+            for (auto& dof : tracked_dofs)
+            {
+                reductions[dof].add(tracked_node->get_nodal_displacement(dof), step);
             }
         }
         
+        /**
+         * @brief writes the rows recorded since the last flush to \p writer as one block and clears them, leaving \ref last_recorded and \ref reductions untouched.
+         */
+        void flush_history(HistoryWriter& writer)
+        {
+            if (recorded_steps.empty())
+                return;
+            std::vector<std::pair<int, const std::vector<real>*>> dofs_values;
+            for (auto& dof : tracked_dofs)
+            {
+                dofs_values.push_back({dof, &recorded_data[dof]});
+            }
+            writer.write_block(tracked_node_id, recorded_steps, dofs_values);
+            for (auto& dof_data : recorded_data)
+            {
+                dof_data.clear();
+            }
+            recorded_steps.clear();
+        }
+
         /**
          * @brief overloads the less than operator to compare records by their tracked node ID, allowing easy sorting of record libraries by \ref Scribe objects.
          * 
@@ -99,6 +199,42 @@ class Record {
             }
             std::cout << std::endl;
         }
+        /**
+         * @brief writes the tracked node ID and the recorded data.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary(out, tracked_node_id);
+            for (auto& dof_data : recorded_data)
+            {
+                write_binary_span<real>(out, dof_data);
+            }
+            write_binary_span<int>(out, recorded_steps);
+            write_binary(out, last_recorded);
+            write_binary(out, reductions);
+        }
+
+        /**
+         * @brief restores the recorded data written by \ref write_checkpoint. Exits if it was written by a record tracking a different node.
+         */
+        void read_checkpoint(std::istream& in)
+        {
+            unsigned checkpoint_node_id;
+            read_binary(in, checkpoint_node_id);
+            if (checkpoint_node_id != tracked_node_id)
+            {
+                std::cout << "Record::read_checkpoint: record for node " << tracked_node_id << " was given the checkpoint of node " << checkpoint_node_id << "." << std::endl;
+                exit(1);
+            }
+            for (auto& dof_data : recorded_data)
+            {
+                read_binary_vector(in, dof_data);
+            }
+            read_binary_vector(in, recorded_steps);
+            read_binary(in, last_recorded);
+            read_binary(in, reductions);
+        }
+
         /**
          * @brief Get the tracked node id.
          * 
@@ -127,6 +263,16 @@ class Record {
          */
         std::array<std::vector<real>,6> get_recorded_data() const {return this->recorded_data;}
 
+        /**
+         * @brief Get the steps at which the rows of the recorded data were recorded.
+         */
+        const std::vector<int>& get_recorded_steps() const {return recorded_steps;}
+
+        /**
+         * @brief Get the running reduction of a DoF; only updated under \ref RecordReductions.
+         */
+        const DoFReduction& get_reduction(int dof) const {return reductions[dof];}
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1 @@
+#include "RecordingPolicy.hpp"
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef RECORDING_POLICY
+#define RECORDING_POLICY
+/**
+ * @brief an enum that defines when the \ref Scribe stores the state of the tracked nodes; see \ref Scribe::set_recording_policy.
+ * 
+ */
+enum RecordingPolicy {
+    RecordEveryStep = 0,
+    RecordEveryNSteps = 1,
+    RecordOnChange = 2,
+    RecordReductions = 3
+};
+#endif
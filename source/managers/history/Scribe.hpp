@@ -15,6 +15,8 @@
 #include "node.hpp"
 #include "global_mesh.hpp"
 #include "Record.hpp"
+#include "RecordingPolicy.hpp"
+#include "HistoryWriter.hpp"
 
 
 /**
@@ -32,6 +34,11 @@ class Scribe
         std::vector<Record> record_library; /**< a vector of records that are used to store the \ref Record objects for all tracked nodes.*/
         int current_row = 0; /**< the current row in the recorded data that is being filled. Used for deciding when the data needs flushing.*/
         int buffer_size = BUFFER_SIZE; /**< the size of the buffer used to store the data beyond which the data has to be flushed to file.*/
+        RecordingPolicy policy = RecordEveryStep; /**< when the tracked nodes are recorded; see \ref set_recording_policy.*/
+        int record_interval = 1; /**< number of steps between rows under \ref RecordEveryNSteps.*/
+        real change_tolerance = 0.0; /**< change in a tracked DoF below which nothing is recorded under \ref RecordOnChange.*/
+        int num_steps = 0; /**< number of calls to \ref write_to_records so far; the step stored with each row counts these calls from 1.*/
+        std::shared_ptr<HistoryWriter> history_writer; /**< the writer to which full buffers are flushed; null if the history is only kept in memory.*/
 
     public:
 
@@ -94,15 +101,58 @@ class Scribe
         }
 
         /**
-         * @brief writes the current state of the tracked nodes to all the records.
+         * @brief sets when \ref write_to_records stores the state of the tracked nodes.
+         * @details \ref RecordEveryStep stores every step; \ref RecordEveryNSteps every \p interval steps; \ref RecordOnChange stores a row of a record only when one of its DoFs
+         * moved by more than \p tolerance since its last row; and \ref RecordReductions stores no history, only the running minimum and maximum of each DoF (see \ref DoFReduction),
+         * so that the memory and time taken by recording do not grow with the number of steps.
+         * 
+         * @param recording_policy one of \ref RecordEveryStep, \ref RecordEveryNSteps, \ref RecordOnChange, or \ref RecordReductions.
+         * @param interval number of steps between rows under \ref RecordEveryNSteps.
+         * @param tolerance change below which nothing is recorded under \ref RecordOnChange.
+         */
+        void set_recording_policy(RecordingPolicy recording_policy, int interval = 1, real tolerance = 0.0)
+        {
+            policy = recording_policy;
+            record_interval = std::max(1, interval);
+            change_tolerance = tolerance;
+        }
+
+        /**
+         * @brief records the current state of the tracked nodes following the \ref policy. Should be called once per step.
          * 
          */
         void write_to_records()
         {
-            for (Record& record: record_library)
+            int step = ++num_steps;
+            bool written = false;
+            switch (policy)
             {
-                record.write_to_record(current_row);
+            case RecordEveryNSteps:
+                if (step % record_interval != 0)
+                    break;
+                [[fallthrough]];
+            case RecordEveryStep:
+                for (Record& record: record_library)
+                {
+                    record.write_to_record(step);
+                }
+                written = true;
+                break;
+            case RecordOnChange:
+                for (Record& record: record_library)
+                {
+                    written = record.write_to_record_if_changed(step, change_tolerance) || written;
+                }
+                break;
+            case RecordReductions:
+                for (Record& record: record_library)
+                {
+                    record.reduce_record(step);
+                }
+                break;
             }
+            if (!written)
+                return;
             ++current_row;
 
             // This check is only done once every time we write all the records.
@@ -114,13 +164,96 @@ class Scribe
         }
 
         /**
-         * @brief flushes the records to file. Should use HDF5, but currently is not implemented.
+         * @brief streams the recorded history of this rank to `<file_prefix>_rank<rank>.blzhist` whenever the buffer fills and at the end of the analysis, so that the rows
+         * held in memory do not grow with the number of steps. The file is replaced when this is called, so a restarted analysis only writes the steps it runs.
+         * 
+         * @param file_prefix path and name prefix of the history file.
+         * @param encoding how the recorded values are encoded; \ref XorHistory is lossless.
+         * @param error_bound largest absolute error in a value under \ref QuantisedHistory.
+         */
+        void set_history_output(std::string file_prefix, HistoryEncoding encoding = XorHistory, real error_bound = 0.0)
+        {
+            if (encoding == QuantisedHistory && error_bound <= 0.0)
+            {
+                std::cout << "Scribe::set_history_output: QuantisedHistory needs a positive error bound, but got " << error_bound << "." << std::endl;
+                exit(1);
+            }
+            history_writer = std::make_shared<HistoryWriter>(get_history_file_name(file_prefix, rank), encoding, error_bound);
+        }
+
+        /**
+         * @brief Get the name of the history file written by \p rank.
+         */
+        static std::string get_history_file_name(std::string file_prefix, int rank)
+        {
+            return file_prefix + "_rank" + std::to_string(rank) + ".blzhist";
+        }
+
+        /**
+         * @brief flushes the buffered rows of all records to the history file set by \ref set_history_output and clears them. Exits if no history file was set.
          * 
          */
         void flush_records()
         {
-            std::cout << "current_row = " << current_row << "Flushing records to file still not implemented. Exiting." << std::endl;
-            exit(1);
+            if (!history_writer)
+            {
+                std::cout << "Scribe::flush_records: the buffer of " << buffer_size << " rows is full but no history file was set with set_history_output. Exiting." << std::endl;
+                exit(1);
+            }
+            for (Record& record: record_library)
+            {
+                record.flush_history(*history_writer);
+            }
+            history_writer->flush();
+            current_row = 0;
+        }
+
+        /**
+         * @brief flushes the rows still buffered to the history file, if one was set. Called at the end of an analysis.
+         */
+        void finish_recording()
+        {
+            if (history_writer)
+                flush_records();
+        }
+
+        /**
+         * @brief Get the ratio of the raw size of the values written to the history file to their encoded size; 1 if nothing was written.
+         */
+        real get_history_compression_ratio() const {return history_writer ? history_writer->get_compression_ratio() : 1.0;}
+
+        /**
+         * @brief writes the buffered rows of all records.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary(out, current_row);
+            write_binary(out, num_steps);
+            write_binary(out, record_library.size());
+            for (auto& record: record_library)
+            {
+                record.write_checkpoint(out);
+            }
+        }
+
+        /**
+         * @brief restores the buffered rows written by \ref write_checkpoint into a scribe tracking the same nodes.
+         */
+        void read_checkpoint(std::istream& in)
+        {
+            size_t num_records;
+            read_binary(in, current_row);
+            read_binary(in, num_steps);
+            read_binary(in, num_records);
+            if (num_records != record_library.size())
+            {
+                std::cout << "Scribe::read_checkpoint: checkpoint has " << num_records << " records but the scribe has " << record_library.size() << " on rank " << rank << "." << std::endl;
+                exit(1);
+            }
+            for (auto& record: record_library)
+            {
+                record.read_checkpoint(in);
+            }
         }
 
         /**
@@ -175,6 +308,19 @@ class Scribe
                 record.read_record();
             }
         }
+        /**
+         * @brief Get the reduction of a DoF over all the records of this scribe, i.e. over the group of nodes it tracks; only updated under \ref RecordReductions.
+         */
+        DoFReduction get_group_reduction(int dof) const
+        {
+            DoFReduction group_reduction;
+            for (auto& record: record_library)
+            {
+                group_reduction.merge(record.get_reduction(dof));
+            }
+            return group_reduction;
+        }
+
         /**
          * @brief Get the record library vector. Used for testing.
          * 
@@ -22,6 +22,7 @@ class NodalLoad
     protected:
         std::vector<std::shared_ptr<Node>> loaded_nodes; /**< a vector of shared pointers to nodes that are loaded.*/
         std::set<int> loaded_dofs; /**< a std set of loaded DoFs; none at first, then those loaded are added.*/
+        bool unique_loaded_nodes = false; /**< whether no node appears twice in \ref loaded_nodes, so that \ref increment_loads can increment the nodes in parallel; found by \ref initialise_loads.*/
         std::array<real, 6> nodal_loads = {0., 0., 0., 0., 0., 0.}; /**< a std array containing 6 slots to be filled with nodal loads corresponding to dofs; initialised to zero.*/
     public:
         /**
@@ -111,6 +112,12 @@ class NodalLoad
                     node->add_nodal_load(0.0, dof);
                 }
             }
+            std::set<Node*> distinct_nodes;
+            for (auto& node : loaded_nodes)
+            {
+                distinct_nodes.insert(node.get());
+            }
+            unique_loaded_nodes = (distinct_nodes.size() == loaded_nodes.size());
         }
         /**
          * @brief increments the load for \ref loaded_nodes by an amount of the load equivalent to the \f$ \Delta LF\f$ given. 
@@ -119,11 +126,13 @@ class NodalLoad
          */
         void increment_loads(real load_factor_increment)
         {
-            for (auto& loaded_node: loaded_nodes)
+            // each node is incremented by one thread, unless the same node was assigned to this load more than once.
+            #pragma omp parallel for if(unique_loaded_nodes)
+            for (size_t i = 0; i < loaded_nodes.size(); ++i)
             {
                 for (auto& dof : loaded_dofs)
                 {
-                    loaded_node->increment_nodal_load(nodal_loads[dof]*load_factor_increment, dof);
+                    loaded_nodes[i]->increment_nodal_load(nodal_loads[dof]*load_factor_increment, dof);
                 }
             }
         }
@@ -50,6 +50,16 @@ class ExecutionTimer
             duration += stop_time - start_time;
         }
 
+        /**
+         * @brief adds a duration measured elsewhere to \ref duration.
+         * 
+         * @param extra_duration the duration to add, in seconds.
+         */
+        void add_duration(double extra_duration)
+        {
+            duration += extra_duration;
+        }
+
         /**
          * @brief resets the timer setting \ref duration to 0.0, and \ref start_time and \ref stop_time to -1.0.
          * 
@@ -0,0 +1 @@
+#include "ScalingStudy.hpp"
\ No newline at end of file
@@ -0,0 +1,480 @@
+/**
+ * @file ScalingStudy.hpp
+ * @brief defines the \ref ScalingStudy class which runs `Blaze` over a sweep of ranks, threads, and frame sizes, and gathers the timers of each run into one scaling dataset.
+ */
+
+#ifndef SCALING_STUDY_HPP
+#define SCALING_STUDY_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "TimerStatistics.hpp"
+
+/**
+ * @brief an enum that defines how the frame changes with the number of workers in a \ref ScalingStudy.
+ *
+ */
+enum ScalingMode {
+    StrongScaling = 0, /**< the frame size is fixed; ideal runs take the time of the smallest run divided by the relative number of workers.*/
+    WeakScaling = 1 /**< the frame grows with the number of workers; ideal runs take the time of the smallest run.*/
+};
+
+/**
+ * @brief one run of `Blaze` in a \ref ScalingStudy.
+ */
+struct ScalingRun {
+    int ranks = 1;
+    int threads = 1;
+    int nbays = 1;
+    int nfloors = 1;
+    int repeat = 0; /**< index of the repetition of this configuration.*/
+
+    /**
+     * @brief Get the number of workers, i.e. ranks times threads.
+     */
+    int get_workers() const {return ranks*threads;}
+};
+
+/**
+ * @brief one row of the scaling dataset: the statistics of one timer of one configuration.
+ */
+struct ScalingResult {
+    ScalingRun run;
+    std::string timer;
+    TimerStatistics stats;
+    double speedup = 0.0; /**< the time of the smallest configuration over the time of this one, scaled by the relative problem size for \ref WeakScaling.*/
+    double efficiency = 0.0; /**< speedup over the relative number of workers.*/
+};
+
+/**
+ * @brief runs `Blaze` over a sweep of ranks, threads, and frame sizes, and gathers the per-rank timers of all runs into one dataset with the speedup, efficiency, and imbalance of each timer.
+ * @details the sweep is read by \ref read_spec from `key = value` lines, with `#` starting a comment:
+ * - `mode`: `strong` or `weak`.
+ * - `ranks`, `threads`: space-separated lists; every combination is run.
+ * - `nbays`, `nfloors`: the frame of the smallest configuration.
+ * - `weak_scale`: `nbays` or `nfloors`, the dimension multiplied by the relative number of workers in weak scaling.
+ * - `repeats`: runs of each configuration; the one with the shortest \ref reference_timer is kept.
+ * - `blaze`, `blaze_args`: the executable and the options passed to every run.
+ * - `launcher`: the command prefix; `{ranks}` and `{threads}` are replaced, e.g. `mpirun -n {ranks}`.
+ * - `output_dir`: where the timers file and log of each run are written.
+ * - `reference_timer`: the timer used to pick the best repeat.
+ *
+ * Each run is given `--timers_file`, so `Blaze` writes the duration of every timer on every rank as `rank,timer,duration` rows; see \ref read_timers_file.
+ * The time of a timer in a run is its maximum over the ranks, as the slowest rank holds the others back.
+ */
+class ScalingStudy
+{
+    protected:
+        ScalingMode mode = StrongScaling;
+        std::vector<int> ranks_list = {1};
+        std::vector<int> threads_list = {1};
+        int nbays = 10;
+        int nfloors = 5;
+        std::string weak_scale = "nbays";
+        int repeats = 1;
+        std::string blaze = "bin/Blaze";
+        std::string blaze_args = "";
+        std::string launcher = "mpirun -n {ranks}";
+        std::string output_dir = "scaling_runs";
+        std::string reference_timer = "all";
+        std::vector<ScalingResult> results; /**< populated by \ref analyse.*/
+
+        static std::string trim(std::string text)
+        {
+            size_t first = text.find_first_not_of(" \t\r");
+            if (first == std::string::npos)
+                return "";
+            size_t last = text.find_last_not_of(" \t\r");
+            return text.substr(first, last - first + 1);
+        }
+
+        static std::vector<int> parse_int_list(std::string text)
+        {
+            std::vector<int> values;
+            std::istringstream in(text);
+            int value;
+            while (in >> value)
+            {
+                values.push_back(value);
+            }
+            return values;
+        }
+
+        static std::string replace_all(std::string text, std::string key, std::string value)
+        {
+            size_t pos = 0;
+            while ((pos = text.find(key, pos)) != std::string::npos)
+            {
+                text.replace(pos, key.size(), value);
+                pos += value.size();
+            }
+            return text;
+        }
+
+        /**
+         * @brief Get the key of a configuration in the dataset, shared by all its repeats.
+         */
+        static std::string get_configuration_key(const ScalingRun& run, std::string timer)
+        {
+            return std::to_string(run.ranks) + "," + std::to_string(run.threads) + "," + std::to_string(run.nbays) + "," + std::to_string(run.nfloors) + "," + timer;
+        }
+
+    public:
+        /**
+         * @brief reads the sweep specification; see \ref ScalingStudy for the keys.
+         */
+        void read_spec(std::istream& in)
+        {
+            std::string line;
+            while (std::getline(in, line))
+            {
+                line = line.substr(0, line.find('#'));
+                size_t equals = line.find('=');
+                if (trim(line).empty())
+                    continue;
+                if (equals == std::string::npos)
+                {
+                    std::cout << "ScalingStudy::read_spec: expected key = value, but got: " << line << std::endl;
+                    exit(1);
+                }
+                std::string key = trim(line.substr(0, equals));
+                std::string value = trim(line.substr(equals + 1));
+                if (key == "mode")
+                {
+                    if (value == "strong")
+                        mode = StrongScaling;
+                    else if (value == "weak")
+                        mode = WeakScaling;
+                    else
+                    {
+                        std::cout << "ScalingStudy::read_spec: mode is " << value << ", while only accept strong and weak." << std::endl;
+                        exit(1);
+                    }
+                } else if (key == "ranks") {
+                    ranks_list = parse_int_list(value);
+                } else if (key == "threads") {
+                    threads_list = parse_int_list(value);
+                } else if (key == "nbays") {
+                    nbays = std::stoi(value);
+                } else if (key == "nfloors") {
+                    nfloors = std::stoi(value);
+                } else if (key == "weak_scale") {
+                    weak_scale = value;
+                } else if (key == "repeats") {
+                    repeats = std::stoi(value);
+                } else if (key == "blaze") {
+                    blaze = value;
+                } else if (key == "blaze_args") {
+                    blaze_args = value;
+                } else if (key == "launcher") {
+                    launcher = value;
+                } else if (key == "output_dir") {
+                    output_dir = value;
+                } else if (key == "reference_timer") {
+                    reference_timer = value;
+                } else {
+                    std::cout << "ScalingStudy::read_spec: ignoring unknown key " << key << "." << std::endl;
+                }
+            }
+            if (ranks_list.empty() || threads_list.empty() || repeats < 1)
+            {
+                std::cout << "ScalingStudy::read_spec: need at least one number of ranks, one number of threads, and one repeat." << std::endl;
+                exit(1);
+            }
+            if (weak_scale != "nbays" && weak_scale != "nfloors")
+            {
+                std::cout << "ScalingStudy::read_spec: weak_scale is " << weak_scale << ", while only accept nbays and nfloors." << std::endl;
+                exit(1);
+            }
+        }
+
+        /**
+         * @brief reads the sweep specification from a file; see \ref read_spec.
+         */
+        void read_spec_file(std::string file_name)
+        {
+            std::ifstream in(file_name);
+            if (!in)
+            {
+                std::cout << "ScalingStudy::read_spec_file: could not open " << file_name << std::endl;
+                exit(1);
+            }
+            read_spec(in);
+        }
+
+        /**
+         * @brief Get the number of workers of the smallest configuration, which all speedups are relative to.
+         */
+        int get_base_workers() const
+        {
+            return (*std::min_element(ranks_list.begin(), ranks_list.end()))*(*std::min_element(threads_list.begin(), threads_list.end()));
+        }
+
+        /**
+         * @brief lists every run of the sweep: each combination of ranks and threads, repeated \ref repeats times. For \ref WeakScaling, the \ref weak_scale dimension of the frame is multiplied by the number of workers over \ref get_base_workers.
+         */
+        std::vector<ScalingRun> plan_runs() const
+        {
+            std::vector<ScalingRun> runs;
+            int base_workers = get_base_workers();
+            for (int ranks : ranks_list)
+            {
+                for (int threads : threads_list)
+                {
+                    ScalingRun run;
+                    run.ranks = ranks;
+                    run.threads = threads;
+                    run.nbays = nbays;
+                    run.nfloors = nfloors;
+                    if (mode == WeakScaling)
+                    {
+                        double scale = double(run.get_workers())/base_workers;
+                        if (weak_scale == "nbays")
+                            run.nbays = std::max(1, int(std::lround(nbays*scale)));
+                        else
+                            run.nfloors = std::max(1, int(std::lround(nfloors*scale)));
+                    }
+                    for (int repeat = 0; repeat < repeats; ++repeat)
+                    {
+                        run.repeat = repeat;
+                        runs.push_back(run);
+                    }
+                }
+            }
+            return runs;
+        }
+
+        /**
+         * @brief Get the name of the timers file of a run, without extension; the log of the run shares it.
+         */
+        std::string get_run_name(const ScalingRun& run) const
+        {
+            return (std::filesystem::path(output_dir)/("run_r" + std::to_string(run.ranks) + "_t" + std::to_string(run.threads) + "_" + std::to_string(run.nbays) + "x" + std::to_string(run.nfloors) + "_" + std::to_string(run.repeat))).string();
+        }
+
+        /**
+         * @brief Get the shell command that runs `Blaze` for a run, writing its timers to `<run name>.csv` and its output to `<run name>.log`.
+         */
+        std::string get_run_command(const ScalingRun& run) const
+        {
+            std::string prefix = replace_all(replace_all(launcher, "{ranks}", std::to_string(run.ranks)), "{threads}", std::to_string(run.threads));
+            std::string run_name = get_run_name(run);
+            std::string command = "OMP_NUM_THREADS=" + std::to_string(run.threads) + " ";
+            if (!prefix.empty())
+                command += prefix + " ";
+            command += blaze + " ";
+            if (!blaze_args.empty())
+                command += blaze_args + " ";
+            command += "--nbays " + std::to_string(run.nbays) + " --nfloors " + std::to_string(run.nfloors);
+            command += " --timers_file " + run_name + ".csv > " + run_name + ".log 2>&1";
+            return command;
+        }
+
+        /**
+         * @brief runs every run in \ref plan_runs one after the other; stops if a run fails.
+         */
+        void run_all() const
+        {
+            std::filesystem::create_directories(output_dir);
+            for (const ScalingRun& run : plan_runs())
+            {
+                std::string command = get_run_command(run);
+                std::cout << command << std::endl;
+                if (std::system(command.c_str()) != 0)
+                {
+                    std::cout << "ScalingStudy::run_all: run failed; see " << get_run_name(run) << ".log" << std::endl;
+                    exit(1);
+                }
+            }
+        }
+
+        /**
+         * @brief reads a timers file written by `Blaze` with `--timers_file`; see \ref TimeKeeper::write_rank_durations_csv.
+         *
+         * @return std::map<std::string, std::vector<double>> the duration of each timer on each rank, indexed by rank.
+         */
+        static std::map<std::string, std::vector<double>> read_timers_file(std::string file_name)
+        {
+            std::ifstream in(file_name);
+            if (!in)
+            {
+                std::cout << "ScalingStudy::read_timers_file: could not open " << file_name << std::endl;
+                exit(1);
+            }
+            std::map<std::string, std::vector<double>> durations;
+            std::string line;
+            while (std::getline(in, line))
+            {
+                if (line.empty() || line.rfind("rank,", 0) == 0)
+                    continue;
+                size_t first_comma = line.find(',');
+                size_t last_comma = line.rfind(',');
+                if (first_comma == last_comma)
+                {
+                    std::cout << "ScalingStudy::read_timers_file: expected rank,timer,duration in " << file_name << ", but got: " << line << std::endl;
+                    exit(1);
+                }
+                int rank = std::stoi(line.substr(0, first_comma));
+                std::string timer = line.substr(first_comma + 1, last_comma - first_comma - 1);
+                std::vector<double>& timer_durations = durations[timer];
+                timer_durations.resize(std::max(timer_durations.size(), size_t(rank + 1)), 0.0);
+                timer_durations[rank] = std::stod(line.substr(last_comma + 1));
+            }
+            return durations;
+        }
+
+        /**
+         * @brief reads the timers file of every run, keeps the repeat of each configuration with the shortest \ref reference_timer, and calculates the speedup and efficiency of each timer relative to the smallest configuration.
+         * @details with \f$ t\f$ the maximum time over the ranks and \f$ p\f$ the number of workers, strong scaling has \f$ S = t_{base}/t\f$ and \f$ E = S\, p_{base}/p\f$, while weak scaling has
+         * \f$ E = t_{base}/t\f$ and \f$ S = E\, p/p_{base}\f$. Both are written as zero when a time is zero.
+         */
+        void analyse()
+        {
+            std::vector<std::pair<ScalingRun, std::map<std::string, std::vector<double>>>> best_runs;
+            std::map<std::string, size_t> best_run_index;
+            for (const ScalingRun& run : plan_runs())
+            {
+                std::map<std::string, std::vector<double>> durations = read_timers_file(get_run_name(run) + ".csv");
+                std::string key = get_configuration_key(run, "");
+                auto best = best_run_index.find(key);
+                if (best == best_run_index.end())
+                {
+                    best_run_index[key] = best_runs.size();
+                    best_runs.push_back({run, durations});
+                    continue;
+                }
+                double time = compute_timer_statistics(durations[reference_timer]).max;
+                double best_time = compute_timer_statistics(best_runs[best->second].second[reference_timer]).max;
+                if (time < best_time)
+                    best_runs[best->second] = {run, durations};
+            }
+
+            int base_workers = get_base_workers();
+            std::map<std::string, double> base_times;
+            results.clear();
+            for (auto& [run, durations] : best_runs)
+            {
+                for (auto& [timer, timer_durations] : durations)
+                {
+                    ScalingResult result;
+                    result.run = run;
+                    result.timer = timer;
+                    result.stats = compute_timer_statistics(timer_durations);
+                    if (run.get_workers() == base_workers && base_times.count(timer) == 0)
+                        base_times[timer] = result.stats.max;
+                    results.push_back(result);
+                }
+            }
+            for (ScalingResult& result : results)
+            {
+                double base_time = base_times[result.timer];
+                double relative_workers = double(result.run.get_workers())/base_workers;
+                if (base_time <= 0.0 || result.stats.max <= 0.0)
+                    continue;
+                if (mode == StrongScaling)
+                {
+                    result.speedup = base_time/result.stats.max;
+                    result.efficiency = result.speedup/relative_workers;
+                } else {
+                    result.efficiency = base_time/result.stats.max;
+                    result.speedup = result.efficiency*relative_workers;
+                }
+            }
+        }
+
+        /**
+         * @brief Get the rows of the scaling dataset calculated by \ref analyse.
+         */
+        const std::vector<ScalingResult>& get_results() const {return results;}
+
+        /**
+         * @brief writes the scaling dataset as comma-separated values, one row per configuration and timer.
+         */
+        void write_dataset(std::ostream& out) const
+        {
+            out << std::setprecision(10);
+            out << "mode,ranks,threads,workers,nbays,nfloors,timer,min,mean,max,imbalance,speedup,efficiency" << std::endl;
+            for (const ScalingResult& result : results)
+            {
+                out << (mode == StrongScaling ? "strong" : "weak") << ","
+                    << result.run.ranks << ","
+                    << result.run.threads << ","
+                    << result.run.get_workers() << ","
+                    << result.run.nbays << ","
+                    << result.run.nfloors << ","
+                    << result.timer << ","
+                    << result.stats.min << ","
+                    << result.stats.mean << ","
+                    << result.stats.max << ","
+                    << result.stats.imbalance << ","
+                    << result.speedup << ","
+                    << result.efficiency << std::endl;
+            }
+        }
+
+        /**
+         * @brief compares the maximum time of each timer with a dataset written earlier by \ref write_dataset, and prints every configuration and timer that got slower.
+         *
+         * @param baseline_file_name the earlier dataset; configurations missing from it are not compared.
+         * @param tolerance the relative slowdown allowed, e.g. 0.1 for 10%.
+         * @param min_duration timers that took less than this in the baseline are too noisy to compare.
+         * @return int the number of configurations and timers slower than allowed.
+         */
+        int check_against_baseline(std::string baseline_file_name, double tolerance, double min_duration = 1e-3) const
+        {
+            std::ifstream in(baseline_file_name);
+            if (!in)
+            {
+                std::cout << "ScalingStudy::check_against_baseline: could not open " << baseline_file_name << std::endl;
+                exit(1);
+            }
+            std::map<std::string, double> baseline_times;
+            std::string line;
+            std::getline(in, line); // header
+            while (std::getline(in, line))
+            {
+                std::vector<std::string> fields;
+                std::istringstream line_stream(line);
+                std::string field;
+                while (std::getline(line_stream, field, ','))
+                {
+                    fields.push_back(field);
+                }
+                if (fields.size() < 10)
+                    continue;
+                ScalingRun run;
+                run.ranks = std::stoi(fields[1]);
+                run.threads = std::stoi(fields[2]);
+                run.nbays = std::stoi(fields[4]);
+                run.nfloors = std::stoi(fields[5]);
+                baseline_times[get_configuration_key(run, fields[6])] = std::stod(fields[9]);
+            }
+
+            int num_regressions = 0;
+            for (const ScalingResult& result : results)
+            {
+                auto baseline = baseline_times.find(get_configuration_key(result.run, result.timer));
+                if (baseline == baseline_times.end() || baseline->second < min_duration)
+                    continue;
+                if (result.stats.max > baseline->second*(1.0 + tolerance))
+                {
+                    std::cout << "regression: " << result.timer << " with " << result.run.ranks << " ranks, " << result.run.threads << " threads, and a " << result.run.nbays << "x" << result.run.nfloors
+                              << " frame took " << result.stats.max << " s against " << baseline->second << " s." << std::endl;
+                    ++num_regressions;
+                }
+            }
+            return num_regressions;
+        }
+};
+
+#endif
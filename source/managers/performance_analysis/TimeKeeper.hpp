@@ -9,11 +9,16 @@
 #include <string>
 #include <iostream>
 #include <iomanip>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include "ExecutionTimer.hpp"
+#include "CommunicationTimer.hpp"
+#include "TimerStatistics.hpp"
 
 /**
  * @brief Keeps track of and controls a set of \ref ExecutionTimers. Use for profiling.
- * 
+ * @details each timer also records the part of its duration spent in communication, i.e. the growth of \ref CommunicationTimer::get_total_duration between its start and stop, so every timed phase is split into compute and communication; see \ref log_phase_balance.
  */
 class TimeKeeper 
 {
@@ -22,6 +27,10 @@ class TimeKeeper
         int rank = 0;
         int num_ranks = 1;
         std::map<int, std::vector<double>> rank_durations_map; /**< a map of ranks pointing to vectors of times kept on all processes.*/
+        std::map<int, std::vector<double>> rank_communication_durations_map; /**< the communication part of each duration in \ref rank_durations_map; empty unless requested from \ref collect_rank_durations.*/
+        std::map<std::string, double> communication_durations; /**< the time each timer spent in communication.*/
+        std::map<std::string, double> communication_start_map; /**< \ref CommunicationTimer::get_total_duration when each timer was last started.*/
+        std::map<std::string, std::pair<std::vector<double>, std::vector<double>>> thread_durations_map; /**< a map of parallel phases pointing to the cumulative busy and idle time of each thread; see \ref add_thread_durations.*/
     public:
         /**
          * @brief sets the rank and num_ranks of the time keeper.
@@ -54,6 +63,7 @@ class TimeKeeper
          */
         void start_timer(std::string timer_name)
         {
+            communication_start_map[timer_name] = CommunicationTimer::get_total_duration();
             timers_map[timer_name].start();
         }
         
@@ -65,6 +75,18 @@ class TimeKeeper
         void stop_timer(std::string timer_name)
         {
             timers_map[timer_name].stop();
+            communication_durations[timer_name] += CommunicationTimer::get_total_duration() - communication_start_map[timer_name];
+        }
+        
+        /**
+         * @brief adds a duration measured outside the time keeper to a timer, e.g. by an OpenMP task that may not start and stop timers while other threads do. The duration is counted as compute.
+         * 
+         * @param timer_name the timer in the \ref timers_map to add to.
+         * @param extra_duration the duration to add, in seconds.
+         */
+        void add_duration(std::string timer_name, double extra_duration)
+        {
+            timers_map[timer_name].add_duration(extra_duration);
         }
         
         /**
@@ -75,6 +97,7 @@ class TimeKeeper
         void reset_timer(std::string timer_name)
         {
             timers_map[timer_name].reset();
+            communication_durations[timer_name] = 0.0;
         }
 
         /**
@@ -88,6 +111,97 @@ class TimeKeeper
             return timers_map[timer_name].get_duration();
         }
 
+        /**
+         * @brief returns the part of the duration of a timer spent in communication, including waiting for other ranks; see \ref CommunicationTimer.
+         */
+        double get_communication_duration(std::string timer_name)
+        {
+            return communication_durations[timer_name];
+        }
+
+        /**
+         * @brief returns the part of the duration of a timer not spent in communication.
+         */
+        double get_compute_duration(std::string timer_name)
+        {
+            return get_timer_duration(timer_name) - get_communication_duration(timer_name);
+        }
+
+        /**
+         * @brief gathers the same number of values from every rank on rank 0; a collective call with MPI.
+         * 
+         * @return std::map<int, std::vector<double>> the values of each rank; only populated on rank 0.
+         */
+        std::map<int, std::vector<double>> gather_on_rank_zero(const std::vector<double>& values)
+        {
+            std::map<int, std::vector<double>> rank_values;
+            #ifdef WITH_MPI
+            int num_values = values.size();
+            std::vector<double> collected_values;
+            if (rank == 0)
+            {
+                collected_values.resize(num_values*num_ranks, 0.0);
+            }
+            MPI_Gather(values.data(), num_values, MPI_DOUBLE, collected_values.data(), num_values, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            if (rank == 0)
+            {
+                for (int rank_i = 0; rank_i < num_ranks; ++rank_i)
+                {
+                    rank_values[rank_i] = std::vector<double>(collected_values.begin() + rank_i*num_values, collected_values.begin() + (rank_i + 1)*num_values);
+                }
+            }
+            #else
+            rank_values[rank] = values;
+            #endif
+            return rank_values;
+        }
+
+        /**
+         * @brief adds the time each thread spent working and waiting in one execution of a parallel phase to the cumulative thread durations of that phase.
+         * 
+         * @param phase_name the name of the parallel phase, e.g. "element_state_update".
+         * @param busy_times the time each thread spent working.
+         * @param idle_times the time each thread spent waiting for the other threads.
+         */
+        void add_thread_durations(std::string phase_name, const std::vector<double>& busy_times, const std::vector<double>& idle_times)
+        {
+            auto& [busy, idle] = thread_durations_map[phase_name];
+            busy.resize(std::max(busy.size(), busy_times.size()), 0.0);
+            idle.resize(std::max(idle.size(), idle_times.size()), 0.0);
+            for (size_t thread = 0; thread < busy_times.size(); ++thread)
+                busy[thread] += busy_times[thread];
+            for (size_t thread = 0; thread < idle_times.size(); ++thread)
+                idle[thread] += idle_times[thread];
+        }
+
+        /**
+         * @brief Get the cumulative busy and idle time of each thread in a parallel phase; see \ref add_thread_durations.
+         */
+        std::pair<std::vector<double>, std::vector<double>> get_thread_durations(std::string phase_name)
+        {
+            return thread_durations_map[phase_name];
+        }
+
+        /**
+         * @brief prints a comma-separated table of the busy and idle time of each thread in a parallel phase, and the share of the thread time spent idle.
+         * @param phase_name the name of the parallel phase.
+         */
+        void log_thread_durations(std::string phase_name)
+        {
+            auto& [busy, idle] = thread_durations_map[phase_name];
+            double total_busy = 0.0, total_idle = 0.0;
+            std::cout << std::setprecision(8);
+            std::cout << "rank,phase,thread,busy,idle" << std::endl;
+            for (size_t thread = 0; thread < busy.size(); ++thread)
+            {
+                std::cout << rank << "," << phase_name << "," << thread << "," << busy[thread] << "," << idle[thread] << std::endl;
+                total_busy += busy[thread];
+                total_idle += idle[thread];
+            }
+            if (total_busy + total_idle > 0.0)
+                std::cout << phase_name << "_idle_fraction:" << total_idle/(total_busy + total_idle) << std::endl;
+        }
+
         /**
          * @brief prints a table with durations recorded by all requested timers as well as a percentage calculated with respect to a reference_timer.
          * @details the percentage is calculated using: \f$ P_i = \frac{\Delta t_i \times 100}{\Delta t_{reference}} \f$
@@ -214,8 +328,93 @@ class TimeKeeper
             }
             
         }
-        #endif 
-        
+        #endif
+
+        /**
+         * @brief populates the \ref rank_durations_map on rank 0 with the durations of the requested timers on all ranks; a collective call with MPI.
+         * @param timers_names the names of the timers which durations are to be collected.
+         * @param with_communication whether the communication part of each duration is also collected into \ref rank_communication_durations_map.
+         */
+        void collect_rank_durations(std::vector<std::string> timers_names, bool with_communication = false)
+        {
+            std::vector<double> durations, communication;
+            for (std::string name : timers_names)
+            {
+                durations.push_back(get_timer_duration(name));
+                communication.push_back(get_communication_duration(name));
+            }
+            rank_durations_map = gather_on_rank_zero(durations);
+            rank_communication_durations_map.clear();
+            if (with_communication)
+            {
+                rank_communication_durations_map = gather_on_rank_zero(communication);
+            }
+        }
+
+        /**
+         * @brief writes the \ref rank_durations_map as comma-separated `rank,timer,duration` rows, one per rank and timer; see \ref collect_rank_durations.
+         * @details if the communication durations were collected, each timer is followed by a `<timer>:compute` and a `<timer>:communication` row.
+         * @param out the stream to write to, e.g. a timers file read by \ref ScalingStudy.
+         * @param timers_names the names of the collected timers, in the order they were collected.
+         * @param write_header whether the column names are written first.
+         */
+        void write_rank_durations_csv(std::ostream& out, std::vector<std::string> timers_names, bool write_header = true)
+        {
+            out << std::setprecision(10);
+            if (write_header)
+            {
+                out << "rank,timer,duration" << std::endl;
+            }
+            for (auto& [rank_i, durations] : rank_durations_map)
+            {
+                for (size_t i = 0; i < timers_names.size() && i < durations.size(); ++i)
+                {
+                    out << rank_i << "," << timers_names[i] << "," << durations[i] << std::endl;
+                    if (rank_communication_durations_map.count(rank_i))
+                    {
+                        double communication = rank_communication_durations_map[rank_i][i];
+                        out << rank_i << "," << timers_names[i] << ":compute," << durations[i] - communication << std::endl;
+                        out << rank_i << "," << timers_names[i] << ":communication," << communication << std::endl;
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief collects the compute and communication part of each phase from all ranks, and prints on rank 0 their minimum, mean, and maximum over the ranks and their imbalance \f$ t_{max}/t_{mean} - 1\f$; a collective call with MPI.
+         * @details a compute imbalance points to the partitioning. Communication time includes waiting for the slowest rank, so a large communication time with a balanced compute points to the communication itself,
+         * while one that follows a compute imbalance is mostly waiting. \ref CommunicationTimer::get_site_durations tells which call the time was spent in.
+         * @param phase_names the names of the timers of the phases.
+         */
+        void log_phase_balance(std::vector<std::string> phase_names)
+        {
+            std::vector<double> values;
+            for (std::string name : phase_names)
+            {
+                values.push_back(get_compute_duration(name));
+                values.push_back(get_communication_duration(name));
+            }
+            std::map<int, std::vector<double>> rank_values = gather_on_rank_zero(values);
+            if (rank != 0)
+                return;
+            std::cout << std::setprecision(8);
+            std::cout << "phase,part,min,mean,max,imbalance" << std::endl;
+            for (size_t i = 0; i < phase_names.size(); ++i)
+            {
+                for (int part = 0; part < 2; ++part)
+                {
+                    std::vector<double> durations;
+                    for (auto& [rank_i, rank_i_values] : rank_values)
+                    {
+                        durations.push_back(rank_i_values[2*i + part]);
+                    }
+                    TimerStatistics stats = compute_timer_statistics(durations);
+                    std::cout << phase_names[i] << "," << (part == 0 ? "compute" : "communication") << ","
+                              << stats.min << "," << stats.mean << "," << stats.max << "," << stats.imbalance << std::endl;
+                }
+            }
+        }
+
         /**
          * @brief prints the \ref rank_durations_map object.
          * @param timers_names the names of the timers which durations are to be printed.
@@ -0,0 +1 @@
+#include "TimerStatistics.hpp"
\ No newline at end of file
@@ -0,0 +1,42 @@
+/**
+ * @file TimerStatistics.hpp
+ * @brief defines \ref TimerStatistics, the spread of a duration over the ranks, shared by \ref TimeKeeper and \ref ScalingStudy.
+ */
+
+#ifndef TIMER_STATISTICS_HPP
+#define TIMER_STATISTICS_HPP
+
+#include <algorithm>
+#include <vector>
+
+/**
+ * @brief the spread of the duration of one timer over the ranks of a run.
+ */
+struct TimerStatistics {
+    double min = 0.0;
+    double mean = 0.0;
+    double max = 0.0;
+    double imbalance = 0.0; /**< load imbalance \f$ t_{max}/t_{mean} - 1\f$; zero when all ranks take the same time.*/
+};
+
+/**
+ * @brief calculates the minimum, mean, maximum, and imbalance of the durations of a timer over the ranks.
+ */
+inline TimerStatistics compute_timer_statistics(const std::vector<double>& durations)
+{
+    TimerStatistics stats;
+    if (durations.empty())
+        return stats;
+    stats.min = *std::min_element(durations.begin(), durations.end());
+    stats.max = *std::max_element(durations.begin(), durations.end());
+    for (double duration : durations)
+    {
+        stats.mean += duration;
+    }
+    stats.mean /= durations.size();
+    if (stats.mean > 0.0)
+        stats.imbalance = stats.max/stats.mean - 1.0;
+    return stats;
+}
+
+#endif
@@ -13,10 +13,6 @@
  * @brief A class for elastic-plastic material with hardening.
  */
 class ElasticPlasticMaterial : public Material1D {
-protected:
-    real beta = 0.0; /**< this is the fraction of strain increment \f$ \Delta \epsilon \f$ that takes the stress to the \f$\bf{current}\f$ yield stress.*/
-    bool loading = true; /**< is the material currently being continuously loaded by the strain increment? if material is unloading or reloading then this is false.*/
-
 public:
     ElasticPlasticMaterial() = default;
     ElasticPlasticMaterial(real E, real f, real H)
@@ -25,7 +21,7 @@ public:
     }
 
     // Copy constructor
-    ElasticPlasticMaterial(const ElasticPlasticMaterial& other) : Material1D(other), beta(other.beta), loading(other.loading)
+    ElasticPlasticMaterial(const ElasticPlasticMaterial& other) : Material1D(other)
     {}
 
     /**
@@ -41,66 +37,138 @@ public:
         reference_fy0 = f;
         this->H = H;
         
-        starting_E = reference_E0;
-        starting_E_t = reference_E0;
-        starting_fy = reference_fy0;
-        starting_fy_bar = reference_fy0;
-        starting_stress = 0.0;
-        starting_strain = 0.0;
-        starting_plastic_strain = 0.0;
-        starting_elastic = true;
+        starting = initial_state(get_parameters());
         initialise_current_state();
     }
 
     /**
-     * 
-     * @brief increments the total strain and calculates the yield function, flow, and hardening.
-     * @details this is based on Bhatti's Isotropic hardening algorithm (2006, Pp. 396 - 397)
-     * @param d_eps the increment in total strain.
+     * @name batched interface
+     * @brief the static, non-virtual form of the material used by \ref MaterialBatch to update many points at once.
      */
-    virtual void increment_strain(real d_eps)
+    //@{
+    /**
+     * @brief the reference properties of the material, which do not change during the analysis.
+     */
+    struct Parameters {
+        real E0; /**< Initial Young's modulus.*/
+        real fy0; /**< Initial yield strength.*/
+        real H; /**< Hardening parameter.*/
+    };
+    using State = MaterialState; /**< the state of a point; the bilinear model needs nothing beyond \ref MaterialState.*/
+    static constexpr bool has_linear_elastic_range = true; /**< stress is exactly \f$E\varepsilon\f$ until \f$\bar{\sigma}_y\f$ is reached, so sections may use a closed-form elastic update.*/
+
+    /**
+     * @brief Get the reference properties of this material for use with \ref MaterialBatch.
+     */
+    Parameters get_parameters() const {return Parameters{reference_E0, reference_fy0, H};}
+
+    /**
+     * @brief the virgin state of a point with properties \p p.
+     */
+    static State initial_state(const Parameters& p) {return State{p.E0, p.E0, p.fy0, p.fy0, 0.0, 0.0, 0.0, true};}
+
+    /**
+     * @brief the committed state of a point in single precision, used by \ref MaterialBatch in compact storage mode.
+     * @details \f$E\f$ and \f$\sigma_y\f$ never change and \f$E_t\f$ is \f$E\f$ while elastic and \f$EH/(E + H)\f$ otherwise, so they are recovered exactly from \ref Parameters and not stored.
+     */
+    struct CompactState {
+        float stress;
+        float strain;
+        float plastic_strain;
+        float fy_bar;
+        bool elastic;
+    };
+
+    /**
+     * @brief rounds a state to its compact form.
+     */
+    static CompactState compress(const State& s)
     {
-        
-        initialise_current_state(); // Copy the starting_ state variables into the current state variables
-        real delta_s = E * d_eps; // calculate elastic stress increment
-        check_if_loading(delta_s); // evaluate loading vs unloading/reloading states
-        real s = stress + delta_s; // estimate stress if entire step is elastic
-        evolve_yield_surface(); // perform the hardening calculation
-        strain += d_eps; // increment the strain by the strain increment
+        return CompactState{static_cast<float>(s.stress), static_cast<float>(s.strain), static_cast<float>(s.plastic_strain), static_cast<float>(s.fy_bar), s.elastic};
+    }
 
+    /**
+     * @brief recovers a full state from its compact form.
+     */
+    static State expand(const Parameters& p, const CompactState& c)
+    {
+        real E_t = c.elastic ? p.E0 : p.E0 * p.H/ (p.E0 + p.H);
+        return State{p.E0, E_t, p.fy0, c.fy_bar, c.stress, c.strain, c.plastic_strain, c.elastic};
+    }
+
+    /**
+     * @brief true if the stress \p s lies inside the yield surface of state \p st, i.e. \f$ \abs{s} < \bar{\sigma_y}\f$.
+     */
+    static bool is_inside_yield_surface(const State& st, real s) {return std::abs(s) < st.fy_bar;}
+
+    /**
+     * @brief the yield stress \f$\bar{\sigma}_y = \sigma_y + H\varepsilon_p\f$ of state \p st after isotropic hardening.
+     */
+    static real hardened_yield_stress(const Parameters& p, const State& st) {return st.fy + p.H*st.plastic_strain;}
 
-        if (elastic) // if the material starts off in its iteration as elastic
+    /**
+     * @brief the plastic strain accumulated by a strain increment \p d_eps of which the fraction \p beta is elastic.
+     */
+    static real plastic_strain_increment(const Parameters& p, const State& st, real beta, real d_eps)
+    {
+        return ((1 - beta)/(1 + (p.H/st.E)))*std::abs(d_eps);
+    }
+
+    /**
+     * @brief increments the total strain of one point from its starting state and calculates the yield function, flow, and hardening.
+     * @details this is based on Bhatti's Isotropic hardening algorithm (2006, Pp. 396 - 397)
+     * @param p the reference properties of the point.
+     * @param start the starting state of the point.
+     * @param cur the current state of the point, overwritten.
+     * @param d_eps the increment in total strain from the starting state.
+     */
+    static void increment(const Parameters& p, const State& start, State& cur, real d_eps)
+    {
+        cur = start; // Copy the starting_ state variables into the current state variables
+        real delta_s = cur.E * d_eps; // calculate elastic stress increment
+        bool is_loading = cur.stress*delta_s >= 0; // evaluate loading vs unloading/reloading states
+        real s = cur.stress + delta_s; // estimate stress if entire step is elastic
+        cur.fy_bar = hardened_yield_stress(p, cur); // perform the hardening calculation
+        cur.strain += d_eps; // increment the strain by the strain increment
+        real beta_i = 0.0;
+
+        if (cur.elastic) // if the material starts off in its iteration as elastic
         {
             // we check if it will remain elastic in this step, first
-            eval_yield_function(s); // updates the 'elastic' variable based on incremented stress
+            cur.elastic = is_inside_yield_surface(cur, s); // updates the 'elastic' variable based on incremented stress
             
-            if (elastic) // this means the material did not yield in this load-step
+            if (cur.elastic) // this means the material did not yield in this load-step
             {
-                stress = s; // so everything is just elastic - just update the stress and exit this function.
+                cur.stress = s; // so everything is just elastic - just update the stress and exit this function.
                 return;
             } else { // the material did, in fact, yield during this step.
-                E_t = E * H/ (E + H); // update the tangent modulus as per Bhatti's similar-triangles approach
-                beta = (fy_bar - abs(stress))/(abs(s) - abs(stress)); // calculate the value of \f$\beta\f$ which is non-zero
+                cur.E_t = cur.E * p.H/ (cur.E + p.H); // update the tangent modulus as per Bhatti's similar-triangles approach
+                beta_i = (cur.fy_bar - std::abs(cur.stress))/(std::abs(s) - std::abs(cur.stress)); // calculate the value of \f$\beta\f$ which is non-zero
             }
         } else {
             // we only enter here if we are plastic to begin with
-            if (loading) // if material is plastic and we are loading, then we continue being plastic - not very interesting.
+            if (!is_loading) // material is unloading and is thus elastic again; if loading, we continue being plastic with beta = 0.
             {
-                beta = 0;
-            } else { // otherwise, material is unloading and is thus elastic again
-                elastic = true;
-                E_t = E;
-                stress = s;
+                cur.elastic = true;
+                cur.E_t = cur.E;
+                cur.stress = s;
                 return;
             }
         }
-        stress = stress + beta*delta_s + ((E * H)/(E + H)) * (1 - beta) * d_eps;
-        calc_plastic_flow(d_eps); // increment the plastic strain
+        cur.stress = cur.stress + beta_i*delta_s + ((cur.E * p.H)/(cur.E + p.H)) * (1 - beta_i) * d_eps;
+        cur.plastic_strain += plastic_strain_increment(p, cur, beta_i, d_eps); // increment the plastic strain
     }
+    //@}
 
-    virtual void check_if_loading(real delta_s)
+    /**
+     * 
+     * @brief increments the total strain and calculates the yield function, flow, and hardening.
+     * @details forwards to \ref increment so that the per-point and batched forms of the material cannot diverge.
+     * @param d_eps the increment in total strain.
+     */
+    virtual void increment_strain(real d_eps)
     {
-        loading = stress*delta_s >= 0;
+        increment(get_parameters(), starting, current, d_eps);
     }
 
     /**
@@ -110,7 +178,7 @@ public:
      */
     virtual void eval_yield_function(real s)
     {
-        elastic = abs(s) < fy_bar;
+        current.elastic = is_inside_yield_surface(current, s);
     }
 
 
@@ -120,23 +188,16 @@ public:
      */
     virtual void initialise_current_state()
     {
-        E = starting_E;
-        E_t = starting_E_t;
-        fy = starting_fy;
-        fy_bar = starting_fy_bar;
-        stress = starting_stress;
-        strain = starting_strain;
-        plastic_strain = starting_plastic_strain;
-        elastic = starting_elastic;
+        revert_state();
     }
 
     /**
-     * @brief calculates plastic strain rate.
+     * @brief calculates plastic strain rate, taking the whole of \p d_eps as plastic; \ref increment handles a step that only yields part way.
      * 
      */
     virtual void calc_plastic_flow(real d_eps)
     {
-        plastic_strain = plastic_strain + ((1 - beta)/(1 + (H/E)))*abs(d_eps);
+        current.plastic_strain += plastic_strain_increment(get_parameters(), current, 0.0, d_eps);
     }
     
     /**
@@ -145,7 +206,7 @@ public:
      */
     virtual void evolve_yield_surface()
     {
-        fy_bar = fy + H*plastic_strain;
+        current.fy_bar = hardened_yield_stress(get_parameters(), current);
     }
 
     /**
@@ -154,14 +215,7 @@ public:
      */
     virtual void update_starting_state()
     {
-        starting_E = E;
-        starting_E_t = E_t;
-        starting_fy = fy;
-        starting_fy_bar = fy_bar;
-        starting_stress = stress;
-        starting_strain = strain;
-        starting_plastic_strain = plastic_strain;
-        starting_elastic = elastic;
+        commit_state();
     }
 
 
@@ -184,7 +238,7 @@ public:
      */
     virtual real get_E() const 
     {
-        return E;
+        return current.E;
     }
 
     /**
@@ -194,7 +248,7 @@ public:
      */
     virtual real get_E_t() const
     {
-        return E_t;
+        return current.E_t;
     }
 
     /**
@@ -204,7 +258,7 @@ public:
      */
     virtual real get_fy() const
     {
-        return fy;
+        return current.fy;
     }
 
     /**
@@ -214,7 +268,7 @@ public:
      */
     virtual real get_fy_bar() const
     {
-        return fy_bar;
+        return current.fy_bar;
     }
 
     /**
@@ -224,7 +278,7 @@ public:
      */
     virtual real get_stress() const
     {
-        return stress;
+        return current.stress;
     }
 
     /**
@@ -234,7 +288,7 @@ public:
      */
     virtual real get_strain() const
     {
-        return strain;
+        return current.strain;
     }
 
     /**
@@ -244,7 +298,7 @@ public:
      */
     virtual real get_plastic_strain() const
     {
-        return plastic_strain;
+        return current.plastic_strain;
     }
 
     /**
@@ -254,7 +308,7 @@ public:
      */
     virtual bool is_elastic() const
     {
-        return elastic;
+        return current.elastic;
     }
 
     /**
@@ -264,7 +318,7 @@ public:
      */
     virtual real get_starting_E() const
     {
-        return starting_E;
+        return starting.E;
     }
 
     /**
@@ -274,7 +328,7 @@ public:
      */
     virtual real get_starting_E_t() const
     {
-        return starting_E_t;
+        return starting.E_t;
     }
 
     /**
@@ -284,7 +338,7 @@ public:
      */
     virtual real get_starting_fy() const
     {
-        return starting_fy;
+        return starting.fy;
     }
 
     /**
@@ -294,7 +348,7 @@ public:
      */
     virtual real get_starting_fy_bar() const
     {
-        return starting_fy_bar;
+        return starting.fy_bar;
     }
 
     /**
@@ -304,7 +358,7 @@ public:
      */
     virtual real get_starting_stress() const
     {
-        return starting_stress;
+        return starting.stress;
     }
 
     /**
@@ -314,7 +368,7 @@ public:
      */
     virtual real get_starting_strain() const
     {
-        return starting_strain;
+        return starting.strain;
     }
 
     /**
@@ -324,7 +378,7 @@ public:
      */
     virtual real get_starting_plastic_strain() const
     {
-        return starting_plastic_strain;
+        return starting.plastic_strain;
     }
 
     /**
@@ -334,7 +388,7 @@ public:
      */
     virtual bool is_starting_elastic() const
     {
-        return starting_elastic;
+        return starting.elastic;
     }
 };
 
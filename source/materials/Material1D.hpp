@@ -7,6 +7,20 @@
 #define MATERIAL1D_HPP
 #include "maths_defaults.hpp"
 
+/**
+ * @brief the state variables of a 1D material. Trivially copyable so a whole state is copied as one block.
+ */
+struct MaterialState {
+    real E = 0.0;  /**< Young's modulus of the material.*/ 
+    real E_t = 0.0; /**< Tangent Young's modulus of the material.*/ 
+    real fy = 0.0; /**< Yield strength.*/
+    real fy_bar = 0.0; /**< Yield stress of the material after hardening/softening - \f$\bar{\sigma}_y\f$ from Bhatti.*/
+    real stress = 0.0; /**< Stress in the material.*/
+    real strain = 0.0; /**< Total strain in the material.*/
+    real plastic_strain = 0.0; /**< Accumulated plastic strain.*/
+    bool elastic = true; /**< Whether the material is still elastic or not.*/
+};
+
 /**
  * @brief A base pure virtual class for 1D material. 
  */
@@ -26,27 +40,13 @@ protected:
      * @name state variables
      * @brief material parameters that are updated during state update.
      * @details to avoid having fictitious plastic strain accumulation, we always start with "previous" state - since this
-     * is always the state we start from, Blaze calls it the "starting" state. All state members not prefixed are current
-     * state variables.
+     * is always the state we start from, Blaze calls it the "starting" state. The current (trial) and starting (committed)
+     * states are held in two \ref MaterialState buffers so that committing, restarting an iteration, and rolling back a
+     * step are each a single copy of a trivially-copyable struct rather than field-by-field virtual calls.
      */
     //@{
-    real E;  /**< Current Young's modulus of the material.*/ 
-    real E_t; /**< Current tangent Young's modulus of the material.*/ 
-    real fy; /**< Current yield strength.*/
-    real fy_bar; /**< Current yield stress of the material after hardening/softening - \f$\bar{\sigma}_y\f$ from Bhatti.*/
-    real stress; /**< Current stress in the material.*/
-    real strain; /**< Current total strain in the material.*/
-    real plastic_strain; /**< Current accumulated plastic strain.*/
-    bool elastic; /**< Whether the material is currently still elastic or not.*/
-
-    real starting_E; /**< Young's modulus of the material at the start of the load step.*/ 
-    real starting_E_t; /**< Tangent Young's modulus of the material at the start of the load step.*/ 
-    real starting_fy; /**< yield strength at the start of the load step.*/
-    real starting_fy_bar; /**< Yield stress of the material after hardening/softening at the start of the load step.*/
-    real starting_stress; /**< Stress in the material at the start of the load step.*/
-    real starting_strain; /**< Total strain in the material at the start of the load step.*/
-    real starting_plastic_strain; /**< Accumulated plastic strain at the start of the load step.*/
-    bool starting_elastic; /**< Whether the material is still elastic or not at the start of the load step.*/
+    MaterialState current; /**< Current (trial) state of the material.*/
+    MaterialState starting; /**< State of the material at the start of the load step.*/
     //@}
     /**
      * @name thermo-mechanical variables
@@ -100,6 +100,26 @@ public:
      */
     virtual void update_starting_state() = 0;
 
+    /**
+     * @brief commits the current state as the starting state with a single block copy.
+     */
+    void commit_state() {starting = current;}
+
+    /**
+     * @brief discards the current state by restoring the starting state; used to restart an iteration or roll back a step.
+     */
+    void revert_state() {current = starting;}
+
+    /**
+     * @brief Get the whole starting state without a virtual call per variable.
+     */
+    const MaterialState& get_starting_state() const {return starting;}
+
+    /**
+     * @brief Get the whole current state without a virtual call per variable.
+     */
+    const MaterialState& get_current_state() const {return current;}
+
 
     /**
      * @brief evolves the temperature of the material, and re-evaluates the material state.
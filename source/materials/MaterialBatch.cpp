@@ -0,0 +1 @@
+#include "MaterialBatch.hpp"
\ No newline at end of file
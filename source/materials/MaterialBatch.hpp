@@ -0,0 +1,248 @@
+/**
+ * @file MaterialBatch.hpp
+ * @brief the batched, statically-dispatched interface for updating many points of the same uniaxial material model at once.
+ */
+
+#ifndef MATERIAL_BATCH_HPP
+#define MATERIAL_BATCH_HPP
+#include <vector>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include "maths_defaults.hpp"
+#include "binary_io.hpp"
+#include "ElasticPlasticMaterial.hpp"
+#include "MenegottoPintoMaterial.hpp"
+
+/**
+ * @brief the starting and current states of a batch of points that share a material model, updated by one loop over the model's static kernel.
+ * @details a material model used with this class provides:
+ * - a `Parameters` struct of the reference properties;
+ * - a `State` struct that is, or derives from, \ref MaterialState;
+ * - `static State initial_state(const Parameters&)`;
+ * - `static void increment(const Parameters&, const State& start, State& cur, real d_eps)`, which must only depend on its arguments;
+ * - `static constexpr bool has_linear_elastic_range`;
+ * - a `CompactState` struct with a `float stress`, and `static CompactState compress(const State&)` and `static State expand(const Parameters&, const CompactState&)` for \ref set_compact_storage.
+ *
+ * The kernel is called directly, not through a virtual function, so it is inlined into the loop over the batch.
+ * The parameters are not held by the batch, as they are usually shared between many batches; see \ref SharedFibreGeometry.
+ * @tparam MaterialModel the material model, e.g. \ref ElasticPlasticMaterial or \ref MenegottoPintoMaterial.
+ */
+template <typename MaterialModel>
+class MaterialBatch {
+    public:
+        using Model = MaterialModel;
+        using Parameters = typename Model::Parameters;
+        using State = typename Model::State;
+        using CompactState = typename Model::CompactState;
+
+    protected:
+        std::vector<State> starting; /**< committed state of each point; empty in compact storage mode.*/
+        std::vector<CompactState> compact_starting; /**< committed state of each point in compact storage mode; empty otherwise.*/
+        std::vector<State> current; /**< trial state of each point. Always in full precision.*/
+        std::vector<real> strain_increments; /**< strain increment of each point from its starting state; filled by the caller through \ref get_strain_increments.*/
+        bool compact_storage = false; /**< whether the committed states are held in \ref compact_starting.*/
+        real max_stress_rounding = 0.0; /**< largest \f$|\sigma - \mathrm{float}(\sigma)|\f$ committed in compact storage mode.*/
+
+    public:
+        /**
+         * @brief sets the batch to the given starting states.
+         */
+        void initialise(std::span<const State> initial_states)
+        {
+            current.assign(initial_states.begin(), initial_states.end());
+            strain_increments.assign(current.size(), 0.0);
+            starting.clear();
+            compact_starting.clear();
+            commit();
+        }
+
+        /**
+         * @brief appends a point to the batch in the given state.
+         */
+        void add_point(const State& state)
+        {
+            current.push_back(state);
+            strain_increments.push_back(0.0);
+            if (compact_storage)
+                compact_starting.push_back(Model::compress(state));
+            else
+                starting.push_back(state);
+        }
+
+        /**
+         * @brief switches the storage of the committed states between full and single precision.
+         * @details only the committed history is compact: the kernel expands each starting state into registers, and the current states, strain increments, and anything integrated from them stay in full precision.
+         * Halves the memory streamed for the starting states; the price is a rounding of the committed state to float at each commit, i.e. a relative error of about \f$6\times10^{-8}\f$ per committed step, which is tracked by \ref get_max_stress_rounding.
+         * @param compact true to store the committed states compactly.
+         * @param parameters the reference properties of each point, needed to expand compact states.
+         */
+        void set_compact_storage(bool compact, std::span<const Parameters> parameters)
+        {
+            if (compact == compact_storage)
+                return;
+            if (compact)
+            {
+                compact_starting.resize(starting.size());
+                for (size_t i = 0; i < starting.size(); ++i)
+                    compact_starting[i] = Model::compress(starting[i]);
+                starting.clear();
+                starting.shrink_to_fit();
+            } else {
+                starting.resize(compact_starting.size());
+                for (size_t i = 0; i < compact_starting.size(); ++i)
+                    starting[i] = Model::expand(parameters[i], compact_starting[i]);
+                compact_starting.clear();
+                compact_starting.shrink_to_fit();
+            }
+            compact_storage = compact;
+        }
+
+        /**
+         * @brief the strain increments that are applied by the next call to \ref increment_strains.
+         */
+        std::span<real> get_strain_increments() {return strain_increments;}
+
+        /**
+         * @brief calculates the current state of every point from its starting state and strain increment.
+         * @param parameters the reference properties of each point, in the same order as the states.
+         */
+        void increment_strains(std::span<const Parameters> parameters)
+        {
+            if (parameters.size() != current.size())
+            {
+                std::cout << "MaterialBatch::increment_strains got " << parameters.size() << " parameters for " << current.size() << " points." << std::endl;
+                exit(1);
+            }
+            if (compact_storage)
+            {
+                for (size_t i = 0; i < current.size(); ++i)
+                {
+                    const State start = Model::expand(parameters[i], compact_starting[i]);
+                    Model::increment(parameters[i], start, current[i], strain_increments[i]);
+                }
+            } else {
+                for (size_t i = 0; i < current.size(); ++i)
+                {
+                    Model::increment(parameters[i], starting[i], current[i], strain_increments[i]);
+                }
+            }
+        }
+
+        /**
+         * @brief commits the current states as the starting states.
+         */
+        void commit()
+        {
+            if (!compact_storage)
+            {
+                starting = current;
+                return;
+            }
+            compact_starting.resize(current.size());
+            for (size_t i = 0; i < current.size(); ++i)
+            {
+                compact_starting[i] = Model::compress(current[i]);
+                max_stress_rounding = std::max(max_stress_rounding, std::abs(current[i].stress - static_cast<real>(compact_starting[i].stress)));
+            }
+        }
+
+        /**
+         * @brief discards the current states by restoring the starting states.
+         * @param parameters the reference properties of each point, needed to expand compact states.
+         */
+        void revert(std::span<const Parameters> parameters)
+        {
+            if (!compact_storage)
+            {
+                current = starting;
+                return;
+            }
+            for (size_t i = 0; i < current.size(); ++i)
+                current[i] = Model::expand(parameters[i], compact_starting[i]);
+        }
+
+        /**
+         * @brief writes the committed states of the batch in whichever precision they are stored.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary(out, compact_storage);
+            if (compact_storage)
+                write_binary_span<CompactState>(out, compact_starting);
+            else
+                write_binary_span<State>(out, starting);
+        }
+
+        /**
+         * @brief reads committed states written by \ref write_checkpoint, adopting their storage mode, and resets the current states to them.
+         * @param parameters the reference properties of each point, needed to expand compact states.
+         */
+        void read_checkpoint(std::istream& in, std::span<const Parameters> parameters)
+        {
+            read_binary(in, compact_storage);
+            if (compact_storage)
+            {
+                starting.clear();
+                read_binary_vector(in, compact_starting);
+                current.resize(compact_starting.size());
+            } else {
+                compact_starting.clear();
+                read_binary_vector(in, starting);
+                current.resize(starting.size());
+            }
+            if (current.size() != parameters.size())
+            {
+                std::cout << "MaterialBatch::read_checkpoint read " << current.size() << " states for " << parameters.size() << " points." << std::endl;
+                exit(1);
+            }
+            strain_increments.assign(current.size(), 0.0);
+            revert(parameters);
+        }
+
+        size_t size() const {return current.size();}
+        bool is_compact() const {return compact_storage;}
+
+        /**
+         * @brief Get the largest rounding of a committed stress in compact storage mode.
+         */
+        real get_max_stress_rounding() const {return max_stress_rounding;}
+
+        /**
+         * @brief Get the starting state of point \p i, expanding it if stored compactly.
+         */
+        State get_starting_state(size_t i, const Parameters& parameters) const
+        {
+            return compact_storage ? Model::expand(parameters, compact_starting[i]) : starting[i];
+        }
+        const std::vector<State>& get_current_states() const {return current;}
+};
+
+/**
+ * @brief a tuple holding one `C<Model>` for every material model that can be used in a section, in a fixed order.
+ * @details new material models are added to this list; sections then handle them without further changes.
+ */
+template <template <typename> class C>
+using PerMaterialModel = std::tuple<C<ElasticPlasticMaterial>, C<MenegottoPintoMaterial>>;
+
+constexpr size_t NUM_MATERIAL_MODELS = std::tuple_size_v<PerMaterialModel<MaterialBatch>>; /**< number of material models in \ref PerMaterialModel.*/
+
+/**
+ * @brief calls \p f once per material model with the matching entry of each \ref PerMaterialModel tuple.
+ *
+ * @param f a generic callable taking one argument per tuple.
+ * @param tuples one or more \ref PerMaterialModel tuples.
+ */
+template <typename Function, typename... Tuples>
+void for_each_material_model(Function&& f, Tuples&... tuples)
+{
+    auto call_for_model = [&]<size_t I>() {f(std::get<I>(tuples)...);};
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (call_for_model.template operator()<I>(), ...);
+    }(std::make_index_sequence<NUM_MATERIAL_MODELS>{});
+}
+
+#endif // MATERIAL_BATCH_HPP
@@ -0,0 +1 @@
+#include "MenegottoPintoMaterial.hpp"
\ No newline at end of file
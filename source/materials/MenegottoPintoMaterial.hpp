@@ -0,0 +1,179 @@
+/**
+ * @file MenegottoPintoMaterial.hpp
+ * @brief class definition of the Menegotto-Pinto uniaxial steel material.
+ */
+
+#ifndef MENEGOTTO_PINTO_MATERIAL_HPP
+#define MENEGOTTO_PINTO_MATERIAL_HPP
+#include <cmath>
+#include "maths_defaults.hpp"
+#include "Material1D.hpp"
+
+/**
+ * @brief the Menegotto-Pinto steel model with the Filippou et al. (1983) curvature degradation and no isotropic hardening.
+ * @details the stress follows a smooth transition between the elastic line through the last reversal point \f$(\varepsilon_r, \sigma_r)\f$ and the
+ * hardening asymptote of slope \f$bE_0\f$, which intersect at \f$(\varepsilon_0, \sigma_0)\f$:
+ *
+ * \f$ \varepsilon^* = \frac{\varepsilon - \varepsilon_r}{\varepsilon_0 - \varepsilon_r}, \quad \sigma^* = b\varepsilon^* + \frac{(1 - b)\varepsilon^*}{(1 + |\varepsilon^*|^R)^{1/R}}, \quad \sigma = \sigma_r + \sigma^*(\sigma_0 - \sigma_r)\f$
+ *
+ * with \f$ R = R_0 - \frac{c_{R1}\xi}{c_{R2} + \xi}\f$ updated at each reversal from \f$\xi = |\varepsilon_r - \varepsilon_0^{prev}|/\varepsilon_y\f$.
+ * The model has no linear elastic range, so sections with these fibres never take the closed-form elastic update.
+ * Only the static \ref increment is used by sections, through \ref MaterialBatch; the object interface is a thin per-point wrapper.
+ */
+class MenegottoPintoMaterial {
+public:
+    /**
+     * @brief the reference properties of the material, which do not change during the analysis.
+     */
+    struct Parameters {
+        real E0; /**< Initial Young's modulus.*/
+        real fy; /**< Yield strength.*/
+        real b; /**< strain-hardening ratio; the slope of the asymptotes is \f$bE_0\f$. Must be less than 1.*/
+        real R0 = 20.0; /**< initial curvature parameter of the transition.*/
+        real cR1 = 18.5; /**< first curvature degradation parameter.*/
+        real cR2 = 0.15; /**< second curvature degradation parameter.*/
+    };
+
+    /**
+     * @brief the state of a point; extends \ref MaterialState with the current branch of the curve.
+     */
+    struct State : MaterialState {
+        real strain_r = 0.0; /**< strain at the last reversal \f$\varepsilon_r\f$.*/
+        real stress_r = 0.0; /**< stress at the last reversal \f$\sigma_r\f$.*/
+        real strain_0 = 0.0; /**< strain at the asymptote intersection \f$\varepsilon_0\f$.*/
+        real stress_0 = 0.0; /**< stress at the asymptote intersection \f$\sigma_0\f$.*/
+        real R = 20.0; /**< curvature parameter of the current branch.*/
+        int direction = 0; /**< sign of the strain increments on the current branch; zero for a virgin point.*/
+    };
+    static constexpr bool has_linear_elastic_range = false; /**< the transition curve starts softening immediately.*/
+
+    /**
+     * @brief the committed state of a point in single precision, used by \ref MaterialBatch in compact storage mode. The constant and derived variables are recovered from \ref Parameters.
+     */
+    struct CompactState {
+        float stress;
+        float strain;
+        float E_t;
+        float strain_r;
+        float stress_r;
+        float strain_0;
+        float stress_0;
+        float R;
+        signed char direction;
+    };
+
+protected:
+    Parameters parameters;
+    State current; /**< Current (trial) state of the material.*/
+    State starting; /**< State of the material at the start of the load step.*/
+
+public:
+    MenegottoPintoMaterial() = default;
+    MenegottoPintoMaterial(const Parameters& p) : parameters(p), current(initial_state(p)), starting(initial_state(p)) {}
+
+    /**
+     * @brief the virgin state of a point with properties \p p.
+     */
+    static State initial_state(const Parameters& p)
+    {
+        State s;
+        s.E = p.E0;
+        s.E_t = p.E0;
+        s.fy = p.fy;
+        s.fy_bar = p.fy;
+        s.elastic = false;
+        s.R = p.R0;
+        return s;
+    }
+
+    /**
+     * @brief rounds a state to its compact form.
+     */
+    static CompactState compress(const State& s)
+    {
+        return CompactState{static_cast<float>(s.stress), static_cast<float>(s.strain), static_cast<float>(s.E_t),
+                            static_cast<float>(s.strain_r), static_cast<float>(s.stress_r), static_cast<float>(s.strain_0), static_cast<float>(s.stress_0),
+                            static_cast<float>(s.R), static_cast<signed char>(s.direction)};
+    }
+
+    /**
+     * @brief recovers a full state from its compact form.
+     */
+    static State expand(const Parameters& p, const CompactState& c)
+    {
+        State s = initial_state(p);
+        s.stress = c.stress;
+        s.strain = c.strain;
+        s.E_t = c.E_t;
+        s.plastic_strain = s.strain - s.stress/p.E0;
+        s.strain_r = c.strain_r;
+        s.stress_r = c.stress_r;
+        s.strain_0 = c.strain_0;
+        s.stress_0 = c.stress_0;
+        s.R = c.R;
+        s.direction = c.direction;
+        return s;
+    }
+
+    /**
+     * @brief increments the total strain of one point from its starting state.
+     * @details a strain increment opposite to the direction of the starting branch is a reversal: the starting point becomes \f$(\varepsilon_r, \sigma_r)\f$, \f$R\f$ is degraded, and the new asymptote intersection is found from
+     * \f$ \varepsilon_0 = \frac{d f_y (1 - b) - \sigma_r + E_0\varepsilon_r}{E_0(1 - b)}\f$ and \f$\sigma_0 = \sigma_r + E_0(\varepsilon_0 - \varepsilon_r)\f$ for the direction \f$d = \pm 1\f$.
+     * @param p the reference properties of the point.
+     * @param start the starting state of the point.
+     * @param cur the current state of the point, overwritten.
+     * @param d_eps the increment in total strain from the starting state.
+     */
+    static void increment(const Parameters& p, const State& start, State& cur, real d_eps)
+    {
+        cur = start;
+        if (d_eps == 0.0)
+            return;
+        int d = (d_eps > 0.0) ? 1 : -1;
+        if (d != start.direction)
+        {
+            if (start.direction != 0)
+            {
+                real xi = std::abs(start.strain - start.strain_0)*p.E0/p.fy;
+                cur.R = p.R0 - p.cR1*xi/(p.cR2 + xi);
+            }
+            cur.direction = d;
+            cur.strain_r = start.strain;
+            cur.stress_r = start.stress;
+            cur.strain_0 = (d*p.fy*(1 - p.b) - cur.stress_r + p.E0*cur.strain_r)/(p.E0*(1 - p.b));
+            cur.stress_0 = cur.stress_r + p.E0*(cur.strain_0 - cur.strain_r);
+        }
+        cur.strain = start.strain + d_eps;
+        real strain_star = (cur.strain - cur.strain_r)/(cur.strain_0 - cur.strain_r);
+        real transition = 1 + std::pow(std::abs(strain_star), cur.R);
+        real stress_star = p.b*strain_star + (1 - p.b)*strain_star/std::pow(transition, 1/cur.R);
+        cur.stress = cur.stress_r + stress_star*(cur.stress_0 - cur.stress_r);
+        cur.E_t = p.E0*(p.b + (1 - p.b)/std::pow(transition, 1 + 1/cur.R)); // (sigma_0 - sigma_r)/(eps_0 - eps_r) = E0
+        cur.plastic_strain = cur.strain - cur.stress/p.E0;
+    }
+
+    /**
+     * @brief increments the total strain from the starting state.
+     * @param d_eps the increment in total strain.
+     */
+    void increment_strain(real d_eps) {increment(parameters, starting, current, d_eps);}
+
+    /**
+     * @brief commits the current state as the starting state.
+     */
+    void commit_state() {starting = current;}
+
+    /**
+     * @brief discards the current state by restoring the starting state.
+     */
+    void revert_state() {current = starting;}
+
+    const Parameters& get_parameters() const {return parameters;}
+    const State& get_starting_state() const {return starting;}
+    const State& get_current_state() const {return current;}
+    real get_stress() const {return current.stress;}
+    real get_strain() const {return current.strain;}
+    real get_E_t() const {return current.E_t;}
+};
+
+#endif // MENEGOTTO_PINTO_MATERIAL_HPP
@@ -6,12 +6,17 @@
 #ifndef BEAM_COLUMN_FIBER_SECTION_HPP
 #define BEAM_COLUMN_FIBER_SECTION_HPP
 #include <memory>
+#include <cmath>
+#include <algorithm>
+#include <span>
+#include <type_traits>
 
 #include "maths_defaults.hpp"
 #include "SectionTypes.hpp"
-#include "MaterialFibre.hpp"
 #include "Material1D.hpp"
 #include "ElasticPlasticMaterial.hpp"
+#include "MaterialBatch.hpp"
+#include "SharedFibreGeometry.hpp"
 #include "SectionBaseClass.hpp"
 
 /**
@@ -20,23 +25,162 @@
  */
 class BeamColumnFiberSection : public SectionBaseClass {
     protected:
-        real section_area; /**<total area of the section - combined area of all fibres.*/ 
-        real weighted_E; /**<an equivalent Young's modulus taken as the weighted mean of all fibres.*/
+        real section_area = 0.0; /**<total area of the section - combined area of all fibres.*/ 
+        real weighted_E = 0.0; /**<an equivalent Young's modulus taken as the weighted mean of all fibres.*/
         
-        std::vector<MaterialFibre> fibres; /**<a vector containing all fibres of the cross-section.*/
+        std::shared_ptr<SharedFibreGeometry> geometry = std::make_shared<SharedFibreGeometry>(); /**< fibre layout and reference materials shared with all copies of this section.*/
+        PerMaterialModel<MaterialBatch> batches; /**< this section's own fibre states, one batch per material model in the same order as the groups of \ref geometry; empty until \ref materialise_fibres is called.*/
+        bool compact_state_storage = false; /**< whether the committed fibre states are stored in single precision; see \ref set_compact_state_storage.*/
+        bool fibres_materialised = false; /**< whether \ref batches holds the fibre states, or they are still implied by the section strains and \ref geometry.*/
         
-        real moment_yy; /**< the moment of the section about its y axis.*/
-        real axial_force; /**< the axial force in the section.*/
+        real moment_yy = 0.0; /**< the moment of the section about its y axis.*/
+        real axial_force = 0.0; /**< the axial force in the section.*/
 
-        real axial_strain; /**< Current axial strain \f$\varepsilon_{axial}\f$.*/
-        real curvature;  /**< Current curvature \f$\kappa\f$.*/
+        real axial_strain = 0.0; /**< Current axial strain \f$\varepsilon_{axial}\f$.*/
+        real curvature = 0.0;  /**< Current curvature \f$\kappa\f$.*/
         
-        real starting_axial_strain; /**< Current axial strain \f$\varepsilon_{axial}\f$.*/
-        real starting_curvature;  /**< Current curvature \f$\kappa\f$.*/
+        real starting_axial_strain = 0.0; /**< Current axial strain \f$\varepsilon_{axial}\f$.*/
+        real starting_curvature = 0.0;  /**< Current curvature \f$\kappa\f$.*/
 
-        real y_bar; /**< distance to the centroid of the section relative to the plane at which y = 0.*/
+        real y_bar = 0.0; /**< distance to the centroid of the section relative to the plane at which y = 0.*/
 
         mat  D_t = make_xd_mat(2,2); /**< the 2x2 tangent constitutive matrix of the section.*/
+
+        /**
+         * @name elastic fast path
+         * @brief section-level quantities of the starting state that allow \ref update_section_state to skip the fibre loops while no fibre can yield.
+         * @details refreshed by \ref refresh_elastic_state whenever the starting state changes.
+         */
+        //@{
+        bool use_elastic_fast_path = true; /**< whether the closed-form elastic update may be used at all.*/
+        bool elastic_state_valid = false; /**< whether the members below describe the current starting state.*/
+        bool all_elastic = false; /**< true if every fibre is elastic at the starting state with \f$E_t = E\f$.*/
+        bool fibres_behind = false; /**< true if the last state update used the fast path, so the fibre states have not yet been incremented.*/
+        real elastic_EA = 0.0; /**< \f$\sum A_i E_i\f$ at the starting state.*/
+        real elastic_EI = 0.0; /**< \f$\sum A_i E_i (y_i - \bar{y})^2\f$ at the starting state.*/
+        real elastic_y_bar = 0.0; /**< elastic centroid \f$\bar{y} = \sum A_i E_i y_i/\sum A_i E_i\f$.*/
+        real starting_axial_force = 0.0; /**< axial force from the starting fibre stresses.*/
+        real starting_moment_yy = 0.0; /**< moment from the starting fibre stresses about \ref elastic_y_bar.*/
+        real max_starting_stress = 0.0; /**< largest \f$|\sigma_i|\f$ at the starting state.*/
+        real max_E = 0.0; /**< largest fibre Young's modulus.*/
+        real min_fy_bar = 0.0; /**< smallest fibre yield stress \f$\bar{\sigma}_y\f$ at the starting state.*/
+        real max_fibre_distance = 0.0; /**< largest \f$|y_i - \bar{y}|\f$.*/
+        int num_fast_updates = 0; /**< number of state updates that used the fast path.*/
+        //@}
+
+        /**
+         * @brief recomputes the elastic fast-path quantities for the starting state.
+         * @details a section without its own fibres has only ever been strained elastically from the shared initial state, so the quantities follow from \ref geometry and the starting strains without visiting the fibres. Otherwise they are gathered from the fibre starting states in a single pass.
+         */
+        void refresh_elastic_state()
+        {
+            elastic_state_valid = true;
+            if (!fibres_materialised)
+            {
+                all_elastic = geometry->all_elastic;
+                elastic_EA = geometry->EA;
+                elastic_EI = geometry->EI;
+                elastic_y_bar = geometry->y_bar;
+                starting_axial_force = geometry->axial_force + elastic_EA*starting_axial_strain;
+                starting_moment_yy = geometry->moment_yy + elastic_EI*starting_curvature;
+                max_E = geometry->max_E;
+                max_fibre_distance = geometry->max_fibre_distance;
+                max_starting_stress = geometry->max_stress + max_E*(std::abs(starting_axial_strain) + max_fibre_distance*std::abs(starting_curvature));
+                min_fy_bar = geometry->min_fy_bar;
+                if (all_elastic)
+                {
+                    section_area = geometry->area;
+                    weighted_E = (section_area > 0.0) ? elastic_EA/section_area : 0.0;
+                }
+                return;
+            }
+            all_elastic = true;
+            real area = 0.0, EA = 0.0, ES = 0.0;
+            max_starting_stress = 0.0;
+            max_E = 0.0;
+            min_fy_bar = INFINITY;
+            for_each_material_model([&](const auto& group, const auto& batch) {
+                using Model = typename std::decay_t<decltype(group)>::Model;
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    const auto state = batch.get_starting_state(i, group.parameters[i]);
+                    real A_i = group.areas[i];
+                    all_elastic = all_elastic && Model::has_linear_elastic_range && state.elastic && state.E_t == state.E;
+                    area += A_i;
+                    EA += A_i*state.E;
+                    ES += A_i*state.E*group.ys[i];
+                    max_starting_stress = std::max(max_starting_stress, std::abs(state.stress));
+                    max_E = std::max(max_E, state.E);
+                    min_fy_bar = std::min(min_fy_bar, state.fy_bar);
+                }
+            }, geometry->groups, batches);
+            elastic_EA = EA;
+            elastic_y_bar = ES/EA;
+            elastic_EI = 0.0;
+            starting_axial_force = 0.0;
+            starting_moment_yy = 0.0;
+            max_fibre_distance = 0.0;
+            for_each_material_model([&](const auto& group, const auto& batch) {
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    const auto state = batch.get_starting_state(i, group.parameters[i]);
+                    real y_i = group.ys[i] - elastic_y_bar;
+                    real A_i = group.areas[i];
+                    real stress_i = state.stress;
+                    elastic_EI += A_i*state.E*y_i*y_i;
+                    starting_axial_force += A_i*stress_i;
+                    starting_moment_yy -= A_i*stress_i*y_i;
+                    max_fibre_distance = std::max(max_fibre_distance, std::abs(y_i));
+                }
+            }, geometry->groups, batches);
+            if (all_elastic)
+            {
+                section_area = area;
+                weighted_E = EA/area;
+            }
+        }
+
+        /**
+         * @brief calls \p f for each material model with its fibre group and the current fibre states: this section's own states if materialised, and the shared initial states otherwise.
+         * @param f a generic callable taking the \ref FibreGroup and a `std::span` of its states.
+         */
+        template <typename Function>
+        void for_each_fibre_state(Function&& f) const
+        {
+            for_each_material_model([&](const auto& group, const auto& batch) {
+                using State = typename std::decay_t<decltype(group)>::State;
+                std::span<const State> states = fibres_materialised ? std::span<const State>(batch.get_current_states()) : std::span<const State>(group.initial_states);
+                f(group, states);
+            }, geometry->groups, batches);
+        }
+
+        /**
+         * @brief checks with a section-level bound whether any fibre could reach its yield stress under the current strains.
+         * @details for an elastic starting state each trial stress is \f$\sigma_i = \sigma_{i,0} + E_i(\Delta\varepsilon - (y_i - \bar{y})\Delta\kappa)\f$, so \f$|\sigma_i| \leq \max|\sigma_{i,0}| + \max E_i (|\Delta\varepsilon| + \max|y_i - \bar{y}||\Delta\kappa|)\f$, and the section stays elastic if this is below \ref min_fy_bar.
+         */
+        bool stays_elastic() const
+        {
+            real d_axial_strain = axial_strain - starting_axial_strain;
+            real d_curvature = curvature - starting_curvature;
+            real stress_bound = max_starting_stress + max_E*(std::abs(d_axial_strain) + max_fibre_distance*std::abs(d_curvature));
+            return stress_bound < min_fy_bar;
+        }
+
+        /**
+         * @brief closed-form section update for an elastic section: \f$N = N_0 + EA\Delta\varepsilon\f$, \f$M = M_0 + EI\Delta\kappa\f$, and \f$\boldsymbol{D}_t = \mathrm{diag}(EA, EI)\f$ about the elastic centroid.
+         */
+        void update_elastic_section_state()
+        {
+            y_bar = elastic_y_bar;
+            axial_force = starting_axial_force + elastic_EA*(axial_strain - starting_axial_strain);
+            moment_yy = starting_moment_yy + elastic_EI*(curvature - starting_curvature);
+            D_t(0,0) = elastic_EA;
+            D_t(1,1) = elastic_EI;
+            D_t(0,1) = 0.0;
+            D_t(1,0) = 0.0;
+            fibres_behind = fibres_materialised;
+            ++num_fast_updates;
+        }
         
     public:
         BeamColumnFiberSection() 
@@ -45,20 +189,19 @@ class BeamColumnFiberSection : public SectionBaseClass {
         };
 
         /**
-         * @brief a copy-constructor for the fibre that allows us to copy the material object pointed to by the unique_ptr.
+         * @brief a copy-constructor that shares the fibre geometry with the copied section, and only copies the fibre states if it has its own.
          * 
-         * @param other The MaterialFibre object to be copied.
+         * @param other The BeamColumnFiberSection object to be copied.
          */
         BeamColumnFiberSection(const BeamColumnFiberSection& other)
         {
             section_type = other.section_type;
             section_area = other.section_area;
             weighted_E = other.weighted_E;
-            fibres.reserve(other.fibres.size());
-            for (const auto& fibre : other.fibres)
-            {
-                fibres.emplace_back(MaterialFibre(fibre));
-            }
+            geometry = other.geometry;
+            fibres_materialised = other.fibres_materialised;
+            batches = other.batches;
+            compact_state_storage = other.compact_state_storage;
             moment_yy = other.moment_yy;
             axial_force = other.axial_force;
             axial_strain = other.axial_strain;
@@ -67,14 +210,44 @@ class BeamColumnFiberSection : public SectionBaseClass {
             starting_curvature = other.starting_curvature;
             y_bar = other.y_bar;
             D_t = other.D_t;
+            use_elastic_fast_path = other.use_elastic_fast_path;
+            elastic_state_valid = false;
+            fibres_behind = other.fibres_behind;
         }
 
+        /**
+         * @brief gives this section its own fibre states by copying the shared initial fibres and straining them elastically to the starting state. Does nothing if the section already has its own fibres.
+         * @details until this is called the starting state is fully described by the starting strains, as the section has only been strained elastically from the initial state of \ref geometry.
+         */
+        void materialise_fibres()
+        {
+            if (fibres_materialised)
+                return;
+            bool strained = starting_axial_strain != 0.0 || starting_curvature != 0.0;
+            for_each_material_model([&](const auto& group, auto& batch) {
+                batch.initialise(group.initial_states);
+                if (strained)
+                {
+                    std::span<real> strain_increments = batch.get_strain_increments();
+                    for (size_t i = 0; i < group.size(); ++i)
+                    {
+                        strain_increments[i] = starting_axial_strain - (group.ys[i] - geometry->y_bar)*starting_curvature;
+                    }
+                    batch.increment_strains(group.parameters);
+                    batch.commit();
+                }
+            }, geometry->groups, batches);
+            fibres_materialised = true;
+            fibres_behind = false;
+            elastic_state_valid = false;
+        }
 
         /**
          * @brief populates the fibre vector of the section.
          * 
          * @tparam stl_container an STL-compatible container such as a std::vector. Needs to have an interator.
-         * @param mat a pointer to a material object that will be copied into each fibre.
+         * @tparam MaterialType a material model listed in \ref PerMaterialModel.
+         * @param mat a pointer to a material object whose properties and starting state are copied into each fibre.
          * @param areas the area of each fibre.
          * @param ys the y-coordinate of each fibre in order.
          */
@@ -86,13 +259,26 @@ class BeamColumnFiberSection : public SectionBaseClass {
                 std::cout << "BeamColumnFiberSection::add_fibres can only take equally-sized input arrays. sizes of area and ys are: " << areas.size() << ", " << ys.size() << "." << std::endl;
                 exit(1);
             }
+            if (geometry.use_count() > 1)
+            {
+                // copy-on-write: other sections keep the geometry they were created with.
+                geometry = std::make_shared<SharedFibreGeometry>(*geometry);
+            }
+            auto& group = std::get<FibreGroup<MaterialType>>(geometry->groups);
+            auto& batch = std::get<MaterialBatch<MaterialType>>(batches);
+            const typename MaterialType::Parameters parameters = mat->get_parameters();
+            const typename MaterialType::State state = mat->get_starting_state();
             auto y_iterator = ys.begin();
             
             for (auto area: areas)
             {
-                fibres.emplace_back(MaterialFibre(mat, area, *y_iterator));
+                group.add_fibre(area, *y_iterator, parameters, state);
+                if (fibres_materialised)
+                    batch.add_point(state);
                 ++y_iterator;
             }
+            geometry->calc_elastic_properties();
+            elastic_state_valid = false;
         }
 
         /**
@@ -116,13 +302,17 @@ class BeamColumnFiberSection : public SectionBaseClass {
         {
             real d_axial_strain = axial_strain - starting_axial_strain;
             real d_curvature = curvature - starting_curvature;
+            materialise_fibres();
 
-            // careful - since each fibre has a unique_ptr, it cannot be copied and so must be accessed by reference even in the loop.
-            for (auto& fibre : fibres)
-            {
-                real strain_increment = d_axial_strain - (fibre.get_y() - y_bar)*d_curvature; // the minus sign is as per Izzuddin's notation.
-                fibre.material_ptr->increment_strain(strain_increment);
-            }
+            // the strain increments of each material model are filled in, then its whole batch is updated by one statically-dispatched loop.
+            for_each_material_model([&](const auto& group, auto& batch) {
+                std::span<real> strain_increments = batch.get_strain_increments();
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    strain_increments[i] = d_axial_strain - (group.ys[i] - y_bar)*d_curvature; // the minus sign is as per Izzuddin's notation.
+                }
+                batch.increment_strains(group.parameters);
+            }, geometry->groups, batches);
         }
 
         /**
@@ -131,15 +321,17 @@ class BeamColumnFiberSection : public SectionBaseClass {
          */
         void calc_section_forces()
         {
+            materialise_fibres();
             axial_force = 0.0;
             moment_yy = 0.0;
-            for (auto& fibre : fibres)
-            {
-                // std::cout << "fibre y = " << fibre.get_y() << " has area " << fibre.get_area() << " and has stress = " << fibre.material_ptr->get_stress() << std::endl;
-                fibre.calc_force();
-                axial_force += fibre.get_force();
-                moment_yy += fibre.get_force()*-(fibre.get_y() - y_bar);
-            }
+            for_each_fibre_state([&](const auto& group, auto states) {
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    real force = group.areas[i]*states[i].stress;
+                    axial_force += force;
+                    moment_yy += force*-(group.ys[i] - y_bar);
+                }
+            });
         }
 
         /**
@@ -150,12 +342,14 @@ class BeamColumnFiberSection : public SectionBaseClass {
         {
             section_area = 0.0;
             real area_times_E = 0.0;
-            for (auto& fibre : fibres)
-            {
-                real fibre_area = fibre.get_area();
-                section_area += fibre_area;
-                area_times_E += fibre_area*fibre.material_ptr->get_E_t();
-            }
+            for_each_fibre_state([&](const auto& group, auto states) {
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    real fibre_area = group.areas[i];
+                    section_area += fibre_area;
+                    area_times_E += fibre_area*states[i].E_t;
+                }
+            });
             weighted_E = area_times_E/section_area;
         }
 
@@ -166,10 +360,12 @@ class BeamColumnFiberSection : public SectionBaseClass {
         void calc_section_centroid()
         {
             real area_moment = 0.0;
-            for (auto& fibre : fibres)
-            {
-                area_moment += fibre.get_y()*fibre.get_area()*(fibre.material_ptr->get_E_t());
-            }
+            for_each_fibre_state([&](const auto& group, auto states) {
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    area_moment += group.ys[i]*group.areas[i]*states[i].E_t;
+                }
+            });
             y_bar = area_moment/(section_area*weighted_E);
         }
 
@@ -191,30 +387,43 @@ class BeamColumnFiberSection : public SectionBaseClass {
         void calc_tan_contitutive_matrix()
         {             
             D_t.setZero();
-            for (auto& fibre : fibres)
-            {
-                real E_t_i = fibre.material_ptr->get_E_t();
-                real A_i = fibre.get_area();
-                real y_i = fibre.get_y();
-
-                D_t(0,0) = D_t(0,0) + A_i * E_t_i;
-                D_t(1,1) = D_t(1,1) + A_i * E_t_i * pow(y_i - y_bar, 2); 
-                D_t(1,0) = D_t(1,0) - A_i * E_t_i * (y_i - y_bar); 
-                D_t(0,1) = D_t(0,1) - A_i * E_t_i * (y_i - y_bar); 
-            }
+            for_each_fibre_state([&](const auto& group, auto states) {
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    real E_t_i = states[i].E_t;
+                    real A_i = group.areas[i];
+                    real y_i = group.ys[i];
+
+                    D_t(0,0) = D_t(0,0) + A_i * E_t_i;
+                    D_t(1,1) = D_t(1,1) + A_i * E_t_i * pow(y_i - y_bar, 2); 
+                    D_t(1,0) = D_t(1,0) - A_i * E_t_i * (y_i - y_bar); 
+                    D_t(0,1) = D_t(0,1) - A_i * E_t_i * (y_i - y_bar); 
+                }
+            });
         }
 
         /**
          * @brief applies updates the section state by applying an a strain vector after calculating the section centroid and incrementing the section strains. 
-         * 
+         * @details if all fibres are elastic at the starting state and \ref stays_elastic shows none can yield, the section forces and \ref D_t are found in closed form without visiting the fibres; the fibres are then only incremented when the state is committed by \ref update_section_starting_state, and a section that has never left the elastic range does not allocate fibres of its own at all.
          * @param epsilon a 2-row vector containing axial strain and curvature.
          */
         void update_section_state(vec& epsilon)
         {
+            set_section_strains(epsilon(0), epsilon(1));
+            if (use_elastic_fast_path)
+            {
+                if (!elastic_state_valid)
+                    refresh_elastic_state();
+                if (all_elastic && stays_elastic())
+                {
+                    update_elastic_section_state();
+                    return;
+                }
+            }
+            materialise_fibres();
+            fibres_behind = false;
             calc_area_weighted_E();
             calc_section_centroid();
-
-            set_section_strains(epsilon(0), epsilon(1));
             increment_fibre_strains();
             calc_section_forces();
             calc_tan_contitutive_matrix();
@@ -228,14 +437,114 @@ class BeamColumnFiberSection : public SectionBaseClass {
          */
         void update_section_starting_state()
         {
+            if (fibres_behind)
+            {
+                y_bar = elastic_y_bar;
+                increment_fibre_strains();
+                fibres_behind = false;
+            }
             starting_axial_strain = axial_strain;
             starting_curvature = curvature;
 
-            for (auto& fibre: fibres)
+            // a section without its own fibres is fully described by its starting strains.
+            for_each_material_model([](auto& batch) {batch.commit();}, batches);
+            elastic_state_valid = false;
+        }
+
+        /**
+         * @brief writes the committed state of the section: the starting strains and, if the section has its own fibres, their committed states.
+         */
+        void write_checkpoint(std::ostream& out) const
+        {
+            write_binary(out, starting_axial_strain);
+            write_binary(out, starting_curvature);
+            write_binary(out, fibres_materialised);
+            if (fibres_materialised)
+                for_each_material_model([&](const auto& batch) {batch.write_checkpoint(out);}, batches);
+        }
+
+        /**
+         * @brief restores a committed state written by \ref write_checkpoint into a section with the same fibres, and sets the current state to it.
+         * @details the section forces and \ref D_t are recalculated by the next call to \ref update_section_state.
+         */
+        void read_checkpoint(std::istream& in)
+        {
+            read_binary(in, starting_axial_strain);
+            read_binary(in, starting_curvature);
+            read_binary(in, fibres_materialised);
+            if (fibres_materialised)
             {
-                fibre.material_ptr->update_starting_state();
+                for_each_material_model([&](const auto& group, auto& batch) {batch.read_checkpoint(in, group.parameters);}, geometry->groups, batches);
+                compact_state_storage = std::get<0>(batches).is_compact();
+            } else {
+                for_each_material_model([&](const auto& group, auto& batch) {
+                    batch.initialise({});
+                    batch.set_compact_storage(compact_state_storage, group.parameters);
+                }, geometry->groups, batches);
             }
+            axial_strain = starting_axial_strain;
+            curvature = starting_curvature;
+            fibres_behind = false;
+            elastic_state_valid = false;
+        }
+
+        /**
+         * @brief switches the closed-form elastic update of \ref update_section_state on or off.
+         */
+        void set_elastic_fast_path(bool use_fast_path)
+        {
+            use_elastic_fast_path = use_fast_path;
+            elastic_state_valid = false;
+        }
+
+        /**
+         * @brief switches between full and single-precision storage of the committed fibre states; see \ref MaterialBatch::set_compact_storage.
+         * @details set on the section that is copied to the elements so that all copies inherit it. The section strains, current fibre states and section integrals remain in full precision.
+         */
+        void set_compact_state_storage(bool compact)
+        {
+            for_each_material_model([&](const auto& group, auto& batch) {batch.set_compact_storage(compact, group.parameters);}, geometry->groups, batches);
+            compact_state_storage = compact;
+            elastic_state_valid = false;
+        }
+
+        /**
+         * @brief Check if the committed fibre states are stored in single precision.
+         */
+        bool is_compact_state_storage() const { return compact_state_storage; }
+
+        /**
+         * @brief Get the largest rounding of a committed fibre stress caused by compact storage.
+         */
+        real get_max_stress_rounding() const
+        {
+            real max_rounding = 0.0;
+            for_each_material_model([&](const auto& batch) {max_rounding = std::max(max_rounding, batch.get_max_stress_rounding());}, batches);
+            return max_rounding;
+        }
+
+        /**
+         * @brief Check if all fibres were elastic at the starting state; only meaningful after a call to \ref update_section_state.
+         */
+        bool is_all_elastic() const { return all_elastic; }
+
+        /**
+         * @brief Get the number of state updates that used the elastic fast path.
+         */
+        int get_num_fast_updates() const { return num_fast_updates; }
+        /**
+         * @brief Get the largest accumulated plastic strain of any fibre in its current state.
+         */
+        real get_max_plastic_strain() const
+        {
+            real max_plastic_strain = 0.0;
+            for_each_fibre_state([&](const auto& group, auto states) {
+                for (size_t i = 0; i < group.size(); ++i)
+                    max_plastic_strain = std::max(max_plastic_strain, std::abs(states[i].plastic_strain));
+            });
+            return max_plastic_strain;
         }
+
         /**
          * @brief Get the total area of the section.
          * 
@@ -243,6 +552,23 @@ class BeamColumnFiberSection : public SectionBaseClass {
          */
         real get_section_area() const { return section_area; }
 
+        /**
+         * @brief Get the total area of the fibres. Unlike \ref get_section_area this does not rely on \ref calc_area_weighted_E having been called.
+         * 
+         * @return The sum of the fibre areas.
+         */
+        real get_A() override { return geometry->area; }
+
+        /**
+         * @brief Check if the section has its own fibre states rather than sharing the initial fibres.
+         */
+        bool has_own_fibres() const { return fibres_materialised; }
+
+        /**
+         * @brief Get the number of sections sharing this section's fibre geometry, including itself.
+         */
+        long get_geometry_use_count() const { return geometry.use_count(); }
+
         /**
          * @brief Get the equivalent Young's modulus of the section.
          * 
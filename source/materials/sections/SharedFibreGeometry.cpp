@@ -0,0 +1 @@
+#include "SharedFibreGeometry.hpp"
\ No newline at end of file
@@ -0,0 +1,114 @@
+/**
+ * @file SharedFibreGeometry.hpp
+ * @brief the fibre layout and reference materials that are shared by all copies of a \ref BeamColumnFiberSection.
+ * 
+ */
+#ifndef SHARED_FIBRE_GEOMETRY_HPP
+#define SHARED_FIBRE_GEOMETRY_HPP
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include "maths_defaults.hpp"
+#include "MaterialBatch.hpp"
+
+/**
+ * @brief the fibres of a section that use one material model, held as a structure of arrays.
+ * @tparam MaterialModel the material model of the fibres; see \ref MaterialBatch.
+ */
+template <typename MaterialModel>
+struct FibreGroup {
+    using Model = MaterialModel;
+    using Parameters = typename Model::Parameters;
+    using State = typename Model::State;
+
+    std::vector<real> areas; /**< the area of each fibre.*/
+    std::vector<real> ys; /**< the y-coordinate of each fibre.*/
+    std::vector<Parameters> parameters; /**< the material properties of each fibre.*/
+    std::vector<State> initial_states; /**< the initial material state of each fibre. Never strained.*/
+
+    void add_fibre(real area, real y, const Parameters& p, const State& state)
+    {
+        areas.push_back(area);
+        ys.push_back(y);
+        parameters.push_back(p);
+        initial_states.push_back(state);
+    }
+    size_t size() const {return areas.size();}
+};
+
+/**
+ * @brief the fibres of a section in their initial state along with the elastic section properties derived from them.
+ * @details a \ref BeamColumnFiberSection that is copied to every Gauss point of every element shares one instance of this object, so the fibre areas, coordinates and material constants are stored once. Sections only allocate their own fibres once they leave the elastic range; see \ref BeamColumnFiberSection::materialise_fibres.
+ */
+class SharedFibreGeometry {
+    public:
+        PerMaterialModel<FibreGroup> groups; /**< the fibres in their initial state, grouped by material model.*/
+        
+        real area = 0.0; /**< \f$\sum A_i\f$.*/
+        real EA = 0.0; /**< \f$\sum A_i E_i\f$.*/
+        real EI = 0.0; /**< \f$\sum A_i E_i (y_i - \bar{y})^2\f$.*/
+        real y_bar = 0.0; /**< elastic centroid \f$\bar{y} = \sum A_i E_i y_i/\sum A_i E_i\f$.*/
+        real axial_force = 0.0; /**< axial force of the initial fibre stresses.*/
+        real moment_yy = 0.0; /**< moment of the initial fibre stresses about \ref y_bar.*/
+        real max_stress = 0.0; /**< largest initial \f$|\sigma_i|\f$.*/
+        real max_E = 0.0; /**< largest fibre Young's modulus.*/
+        real min_fy_bar = 0.0; /**< smallest initial fibre yield stress.*/
+        real max_fibre_distance = 0.0; /**< largest \f$|y_i - \bar{y}|\f$.*/
+        bool all_elastic = true; /**< whether all fibres are initially elastic with \f$E_t = E\f$.*/
+
+        SharedFibreGeometry() = default;
+
+        /**
+         * @brief copies the fibres and the elastic properties.
+         */
+        SharedFibreGeometry(const SharedFibreGeometry& other) = default;
+
+        /**
+         * @brief recalculates the elastic section properties from the initial fibre states. Called whenever fibres are added.
+         */
+        void calc_elastic_properties()
+        {
+            all_elastic = true;
+            area = 0.0;
+            EA = 0.0;
+            real ES = 0.0;
+            max_stress = 0.0;
+            max_E = 0.0;
+            min_fy_bar = INFINITY;
+            for_each_material_model([&](const auto& group) {
+                using Model = typename std::decay_t<decltype(group)>::Model;
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    const auto& state = group.initial_states[i];
+                    real A_i = group.areas[i];
+                    all_elastic = all_elastic && Model::has_linear_elastic_range && state.elastic && state.E_t == state.E;
+                    area += A_i;
+                    EA += A_i*state.E;
+                    ES += A_i*state.E*group.ys[i];
+                    max_stress = std::max(max_stress, std::abs(state.stress));
+                    max_E = std::max(max_E, state.E);
+                    min_fy_bar = std::min(min_fy_bar, state.fy_bar);
+                }
+            }, groups);
+            y_bar = (EA > 0.0) ? ES/EA : 0.0;
+            EI = 0.0;
+            axial_force = 0.0;
+            moment_yy = 0.0;
+            max_fibre_distance = 0.0;
+            for_each_material_model([&](const auto& group) {
+                for (size_t i = 0; i < group.size(); ++i)
+                {
+                    real y_i = group.ys[i] - y_bar;
+                    real A_i = group.areas[i];
+                    real stress_i = group.initial_states[i].stress;
+                    EI += A_i*group.initial_states[i].E*y_i*y_i;
+                    axial_force += A_i*stress_i;
+                    moment_yy -= A_i*stress_i*y_i;
+                    max_fibre_distance = std::max(max_fibre_distance, std::abs(y_i));
+                }
+            }, groups);
+        }
+};
+
+#endif
@@ -0,0 +1,44 @@
+/**
+ * @file msh_to_blaze.cpp
+ * @brief converts the 2-noded line elements of a gmsh mesh file to the binary mesh format read by \ref BinaryMeshReader.
+ * usage: `msh_to_blaze input.msh output.blzmesh`
+ */
+#include <iostream>
+#include <vector>
+#include "gmsh.h"
+#include "BinaryMesh.hpp"
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout << "usage: " << argv[0] << " input.msh output.blzmesh" << std::endl;
+        return 1;
+    }
+    gmsh::initialize();
+    gmsh::open(argv[1]);
+
+    BinaryMeshData mesh;
+    std::vector<std::size_t> node_tags;
+    std::vector<double> node_coords, parametric_coords;
+    gmsh::model::mesh::getNodes(node_tags, node_coords, parametric_coords);
+    mesh.node_ids.assign(node_tags.begin(), node_tags.end());
+    mesh.node_coords.assign(node_coords.begin(), node_coords.end());
+
+    // gmsh element type 1 is the 2-noded line, the only element Blaze builds.
+    const int line_element_type = 1;
+    std::vector<std::size_t> elem_tags, elem_node_tags;
+    gmsh::model::mesh::getElementsByType(line_element_type, elem_tags, elem_node_tags);
+    gmsh::finalize();
+
+    mesh.elem_ids.assign(elem_tags.begin(), elem_tags.end());
+    mesh.elem_node_ids.assign(elem_node_tags.begin(), elem_node_tags.end());
+    for (size_t e = 0; e < elem_tags.size(); ++e)
+        mesh.elem_node_offsets.push_back(2*(e + 1));
+    mesh.elem_section_ids.assign(elem_tags.size(), 0);
+    mesh.elem_material_ids.assign(elem_tags.size(), 0);
+
+    write_binary_mesh(argv[2], mesh);
+    std::cout << "wrote " << mesh.num_nodes() << " nodes and " << mesh.num_elements() << " elements to " << argv[2] << std::endl;
+    return 0;
+}
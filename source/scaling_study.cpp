@@ -0,0 +1,82 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include "ScalingStudy.hpp"
+
+/**
+ * @brief options of the scaling harness; sets default values.
+ *
+ */
+struct ScalingOptions {
+    std::string spec_file = "";
+    bool run = true; // false only gathers the timers files of runs done before, e.g. by a batch job.
+    std::string output_file = "scaling_results.csv";
+    std::string baseline_file = ""; // a non-empty file name compares the results with an earlier dataset.
+    double tolerance = 0.1; // relative slowdown allowed against the baseline.
+    double min_duration = 1e-3; // timers shorter than this in the baseline are not compared.
+};
+
+/**
+ * @brief populates the options of the scaling harness; the first argument that is not an option is the sweep specification.
+ *
+ * @param argc
+ * @param argv
+ * @return ScalingOptions
+ */
+ScalingOptions parse_input(int argc, char* argv[]) {
+    ScalingOptions opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no_run") {
+            opts.run = false;
+        } else if (arg == "--output" && i + 1 < argc) {
+            opts.output_file = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            opts.baseline_file = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            opts.tolerance = std::stod(argv[++i]);
+        } else if (arg == "--min_duration" && i + 1 < argc) {
+            opts.min_duration = std::stod(argv[++i]);
+        } else if (arg.rfind("--", 0) != 0 && opts.spec_file.empty()) {
+            opts.spec_file = arg;
+        } else {
+            std::cout << "ignoring unknown option " << arg << "." << std::endl;
+        }
+    }
+    return opts;
+}
+
+int main (int argc, char* argv[]) {
+    ScalingOptions options = parse_input(argc, argv);
+    if (options.spec_file.empty())
+    {
+        std::cout << "usage: ScalingStudyBlaze <sweep file> [--no_run] [--output file] [--baseline file] [--tolerance fraction] [--min_duration seconds]" << std::endl;
+        return 1;
+    }
+    ScalingStudy study;
+    study.read_spec_file(options.spec_file);
+    if (options.run)
+        study.run_all();
+    study.analyse();
+
+    std::ofstream out(options.output_file);
+    if (!out)
+    {
+        std::cout << "Could not open output file " << options.output_file << std::endl;
+        return 1;
+    }
+    study.write_dataset(out);
+    std::cout << "wrote " << study.get_results().size() << " rows to " << options.output_file << std::endl;
+
+    if (!options.baseline_file.empty())
+    {
+        int num_regressions = study.check_against_baseline(options.baseline_file, options.tolerance, options.min_duration);
+        if (num_regressions > 0)
+        {
+            std::cout << num_regressions << " timers are more than " << 100*options.tolerance << "% slower than " << options.baseline_file << "." << std::endl;
+            return 1;
+        }
+        std::cout << "no timer is more than " << 100*options.tolerance << "% slower than " << options.baseline_file << "." << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,311 @@
+/**
+ * @file ExplicitDynamicsProcedure.hpp
+ * @brief defines the ExplicitDynamicsProcedure class which solves the equations of motion with the explicit central-difference method.
+ */
+
+#ifndef EXPLICIT_DYNAMICS_PROCEDURE_HPP
+#define EXPLICIT_DYNAMICS_PROCEDURE_HPP
+
+#include <cmath>
+#include <algorithm>
+#include "SolutionProcedure.hpp"
+
+/**
+ * @brief explicit central-difference time integration of \f$\boldsymbol{M}\ddot{\boldsymbol{U}} + \boldsymbol{C}\dot{\boldsymbol{U}} + \boldsymbol{R}(\boldsymbol{U}) = \boldsymbol{P}(t)\f$ with a diagonal lumped mass matrix.
+ *
+ * @details no stiffness matrix is assembled or factorised; each step only maps \f$\boldsymbol{U}\f$ to the nodes, updates the element states and assembles \f$\boldsymbol{R}\f$. Damping is mass-proportional, \f$\boldsymbol{C} = \alpha\boldsymbol{M}\f$, so the update remains diagonal:
+ * \f$ \dot{\boldsymbol{U}}_{n+1/2} = \frac{(1 - \alpha\Delta t/2)\dot{\boldsymbol{U}}_{n-1/2} + \Delta t\boldsymbol{M}^{-1}(\boldsymbol{P}_n - \boldsymbol{R}_n)}{1 + \alpha\Delta t/2}\f$ and \f$\boldsymbol{U}_{n+1} = \boldsymbol{U}_n + \Delta t\dot{\boldsymbol{U}}_{n+1/2}\f$.
+ * The loads are ramped linearly from zero to the maximum load factor over \ref load_ramp_time and then held.
+ * The stable time step is re-estimated from the current tangent stiffness every \ref stability_check_interval steps, as yielding or geometric stiffening change it during the analysis.
+ * In the distributed build \f$\boldsymbol{U}\f$ and \f$\boldsymbol{G}\f$ are the distributed Tpetra vectors of the \ref Assembler, and \ref M and \ref V_half hold the rows of the rank-owned DoFs, which is all the diagonal update needs.
+ */
+class ExplicitDynamicsProcedure : public SolutionProcedure
+{
+    protected:
+        real time = 0.0; /**< current analysis time.*/
+        real end_time = 0.0; /**< time at which the analysis stops.*/
+        real load_ramp_time = 0.0; /**< time over which the load factor is ramped up to \ref max_LF; zero applies the load suddenly.*/
+        real dt = 0.0; /**< time step; estimated from the stable time step if not given.*/
+        real dt_safety_factor = 0.9; /**< fraction of the stable time step used when \ref dt is estimated.*/
+        bool dt_estimated = false; /**< true if \ref dt was estimated rather than given, in which case it is reduced if the stable time step falls below it.*/
+        int stability_check_interval = 100; /**< the stable time step is re-estimated every this many steps; zero to estimate it only at the start.*/
+        real density = 0.0; /**< mass density used to compute element lumped masses.*/
+        real damping_alpha = 0.0; /**< mass-proportional damping coefficient \f$\alpha\f$.*/
+        int record_interval = 1; /**< results are written to the \ref Scribe every this many steps.*/
+
+        vec M; /**< diagonal lumped mass vector; only the rank-owned rows in the distributed build.*/
+        #ifndef WITH_MPI
+        vec U_n; /**< displacements at the current step.*/
+        #endif
+        vec V_half; /**< velocities at the last half step; only the rank-owned rows in the distributed build.*/
+        std::vector<real> recorded_times; /**< analysis time corresponding to each row written to the \ref Scribe.*/
+
+        #ifdef WITH_MPI
+        /**
+         * @brief Get \p v_owned, the values of a vector at the rank-owned DoFs, followed by its values at the interface DoFs imported from their owning ranks, in the order of the \ref MeshLayout.
+         */
+        vec append_interface_values(Assembler& assembler, const vec& v_owned)
+        {
+            TpetraMultiVector v(assembler.vector_map, 1);
+            {
+                auto v_2d = v.getLocalViewHost(Tpetra::Access::OverwriteAll);
+                auto v_local_view = Kokkos::subview(v_2d, Kokkos::ALL(), 0);
+                for (int i = 0; i < v_owned.size(); ++i)
+                    v_local_view(i) = v_owned(i);
+            }
+            TpetraMultiVector interface_v(assembler.interface_map, 1);
+            {
+                CommunicationTimer communication("interface_import");
+                interface_v.doImport(v, *assembler.interface_importer, Tpetra::INSERT);
+            }
+            auto interface_v_2d = interface_v.getLocalViewHost(Tpetra::Access::ReadOnly);
+            auto interface_v_local_view = Kokkos::subview(interface_v_2d, Kokkos::ALL(), 0);
+            int num_interface_dofs = interface_v_local_view.extent(0);
+            vec v_all(v_owned.size() + num_interface_dofs);
+            v_all.head(v_owned.size()) = v_owned;
+            for (int i = 0; i < num_interface_dofs; ++i)
+                v_all(v_owned.size() + i) = interface_v_local_view(i);
+            return v_all;
+        }
+        #endif
+
+    public:
+        /**
+         * @brief initialises the parameters of the explicit dynamic analysis.
+         *
+         * @param max_load_factor the load factor reached at the end of the load ramp.
+         * @param analysis_end_time the time at which the analysis stops.
+         * @param ramp_time the time over which the load is ramped; zero for a suddenly applied load.
+         * @param mass_density density used for the element lumped masses; can be zero if nodal masses are used.
+         * @param alpha mass-proportional damping coefficient.
+         * @param time_step the time step; if not positive, it is estimated as \ref dt_safety_factor times the stable time step.
+         * @param record_every results are written to the \ref Scribe every this many steps. Note that the Scribe buffer holds BUFFER_SIZE rows.
+         * @param check_stability_every the stable time step is re-estimated every this many steps; zero to estimate it only at the start.
+         */
+        void initialise_dynamic_parameters(real max_load_factor, real analysis_end_time, real ramp_time, real mass_density, real alpha = 0.0, real time_step = 0.0, int record_every = 1, int check_stability_every = 100)
+        {
+            load_factor = 0.0;
+            max_LF = max_load_factor;
+            time = 0.0;
+            end_time = analysis_end_time;
+            load_ramp_time = ramp_time;
+            density = mass_density;
+            damping_alpha = alpha;
+            dt = time_step;
+            record_interval = std::max(1, record_every);
+            stability_check_interval = std::max(0, check_stability_every);
+            step = 0;
+
+            get_my_rank(rank);
+            get_num_ranks(num_ranks);
+            time_keeper.initialise_parallel_keeper(rank, num_ranks);
+            time_keeper.add_timers({"all",
+                                    "U_to_nodes_mapping",
+                                    "element_state_update",
+                                    "assembly",
+                                    "time_integration",
+                                    "material_state_update",
+                                    "result_recording"});
+        }
+
+        /**
+         * @brief calculates an upper bound on the highest natural frequency from the Gershgorin bound of \f$\boldsymbol{M}^{-1/2}|\boldsymbol{K}|\boldsymbol{M}^{-1/2}\f$ using the current element tangent stiffnesses, and returns the corresponding stable time step \f$ 2/\omega_{max}\f$.
+         *
+         * @details in the distributed build the rows of \f$\boldsymbol{M}^{-1/2}\f$ at the interface DoFs are imported from their owning ranks, and the largest row sum is reduced over all ranks.
+         *
+         * @param glob_mesh the \ref GlobalMesh with the elements whose states have been updated.
+         * @param assembler the \ref Assembler whose interface importer is used in the distributed build.
+         * @return real the stable time step; conservative as the frequency bound is an upper bound.
+         */
+        real estimate_stable_time_step(GlobalMesh& glob_mesh, [[maybe_unused]] Assembler& assembler)
+        {
+            vec inv_sqrt_M = M.cwiseSqrt().cwiseInverse();
+            vec row_sums;
+            #ifdef WITH_MPI
+            glob_mesh.calc_abs_stiffness_product(append_interface_values(assembler, inv_sqrt_M), row_sums);
+            real omega_max_sq = (row_sums.size() > 0) ? (inv_sqrt_M.cwiseProduct(row_sums)).maxCoeff() : 0.0;
+            MPI_Allreduce(MPI_IN_PLACE, &omega_max_sq, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            #else
+            glob_mesh.calc_abs_stiffness_product(inv_sqrt_M, row_sums);
+            real omega_max_sq = (inv_sqrt_M.cwiseProduct(row_sums)).maxCoeff();
+            #endif
+            if (omega_max_sq <= 0.0)
+            {
+                std::cout << "ExplicitDynamicsProcedure::estimate_stable_time_step: stiffness is zero; cannot estimate the time step." << std::endl;
+                exit(1);
+            }
+            return 2.0/std::sqrt(omega_max_sq);
+        }
+
+        /**
+         * @brief re-estimates the stable time step from the current tangent stiffness. An estimated \ref dt that exceeds it is reduced to \ref dt_safety_factor times the new estimate; a given \ref dt is kept, with a warning.
+         *
+         * @param glob_mesh the \ref GlobalMesh with the elements whose states have been updated.
+         * @param assembler the \ref Assembler; see \ref estimate_stable_time_step.
+         */
+        void check_time_step(GlobalMesh& glob_mesh, Assembler& assembler)
+        {
+            real dt_stable = estimate_stable_time_step(glob_mesh, assembler);
+            if (dt <= dt_stable)
+                return;
+            if (dt_estimated)
+            {
+                if (rank == 0)
+                    std::cout << "ExplicitDynamicsProcedure: at t = " << time << " the stable time step fell to " << dt_stable << "; reducing the time step from " << dt << "." << std::endl;
+                dt = dt_safety_factor*dt_stable;
+            } else if (rank == 0) {
+                std::cout << "WARNING: at t = " << time << " ExplicitDynamicsProcedure time step " << dt << " exceeds the estimated stable time step " << dt_stable << std::endl;
+            }
+        }
+
+        /**
+         * @brief runs the explicit time integration until \ref end_time.
+         *
+         * @param glob_mesh the \ref GlobalMesh after \ref Model::initialise_restraints_n_loads.
+         * @param assembler the \ref Assembler; is switched to matrix-free mode in the serial build as \f$\boldsymbol{K}\f$ is never needed.
+         * @param load_manager the \ref LoadManager holding the applied loads.
+         * @param scribe the \ref Scribe recording the results.
+         * @param logging_frequency the time, load factor, and time step are printed by rank 0 every this many steps; not printed if not positive.
+         */
+        void solve(GlobalMesh& glob_mesh, Assembler& assembler, LoadManager& load_manager, Scribe& scribe, int logging_frequency)
+        {
+            #ifndef WITH_MPI
+            assembler.set_matrix_free(true);
+            #endif
+            time_keeper.start_timer("all");
+            glob_mesh.calc_lumped_masses(density, M);
+            if ((M.array() <= 0.0).any())
+            {
+                std::cout << "ExplicitDynamicsProcedure::solve: some active DoFs have no mass; provide a density or nodal masses that cover all active DoFs." << std::endl;
+                exit(1);
+            }
+            real dt_stable = estimate_stable_time_step(glob_mesh, assembler);
+            dt_estimated = dt <= 0.0;
+            if (dt_estimated)
+            {
+                dt = dt_safety_factor*dt_stable;
+            } else if (dt > dt_stable && rank == 0) {
+                std::cout << "WARNING: ExplicitDynamicsProcedure time step " << dt << " exceeds the estimated stable time step " << dt_stable << std::endl;
+            }
+            #ifndef WITH_MPI
+            U_n = assembler.U.toDense();
+            #endif
+            V_half = vec::Zero(M.size());
+            vec M_inv = M.cwiseInverse();
+            real previous_dt = dt;
+
+            while (time < end_time)
+            {
+                // apply the load at the current time
+                real target_LF = (load_ramp_time > 0.0) ? max_LF*std::min(1.0, time/load_ramp_time) : max_LF;
+                if (target_LF != load_factor)
+                {
+                    load_manager.increment_loads(target_LF - load_factor);
+                    load_factor = target_LF;
+                    time_keeper.start_timer("assembly");
+                    glob_mesh.calc_nodal_contributions_to_P();
+                    assembler.assemble_global_P(glob_mesh);
+                    time_keeper.stop_timer("assembly");
+                }
+
+                time_keeper.start_timer("U_to_nodes_mapping");
+                #ifndef WITH_MPI
+                assembler.U = U_n.sparseView();
+                #endif
+                assembler.map_U_to_nodes(glob_mesh);
+                time_keeper.stop_timer("U_to_nodes_mapping");
+
+                time_keeper.start_timer("element_state_update");
+                glob_mesh.update_elements_states();
+                time_keeper.stop_timer("element_state_update");
+
+                time_keeper.start_timer("assembly");
+                assembler.assemble_global_R(glob_mesh);
+                assembler.calculate_out_of_balance();
+                time_keeper.stop_timer("assembly");
+
+                time_keeper.start_timer("time_integration");
+                if (stability_check_interval > 0 && step > 0 && step % stability_check_interval == 0)
+                    check_time_step(glob_mesh, assembler);
+                // G = R - P so the net force is -G.
+                #ifdef WITH_MPI
+                vec net_force(M.size());
+                {
+                    auto G_2d = assembler.G.getLocalViewHost(Tpetra::Access::ReadOnly);
+                    auto G_local_view = Kokkos::subview(G_2d, Kokkos::ALL(), 0);
+                    for (int i = 0; i < net_force.size(); ++i)
+                        net_force(i) = -G_local_view(i);
+                }
+                #else
+                vec net_force = -assembler.G.toDense();
+                #endif
+                if (step == 0)
+                {
+                    // start from rest: V_{1/2} = (dt/2) a_0
+                    V_half = (0.5*dt)*M_inv.cwiseProduct(net_force);
+                } else {
+                    // the velocity is advanced over the average of the time steps on either side of t_n, which differ after the time step is reduced.
+                    real velocity_dt = 0.5*(previous_dt + dt);
+                    real damping_factor = 0.5*damping_alpha*velocity_dt;
+                    V_half = ((1.0 - damping_factor)*V_half + velocity_dt*M_inv.cwiseProduct(net_force))/(1.0 + damping_factor);
+                }
+                #ifdef WITH_MPI
+                {
+                    auto U_2d = assembler.U.getLocalViewHost(Tpetra::Access::ReadWrite);
+                    auto U_local_view = Kokkos::subview(U_2d, Kokkos::ALL(), 0);
+                    for (int i = 0; i < V_half.size(); ++i)
+                        U_local_view(i) += dt*V_half(i);
+                }
+                #else
+                U_n += dt*V_half;
+                #endif
+                previous_dt = dt;
+                time += dt;
+                ++step;
+                time_keeper.stop_timer("time_integration");
+
+                time_keeper.start_timer("material_state_update");
+                glob_mesh.update_element_sections_starting_states();
+                time_keeper.stop_timer("material_state_update");
+
+                if (step % record_interval == 0)
+                {
+                    time_keeper.start_timer("result_recording");
+                    #ifndef WITH_MPI
+                    assembler.U = U_n.sparseView();
+                    #endif
+                    assembler.map_U_to_nodes(glob_mesh);
+                    scribe.write_to_records();
+                    recorded_times.push_back(time);
+                    time_keeper.stop_timer("result_recording");
+                }
+                if (logging_frequency > 0 && step % logging_frequency == 0 && rank == 0)
+                {
+                    std::cout << "Explicit dynamics step " << step << ": t = " << time << ", LF = " << load_factor << ", dt = " << dt << std::endl;
+                }
+                #if LF_VERBOSE
+                if (rank == 0)
+                    std::cout << "t = " << time << ", LF = " << load_factor << ", max |V| = " << V_half.cwiseAbs().maxCoeff() << std::endl;
+                #endif
+            }
+            #ifndef WITH_MPI
+            assembler.U = U_n.sparseView();
+            #endif
+            assembler.map_U_to_nodes(glob_mesh);
+            scribe.finish_recording();
+            time_keeper.stop_timer("all");
+            if (rank == 0)
+            {
+                std::cout << std::endl << "---<Explicit dynamic analysis complete. t = " << time << ", dt = " << dt << ", steps = " << step << ">---" << std::endl;
+            }
+        }
+
+        real get_time_step() const {return dt;}
+        real get_time() const {return time;}
+        int get_num_steps() const {return step;}
+        vec get_lumped_masses() const {return M;}
+        vec get_velocities() const {return V_half;}
+        std::vector<real> get_recorded_times() const {return recorded_times;}
+};
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @file MatrixFreeSolver.hpp
+ * @brief defines the MatrixFreeSolver class which solves for \f$\Delta \boldsymbol{U}\f$ with a Krylov method without assembling the global stiffness matrix.
+ */
+
+#ifndef MATRIX_FREE_SOLVER_HPP
+#define MATRIX_FREE_SOLVER_HPP
+
+#include <cmath>
+#include <algorithm>
+#include "maths_defaults.hpp"
+#include "blaze_config.hpp"
+#include "global_mesh.hpp"
+#include "assembler.hpp"
+
+/**
+ * @brief solves \f$\boldsymbol{K}\Delta \boldsymbol{U} = -\boldsymbol{G}\f$ with restarted GMRES where \f$\boldsymbol{K}\boldsymbol{v}\f$ is applied element-by-element through the element stiffness maps.
+ *
+ * @details the system is right-preconditioned with the inverse of the stiffness diagonal (Jacobi) which is also gathered element-by-element. The Krylov tolerance follows the inexact-Newton forcing term of Eisenstat and Walker (choice 2): \f$\eta_k = \gamma \left(\frac{\|\boldsymbol{G}_k\|}{\|\boldsymbol{G}_{k-1}\|}\right)^\alpha\f$, safeguarded by \f$\gamma\eta_{k-1}^\alpha\f$ and capped at \ref eta_max. The first iteration of each load step follows a converged (small) \f$\boldsymbol{G}\f$ so the ratio is large and the cap \ref eta_max applies, as recommended for \f$\eta_0\f$.
+ * Only available in the serial build, as the distributed product would need the interface values of \f$\boldsymbol{v}\f$.
+ */
+class MatrixFreeSolver
+{
+    protected:
+        int restart = 30; /**< number of Krylov vectors kept before GMRES restarts.*/
+        int max_krylov_iter = 500; /**< maximum number of GMRES iterations per Newton iteration.*/
+        real eta_max = 0.9; /**< upper bound on the forcing term.*/
+        real eta_min = 1e-10; /**< lower bound on the forcing term.*/
+        real gamma = 0.9; /**< \f$\gamma\f$ in the Eisenstat-Walker forcing term.*/
+        real alpha = 2.0; /**< \f$\alpha\f$ in the Eisenstat-Walker forcing term.*/
+
+        real eta = 0.9; /**< forcing term used in the last solve.*/
+        real previous_G_norm = -1.0; /**< \f$\|\boldsymbol{G}_{k-1}\|\f$; negative before the first solve.*/
+        int num_krylov_iterations = 0; /**< total GMRES iterations performed so far.*/
+        int num_solves = 0; /**< total number of calls to \ref solve_for_deltaU.*/
+
+        vec inv_diagonal; /**< inverse of the stiffness diagonal used as a Jacobi preconditioner.*/
+
+        /**
+         * @brief updates \ref eta from the current and previous norms of the out-of-balance force.
+         */
+        void update_forcing_term(real G_norm)
+        {
+            if (previous_G_norm <= 0.0)
+            {
+                eta = eta_max;
+            } else {
+                real new_eta = gamma*std::pow(G_norm/previous_G_norm, alpha);
+                real safeguard = gamma*std::pow(eta, alpha);
+                if (safeguard > 0.1)
+                {
+                    new_eta = std::max(new_eta, safeguard);
+                }
+                eta = std::clamp(new_eta, eta_min, eta_max);
+            }
+            previous_G_norm = G_norm;
+        }
+
+        /**
+         * @brief gathers the stiffness diagonal and inverts it; zero entries are left unscaled.
+         */
+        void calc_preconditioner(GlobalMesh& glob_mesh)
+        {
+            glob_mesh.calc_stiffness_diagonal(inv_diagonal);
+            for (int i = 0; i < inv_diagonal.size(); ++i)
+            {
+                real d = std::abs(inv_diagonal(i));
+                inv_diagonal(i) = (d > 0.0) ? 1.0/d : 1.0;
+            }
+        }
+
+        /**
+         * @brief solves \f$\boldsymbol{K}\boldsymbol{x} = \boldsymbol{b}\f$ with right-preconditioned restarted GMRES until \f$\|\boldsymbol{b} - \boldsymbol{K}\boldsymbol{x}\| \leq \eta\|\boldsymbol{b}\|\f$.
+         *
+         * @return vec the solution \f$\boldsymbol{x}\f$.
+         */
+        vec gmres(GlobalMesh& glob_mesh, const vec& b)
+        {
+            int n = b.size();
+            vec x = vec::Zero(n);
+            vec r = b;
+            real beta = r.norm();
+            real target = eta*beta;
+            int iters = 0;
+            if (beta == 0.0)
+                return x;
+
+            mat V(n, restart + 1);
+            mat H = mat::Zero(restart + 1, restart);
+            vec g(restart + 1);
+            vec cs(restart), sn(restart);
+            vec w(n), z(n);
+
+            while (iters < max_krylov_iter)
+            {
+                H.setZero();
+                g.setZero();
+                g(0) = beta;
+                V.col(0) = r/beta;
+                int k = 0;
+                bool done = false;
+                for (int j = 0; j < restart && iters < max_krylov_iter; ++j)
+                {
+                    z = inv_diagonal.cwiseProduct(V.col(j));
+                    glob_mesh.calc_stiffness_product(z, w);
+                    // modified Gram-Schmidt
+                    for (int i = 0; i <= j; ++i)
+                    {
+                        H(i, j) = w.dot(V.col(i));
+                        w -= H(i, j)*V.col(i);
+                    }
+                    H(j + 1, j) = w.norm();
+                    if (H(j + 1, j) > 0.0)
+                        V.col(j + 1) = w/H(j + 1, j);
+                    // apply previous Givens rotations then eliminate H(j+1, j)
+                    for (int i = 0; i < j; ++i)
+                    {
+                        real temp = cs(i)*H(i, j) + sn(i)*H(i + 1, j);
+                        H(i + 1, j) = -sn(i)*H(i, j) + cs(i)*H(i + 1, j);
+                        H(i, j) = temp;
+                    }
+                    real denom = std::hypot(H(j, j), H(j + 1, j));
+                    cs(j) = (denom > 0.0) ? H(j, j)/denom : 1.0;
+                    sn(j) = (denom > 0.0) ? H(j + 1, j)/denom : 0.0;
+                    H(j, j) = denom;
+                    H(j + 1, j) = 0.0;
+                    g(j + 1) = -sn(j)*g(j);
+                    g(j) = cs(j)*g(j);
+                    ++iters;
+                    k = j + 1;
+                    if (std::abs(g(j + 1)) <= target || denom == 0.0)
+                    {
+                        done = true;
+                        break;
+                    }
+                }
+                vec y = H.topLeftCorner(k, k).triangularView<Eigen::Upper>().solve(g.head(k));
+                x += inv_diagonal.cwiseProduct(V.leftCols(k)*y);
+                glob_mesh.calc_stiffness_product(x, w);
+                r = b - w;
+                beta = r.norm();
+                if (done || beta <= target || beta == 0.0)
+                    break;
+            }
+            num_krylov_iterations += iters;
+            #if LF_VERBOSE
+            std::cout << "MatrixFreeSolver: GMRES took " << iters << " iterations with eta = " << eta << " and relative residual " << beta/b.norm() << std::endl;
+            #endif
+            return x;
+        }
+
+    public:
+        /**
+         * @brief sets the GMRES restart length and the maximum number of GMRES iterations per Newton iteration.
+         */
+        void set_krylov_parameters(int restart_length, int max_iterations)
+        {
+            restart = restart_length;
+            max_krylov_iter = max_iterations;
+        }
+
+        /**
+         * @brief sets the bounds on the inexact-Newton forcing term.
+         */
+        void set_forcing_term_bounds(real min_eta, real max_eta)
+        {
+            eta_min = min_eta;
+            eta_max = max_eta;
+        }
+
+        /**
+         * @brief solves for \f$\Delta \boldsymbol{U}\f$ from \f$\boldsymbol{K}\Delta \boldsymbol{U} = -\boldsymbol{G}\f$ without assembling \f$\boldsymbol{K}\f$. Elements must have had their states updated so that their tangent stiffnesses are current.
+         *
+         * @param glob_mesh the \ref GlobalMesh holding the elements.
+         * @param assembler the \ref Assembler holding \f$\boldsymbol{G}\f$ and \f$\Delta \boldsymbol{U}\f$.
+         */
+        void solve_for_deltaU(GlobalMesh& glob_mesh, Assembler& assembler)
+        {
+            #ifndef WITH_MPI
+            vec b = assembler.G.toDense();
+            update_forcing_term(b.norm());
+            calc_preconditioner(glob_mesh);
+            vec x = gmres(glob_mesh, b);
+            assembler.dU = (-x).sparseView();
+            ++num_solves;
+            if (VERBOSE_NLB)
+            {
+                std::cout << "dU is:" << std::endl << assembler.dU << std::endl;
+            }
+            #else
+            std::cout << "MatrixFreeSolver::solve_for_deltaU is not available in the distributed build." << std::endl;
+            exit(1);
+            #endif
+        }
+
+        int get_num_krylov_iterations() const {return num_krylov_iterations;}
+        int get_num_solves() const {return num_solves;}
+        real get_eta() const {return eta;}
+};
+
+#endif
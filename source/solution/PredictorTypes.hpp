@@ -0,0 +1,12 @@
+#ifndef PREDICTOR_TYPES
+#define PREDICTOR_TYPES
+/**
+ * @brief an enum that defines the predictors used to start the nonlinear iterations of each load step.
+ * 
+ */
+enum PredictorType {
+    NoPredictor = 0,
+    TangentPredictor = 1,
+    SecantPredictor = 2
+};
+#endif
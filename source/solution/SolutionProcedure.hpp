@@ -6,15 +6,26 @@
 #ifndef SOLUTION_PROCEDURE_HPP
 #define SOLUTION_PROCEDURE_HPP
 
+#include <sstream>
+#include <fstream>
+#include <array>
 #include "maths_defaults.hpp"
 #include "basic_utilities.hpp"
+#include "binary_io.hpp"
 #include "blaze_config.hpp"
 #include "global_mesh.hpp"
 #include "assembler.hpp"
 #include "basic_solver.hpp"
+#include "MatrixFreeSolver.hpp"
+#include "PredictorTypes.hpp"
 #include "LoadManager.hpp"
 #include "Scribe.hpp"
 #include "TimeKeeper.hpp"
+#include "Checkpointer.hpp"
+#include "FieldWriter.hpp"
+
+constexpr std::array<char, 8> CHECKPOINT_MAGIC = {'B', 'L', 'Z', 'C', 'K', 'P', 'T', '\0'}; /**< identifies Blaze checkpoint files.*/
+constexpr int CHECKPOINT_VERSION = 2; /**< layout version of the checkpoint files; increased whenever the layout changes.*/
 
 class SolutionProcedure
 {
@@ -30,7 +41,351 @@ class SolutionProcedure
         int num_ranks;
 
         TimeKeeper time_keeper;
+        MatrixFreeSolver matrix_free_solver; /**< used instead of the \ref BasicSolver when the \ref Assembler is in matrix-free mode.*/
+        bool quasi_newton = false; /**< whether iterations reuse a cached factorisation of \f$\boldsymbol{K}\f$ with BFGS updates instead of refactorising every iteration.*/
+        PredictorType predictor = NoPredictor; /**< predictor used at the start of each load step.*/
+        int num_iterations = 0; /**< total number of nonlinear iterations, i.e. element state updates, performed by \ref solve.*/
+        long num_skipped_element_updates = 0; /**< total number of element updates on this rank skipped by \ref solve as the element had not moved; see \ref GlobalMesh::update_elements_states.*/
+        Checkpointer checkpointer; /**< writes the checkpoints requested with \ref set_checkpointing.*/
+        FieldWriter field_writer; /**< writes the full-field snapshots requested with \ref set_field_output.*/
+        #ifdef WITH_MPI
+        Teuchos::RCP<TpetraMultiVector> U_converged; /**< displacements at the last converged load step.*/
+        Teuchos::RCP<TpetraMultiVector> U_previous_converged; /**< displacements at the load step before \ref U_converged.*/
+        #else
+        spvec U_converged; /**< displacements at the last converged load step.*/
+        spvec U_previous_converged; /**< displacements at the load step before \ref U_converged.*/
+        #endif
+
+        /**
+         * @brief moves \f$\boldsymbol{U}\f$ from the last converged state towards the equilibrium of the new load level before the nonlinear iterations start. Must be called after \f$\boldsymbol{P}\f$ is assembled for the new load level.
+         *
+         * @details the tangent predictor solves \f$\boldsymbol{K}_n\Delta \boldsymbol{U} = \Delta\boldsymbol{P}\f$ for the load increment with the factorisation the \ref BasicSolver already holds from the last iterations of the previous step, so it assembles and factorises nothing.
+         * The first iteration then starts from the predicted \f$\boldsymbol{U}\f$ instead of repeating the element state update at the converged one. In matrix-free mode the Krylov solver applies the tangent of the converged element states instead.
+         * It is skipped until a factorisation exists, i.e. at the first step. With quasi-Newton iterations the BFGS history is discarded as \f$\boldsymbol{U}\f$ moved outside it, and the first iteration refactorises as usual.
+         * The secant predictor extrapolates linearly from the last two converged states: \f$\boldsymbol{U} = \boldsymbol{U}_n + (\boldsymbol{U}_n - \boldsymbol{U}_{n-1})\f$, as the load increments are equal. It costs no solve, and is skipped at the first step.
+         */
+        void apply_predictor(GlobalMesh& glob_mesh, Assembler& assembler, BasicSolver& solver, bool use_quasi_newton)
+        {
+            if (predictor == TangentPredictor && load_factor != 0.0)
+            {
+                assembler.set_out_of_balance_to_load_increment(dLF/load_factor);
+                bool solved = true;
+                if (assembler.get_matrix_free())
+                    matrix_free_solver.solve_for_deltaU(glob_mesh, assembler);
+                else
+                    solved = solver.solve_for_deltaU_with_cached_factorisation(assembler);
+                if (solved)
+                {
+                    assembler.increment_U();
+                    if (use_quasi_newton)
+                        solver.reset_quasi_newton_history(); // U moved outside the BFGS updates.
+                }
+            } else if (predictor == SecantPredictor && step > 1) {
+                #ifdef WITH_MPI
+                assembler.U.update(1.0, *U_converged, -1.0, *U_previous_converged, 1.0);
+                #else
+                assembler.U += U_converged - U_previous_converged;
+                #endif
+            }
+        }
+
+        /**
+         * @brief stores the current \f$\boldsymbol{U}\f$ as the last converged state for the secant predictor.
+         */
+        void store_converged_U(Assembler& assembler)
+        {
+            if (predictor != SecantPredictor)
+                return;
+            #ifdef WITH_MPI
+            if (U_converged.is_null())
+            {
+                U_converged = Teuchos::rcp(new TpetraMultiVector(assembler.U, Teuchos::Copy));
+                U_previous_converged = Teuchos::rcp(new TpetraMultiVector(assembler.U, Teuchos::Copy));
+                return;
+            }
+            U_previous_converged->assign(*U_converged);
+            U_converged->assign(assembler.U);
+            #else
+            U_previous_converged = U_converged;
+            U_converged = assembler.U;
+            #endif
+        }
+
+        /**
+         * @brief serialises the committed state of the analysis on this rank and hands it to the \ref checkpointer to be written in the background. Called after a load step converged and was committed.
+         * @details the checkpoint holds the load step counter and load factor, the displacements \f$\boldsymbol{U}\f$ (and \f$\boldsymbol{U}_{n-1}\f$ for the secant predictor), the accumulated nodal loads,
+         * the committed fibre and section states, and the buffered records of the \ref Scribe. Everything else is recalculated from these on restart; see \ref restart_from_checkpoint.
+         */
+        void write_checkpoint(GlobalMesh& glob_mesh, Assembler& assembler, Scribe& scribe)
+        {
+            std::ostringstream out(std::ios::binary);
+            write_binary(out, CHECKPOINT_MAGIC);
+            write_binary(out, CHECKPOINT_VERSION);
+            write_binary(out, rank);
+            write_binary(out, num_ranks);
+            write_binary(out, nsteps);
+            write_binary(out, dLF);
+            write_binary(out, step);
+            write_binary(out, load_factor);
+            bool has_secant_history = (predictor == SecantPredictor);
+            write_binary(out, has_secant_history);
+            if (has_secant_history)
+            {
+                #ifdef WITH_MPI
+                write_binary_vector(out, *U_previous_converged);
+                #else
+                write_binary_vector(out, U_previous_converged);
+                #endif
+            }
+            assembler.write_checkpoint(out);
+            glob_mesh.write_checkpoint(out);
+            scribe.write_checkpoint(out);
+            checkpointer.write_async(step - 1, std::move(out).str());
+        }
+        /**
+         * @brief advances the load factor and the nodal loads to the load step \ref step.
+         */
+        void advance_load_factor(LoadManager& load_manager)
+        {
+            load_factor += dLF;
+            #if LF_VERBOSE
+                if (rank == 0)
+                    std::cout << std::endl << "===================================[Load step " << step << " - LF = " << load_factor << "]===================================" << std::endl;
+            #endif
+            load_manager.increment_loads(dLF);
+        }
+
+        /**
+         * @brief calculates the nodal load contributions of the current load factor and assembles them into \f$\boldsymbol{P}\f$.
+         * @param assemble_P false to only calculate the nodal load contributions, leaving the assembly of \f$\boldsymbol{P}\f$ to the caller.
+         */
+        void calc_load_step_P(GlobalMesh& glob_mesh, Assembler& assembler, bool assemble_P)
+        {
+            #if VERBOSE_SLN
+                if (rank == 0)
+                    std::cout << std::endl << "Entering glob_mesh.calc_nodal_contributions_to_P()" << std::endl;
+            #endif
+            glob_mesh.calc_nodal_contributions_to_P(); // calculates the global load contributions from the nodes. Does not assemble them.
+            
+            if (assemble_P)
+            {
+                #if VERBOSE_SLN
+                    if (rank == 0)
+                        std::cout << std::endl << "Entering assembler.assemble_global_P(glob_mesh)" << std::endl;
+                #endif
+                assembler.assemble_global_P(glob_mesh);
+            }
+        }
+
+        /**
+         * @brief advances the load factor and assembles \f$\boldsymbol{P}\f$ for the load step \ref step.
+         */
+        void prepare_load_step(GlobalMesh& glob_mesh, Assembler& assembler, LoadManager& load_manager)
+        {
+            advance_load_factor(load_manager);
+            time_keeper.start_timer("assembly");
+            calc_load_step_P(glob_mesh, assembler, true);
+            time_keeper.stop_timer("assembly");
+        }
+
+        /**
+         * @brief commits and records the load step that just finished and, if \p prepare_next_step, prepares the following step with \ref prepare_load_step.
+         * @details the three phases are independent: the commit only touches the element sections, the recording only reads the nodal displacements, and the next
+         * step only touches the nodal loads and \f$\boldsymbol{P}\f$. With OpenMP they are executed as a task graph with no edges, so the recording and the load
+         * assembly run alongside the commit, which is itself split into tasks that the remaining threads share; see \ref GlobalMesh::update_element_sections_starting_states_as_tasks.
+         * In the distributed build \f$\boldsymbol{P}\f$ is assembled by the calling thread after the tasks, as only that thread may call into Tpetra.
+         * As the \ref time_keeper may only be used by one thread at a time, each task times itself with its own \ref ExecutionTimer, and the durations are added to the
+         * \ref time_keeper after the tasks complete. Without OpenMP, or with Kokkos, the phases run in sequence.
+         */
+        void complete_load_step(GlobalMesh& glob_mesh, Assembler& assembler, LoadManager& load_manager, Scribe& scribe, bool prepare_next_step)
+        {
+            #if defined(OMP) && !defined(KOKKOS)
+            #ifdef WITH_MPI
+            bool assemble_P_in_task = false;
+            #else
+            bool assemble_P_in_task = true;
+            #endif
+            ExecutionTimer recording_timer, assembly_timer, state_update_timer;
+            #pragma omp parallel
+            #pragma omp single
+            {
+                #pragma omp task shared(recording_timer)
+                {
+                    recording_timer.start();
+                    scribe.write_to_records();
+                    recording_timer.stop();
+                }
+                if (prepare_next_step)
+                {
+                    #pragma omp task shared(assembly_timer)
+                    {
+                        advance_load_factor(load_manager);
+                        assembly_timer.start();
+                        calc_load_step_P(glob_mesh, assembler, assemble_P_in_task);
+                        assembly_timer.stop();
+                    }
+                }
+                state_update_timer.start();
+                glob_mesh.update_element_sections_starting_states_as_tasks();
+                state_update_timer.stop();
+            }
+            time_keeper.add_duration("result_recording", recording_timer.get_duration());
+            time_keeper.add_duration("assembly", assembly_timer.get_duration());
+            time_keeper.add_duration("material_state_update", state_update_timer.get_duration());
+            if (prepare_next_step && !assemble_P_in_task)
+            {
+                time_keeper.start_timer("assembly");
+                assembler.assemble_global_P(glob_mesh);
+                time_keeper.stop_timer("assembly");
+            }
+            #else
+            time_keeper.start_timer("material_state_update");
+            glob_mesh.update_element_sections_starting_states();
+            time_keeper.stop_timer("material_state_update");
+            time_keeper.start_timer("result_recording");
+            scribe.write_to_records();
+            time_keeper.stop_timer("result_recording");
+            if (prepare_next_step)
+                prepare_load_step(glob_mesh, assembler, load_manager);
+            #endif
+        }
+
+        /**
+         * @brief gathers the committed nodal and element results of this rank at \p converged_load_factor and hands them to the \ref field_writer, which writes them while the next load step is solved.
+         */
+        void write_field_snapshot(GlobalMesh& glob_mesh, real converged_load_factor)
+        {
+            FieldSnapshot snapshot;
+            snapshot.step = step - 1;
+            snapshot.load_factor = converged_load_factor;
+            glob_mesh.gather_field_snapshot(snapshot);
+            field_writer.write_async(std::move(snapshot));
+        }
     public:
+        MatrixFreeSolver& get_matrix_free_solver() {return matrix_free_solver;}
+
+        /**
+         * @brief writes a full-field snapshot every \p output_interval converged load steps to `<file_prefix>_step<N>.bin`, described by `<file_prefix>.xdmf`; see \ref FieldWriter.
+         * @param output_interval number of load steps between snapshots; zero to disable full-field output.
+         * @param file_prefix prefix of the snapshot and XDMF file names, including any directory.
+         */
+        void set_field_output(int output_interval, std::string file_prefix)
+        {
+            int my_rank;
+            get_my_rank(my_rank);
+            field_writer.set_field_output(output_interval, file_prefix, my_rank);
+        }
+
+        /**
+         * @brief writes a checkpoint every \p checkpoint_interval converged load steps to `<file_prefix>_step<N>_rank<r>.bin`; see \ref Checkpointer.
+         * @param checkpoint_interval number of load steps between checkpoints; zero to disable checkpointing.
+         * @param file_prefix prefix of the checkpoint file names, including any directory.
+         */
+        void set_checkpointing(int checkpoint_interval, std::string file_prefix)
+        {
+            int my_rank;
+            get_my_rank(my_rank);
+            checkpointer.set_checkpointing(checkpoint_interval, file_prefix, my_rank);
+        }
+
+        /**
+         * @brief restores the analysis from the checkpoint written after \p completed_steps load steps so that the next call to \ref solve continues with the following step.
+         * @details the model must be built as it was when the checkpoint was written, with the same number of ranks, and \ref initialise_solution_parameters must have been called with the same parameters.
+         * After the committed state is read, the element states, \f$\boldsymbol{K}\f$, and \f$\boldsymbol{R}\f$ are recalculated at the restored \f$\boldsymbol{U}\f$, as they are at the end of a converged step.
+         * @param file_prefix prefix the checkpoint files were written with.
+         * @param completed_steps number of load steps completed when the checkpoint was written.
+         */
+        void restart_from_checkpoint(std::string file_prefix, int completed_steps, GlobalMesh& glob_mesh, Assembler& assembler, Scribe& scribe)
+        {
+            checkpointer.wait();
+            std::string file_name = Checkpointer::get_file_name(file_prefix, completed_steps, rank);
+            std::ifstream in(file_name, std::ios::binary);
+            if (!in)
+            {
+                std::cout << "SolutionProcedure::restart_from_checkpoint: could not open checkpoint file " << file_name << "." << std::endl;
+                exit(1);
+            }
+            std::array<char, 8> magic;
+            int version, checkpoint_rank, checkpoint_num_ranks, checkpoint_nsteps;
+            real checkpoint_dLF;
+            read_binary(in, magic);
+            read_binary(in, version);
+            if (magic != CHECKPOINT_MAGIC || version != CHECKPOINT_VERSION)
+            {
+                std::cout << "SolutionProcedure::restart_from_checkpoint: " << file_name << " is not a version " << CHECKPOINT_VERSION << " checkpoint file." << std::endl;
+                exit(1);
+            }
+            read_binary(in, checkpoint_rank);
+            read_binary(in, checkpoint_num_ranks);
+            read_binary(in, checkpoint_nsteps);
+            read_binary(in, checkpoint_dLF);
+            if (checkpoint_rank != rank || checkpoint_num_ranks != num_ranks || checkpoint_nsteps != nsteps || checkpoint_dLF != dLF)
+            {
+                std::cout << "SolutionProcedure::restart_from_checkpoint: " << file_name << " was written by rank " << checkpoint_rank << " of " << checkpoint_num_ranks
+                          << " with " << checkpoint_nsteps << " steps of dLF = " << checkpoint_dLF << ", but this is rank " << rank << " of " << num_ranks
+                          << " with " << nsteps << " steps of dLF = " << dLF << "." << std::endl;
+                exit(1);
+            }
+            read_binary(in, step);
+            read_binary(in, load_factor);
+            bool has_secant_history;
+            read_binary(in, has_secant_history);
+            #ifdef WITH_MPI
+            Teuchos::RCP<TpetraMultiVector> U_checkpoint_previous = Teuchos::rcp(new TpetraMultiVector(assembler.U, Teuchos::Copy));
+            if (has_secant_history)
+                read_binary_vector(in, *U_checkpoint_previous);
+            #else
+            spvec U_checkpoint_previous;
+            if (has_secant_history)
+                read_binary_vector(in, U_checkpoint_previous);
+            #endif
+            assembler.read_checkpoint(in);
+            glob_mesh.read_checkpoint(in);
+            scribe.read_checkpoint(in);
+
+            // solve shifts U_converged into U_previous_converged before the first step, so U_converged holds U_{n-1} here.
+            if (predictor == SecantPredictor)
+            {
+                #ifdef WITH_MPI
+                U_converged = has_secant_history ? U_checkpoint_previous : Teuchos::rcp(new TpetraMultiVector(assembler.U, Teuchos::Copy));
+                U_previous_converged = Teuchos::rcp(new TpetraMultiVector(assembler.U, Teuchos::Copy));
+                #else
+                U_converged = has_secant_history ? U_checkpoint_previous : assembler.U;
+                #endif
+            }
+
+            assembler.map_U_to_nodes(glob_mesh);
+            glob_mesh.update_elements_states();
+            assembler.assemble_global_K_R(glob_mesh);
+            if (rank == 0)
+                std::cout << "Restarted from " << file_name << " at LF = " << load_factor << "." << std::endl;
+        }
+
+        /**
+         * @brief switches the quasi-Newton (limited-memory BFGS) iterations on or off. \f$\boldsymbol{K}\f$ is then only assembled and factorised at the first iteration of each load step, or when the out-of-balance force grows between iterations; see \ref BasicSolver::solve_for_deltaU_quasi_newton. Ignored in matrix-free mode.
+         */
+        void set_quasi_newton(bool use_quasi_newton) {quasi_newton = use_quasi_newton;}
+
+        /**
+         * @brief sets the predictor used at the start of each load step; see \ref apply_predictor.
+         */
+        void set_predictor(PredictorType predictor_type) {predictor = predictor_type;}
+
+        /**
+         * @brief Get the total number of nonlinear iterations performed by \ref solve.
+         */
+        int get_num_iterations() const {return num_iterations;}
+
+        /**
+         * @brief Get the total number of element updates on this rank that were skipped by \ref solve.
+         */
+        long get_num_skipped_element_updates() const {return num_skipped_element_updates;}
+
+        /**
+         * @brief Get the \ref TimeKeeper with the timers of each phase of the solution.
+         */
+        TimeKeeper& get_time_keeper() {return time_keeper;}
+
         void log_timers(std::vector<std::string> timers_names)
         {
             time_keeper.log_timers(timers_names);
@@ -47,6 +402,22 @@ class SolutionProcedure
             time_keeper.read_timers(timers_names, reference_timer);
         }
 
+        /**
+         * @brief prints the busy and idle time of each thread while updating the element states; see \ref GlobalMesh::update_elements_states.
+         */
+        void log_thread_durations()
+        {
+            time_keeper.log_thread_durations("element_state_update");
+        }
+
+        /**
+         * @brief Get the cumulative busy and idle time of each thread while updating the element states.
+         */
+        std::pair<std::vector<double>, std::vector<double>> get_element_update_thread_durations()
+        {
+            return time_keeper.get_thread_durations("element_state_update");
+        }
+
         void initialise_solution_parameters(real max_load_factor, int num_steps, real convergence_tolerance, int max_num_of_iterations)
         {
             load_factor = 0;
@@ -69,37 +440,31 @@ class SolutionProcedure
                                     "convergence_check",
                                     "dU_calculation",
                                     "material_state_update",
-                                    "result_recording"});
+                                    "result_recording",
+                                    "checkpointing",
+                                    "field_output"});
         }
 
         void solve(GlobalMesh& glob_mesh, Assembler& assembler, BasicSolver& solver, LoadManager& load_manager, Scribe& scribe, int logging_frequency)
         {
-            int num_iterations = 0;
+            num_iterations = 0;
+            num_skipped_element_updates = 0;
+            bool use_quasi_newton = quasi_newton && !assembler.get_matrix_free();
+            realx2 previous_G_max = 0.0;
             time_keeper.start_timer("all");
+            store_converged_U(assembler);
+            bool next_step_prepared = false;
             while (step <= nsteps)
             {
-                load_factor += dLF;
-                #if LF_VERBOSE
-                    if (rank == 0)
-                        std::cout << std::endl << "===================================[Load step " << step << " - LF = " << load_factor << "]===================================" << std::endl;
-                #endif
-                load_manager.increment_loads(dLF);
+                if (!next_step_prepared)
+                    prepare_load_step(glob_mesh, assembler, load_manager);
+                next_step_prepared = false;
                 bool converged = false;
                 int iter = 1;
 
-                #if VERBOSE_SLN
-                    if (rank == 0)
-                        std::cout << std::endl << "Entering glob_mesh.calc_nodal_contributions_to_P()" << std::endl;
-                #endif
-                time_keeper.start_timer("assembly");
-                glob_mesh.calc_nodal_contributions_to_P(); // calculates the global load contributions from the nodes. Does not assemble them.
-                
-                #if VERBOSE_SLN
-                    if (rank == 0)
-                        std::cout << std::endl << "Entering assembler.assemble_global_P(glob_mesh)" << std::endl;
-                #endif
-                assembler.assemble_global_P(glob_mesh);
-                time_keeper.stop_timer("assembly");
+                time_keeper.start_timer("dU_calculation");
+                apply_predictor(glob_mesh, assembler, solver, use_quasi_newton);
+                time_keeper.stop_timer("dU_calculation");
 
                 // begin nonlinear iterations:
                 while ((iter <= max_iter) && !(converged))
@@ -130,12 +495,21 @@ class SolutionProcedure
                     time_keeper.start_timer("element_state_update");
                     glob_mesh.update_elements_states(); // calculates internal state of strain, stress, and nodal responses. 
                     time_keeper.stop_timer("element_state_update");
+                    time_keeper.add_thread_durations("element_state_update", glob_mesh.get_thread_busy_times(), glob_mesh.get_thread_idle_times());
+                    num_skipped_element_updates += glob_mesh.get_num_skipped_elements();
+                    #if LF_VERBOSE
+                    if (rank == 0)
+                        std::cout << "skipped " << glob_mesh.get_num_skipped_elements() << " unchanged elements on rank 0" << std::endl;
+                    #endif
                     #if VERBOSE_SLN
                     if (rank == 0)
                         std::cout << std::endl << "Entering assembler.assemble_global_K_R(glob_mesh);" << std::endl;
                     #endif
                     time_keeper.start_timer("assembly");
-                    assembler.assemble_global_K_R(glob_mesh); // assembles the stiffness and load contributions into the global stiffness matrix and load vector.                    
+                    if (use_quasi_newton)
+                        assembler.assemble_global_R(glob_mesh); // K is only assembled when it is refactorised.
+                    else
+                        assembler.assemble_global_K_R(glob_mesh); // assembles the stiffness and load contributions into the global stiffness matrix and load vector.                    
                     time_keeper.stop_timer("assembly");
                     
                     #if VERBOSE_SLN
@@ -158,7 +532,19 @@ class SolutionProcedure
                         if (rank == 0)
                             std::cout << std::endl << "Entering solver.solve_for_deltaU(assembler);" << std::endl;
                         #endif
-                        solver.solve_for_deltaU(assembler);
+                        if (assembler.get_matrix_free())
+                        {
+                            matrix_free_solver.solve_for_deltaU(glob_mesh, assembler);
+                        } else if (use_quasi_newton) {
+                            if (iter == 1 || (iter > 1 && assembler.get_G_max() > previous_G_max))
+                            {
+                                assembler.assemble_global_K(glob_mesh);
+                                solver.factorise_for_quasi_newton(assembler);
+                            }
+                            solver.solve_for_deltaU_quasi_newton(assembler);
+                        } else {
+                            solver.solve_for_deltaU(assembler);
+                        }
                         #if VERBOSE_NLB
                         if (rank==0)
                         {
@@ -173,6 +559,7 @@ class SolutionProcedure
                         assembler.increment_U();
                     }
                     time_keeper.stop_timer("dU_calculation");
+                    previous_G_max = assembler.get_G_max();
                     // WARNING: this is a debugging line that MUST be removed after problem with convergence is solved.
                     // scribe.write_to_records();
                     #if LF_VERBOSE
@@ -190,12 +577,24 @@ class SolutionProcedure
                     ++iter;
                 }           
                 ++step;
-                time_keeper.start_timer("material_state_update");
-                glob_mesh.update_element_sections_starting_states();
-                time_keeper.stop_timer("material_state_update");
-                time_keeper.start_timer("result_recording");
-                scribe.write_to_records();
-                time_keeper.stop_timer("result_recording");
+                store_converged_U(assembler);
+                bool checkpoint_due = converged && checkpointer.is_due(step - 1);
+                // the checkpoint must hold the loads of the committed step, so the next step is then prepared after it.
+                next_step_prepared = converged && !checkpoint_due && step <= nsteps;
+                real converged_load_factor = load_factor; // the next step may be prepared, advancing the load factor, as this step is completed.
+                complete_load_step(glob_mesh, assembler, load_manager, scribe, next_step_prepared);
+                if (checkpoint_due)
+                {
+                    time_keeper.start_timer("checkpointing");
+                    write_checkpoint(glob_mesh, assembler, scribe);
+                    time_keeper.stop_timer("checkpointing");
+                }
+                if (converged && field_writer.is_due(step - 1))
+                {
+                    time_keeper.start_timer("field_output");
+                    write_field_snapshot(glob_mesh, converged_load_factor);
+                    time_keeper.stop_timer("field_output");
+                }
                 // if (step%logging_frequency == 0 && logging_frequency > 0)
                 // {
                 //     scribe.read_all_records();
@@ -209,6 +608,9 @@ class SolutionProcedure
                     break;
                 }
             }
+            checkpointer.wait();
+            field_writer.wait();
+            scribe.finish_recording();
             time_keeper.stop_timer("all");
             if (rank == 0)
             {
@@ -220,6 +622,7 @@ class SolutionProcedure
                     std::cout << "ANALYSIS_FAILED" << std::endl;
                 
                 std::cout << "num_iterations:" << num_iterations << std::endl; 
+                std::cout << "num_skipped_element_updates:" << num_skipped_element_updates << std::endl; 
             }
 
         }
@@ -10,6 +10,7 @@
  */
 #ifndef BASIC_SOLVER
 #define BASIC_SOLVER
+#include <deque>
 #include "assembler.hpp"
 #ifdef WITH_MPI
 #include "Amesos2.hpp"
@@ -32,9 +33,137 @@ class BasicSolver {
     Teuchos::RCP<TpetraMultiVector> P_rcp;
     Teuchos::RCP<TpetraMultiVector> dU_rcp;
     Teuchos::RCP<TpetraMultiVector> G_rcp;
+    std::string symmetric_solver_name = "cholmod"; /**< Amesos2 backend used when the \ref Assembler uses symmetric storage; falls back to klu2 if unavailable or if factorisation fails.*/
     #else
     Eigen::SparseLU<spmat> solver;
+    Eigen::SimplicialLDLT<spmat, Eigen::Upper> symmetric_solver; /**< \f$\boldsymbol{LDL}^T\f$ solver used when the \ref Assembler stores only the upper triangle of \f$\boldsymbol{K}\f$.*/
+    spmat K_full; /**< full copy of the symmetric \f$\boldsymbol{K}\f$ used only when falling back to LU for an indefinite matrix.*/
+    bool ldlt_factorised = false; /**< whether the last factorisation used \ref symmetric_solver (true) or \ref solver (false).*/
     #endif
+    int num_lu_fallbacks = 0; /**< number of times symmetric factorisation was abandoned in favour of LU.*/
+    int num_factorisations = 0; /**< number of numeric factorisations of \f$\boldsymbol{K}\f$ performed so far.*/
+    bool deltaU_factors_cached = false; /**< whether a factorisation of \f$\boldsymbol{K}\f$ used for \f$\Delta \boldsymbol{U}\f$ is held, and can be reused by \ref solve_for_deltaU_with_cached_factorisation.*/
+
+    int max_qn_updates = 10; /**< number of \f$(\boldsymbol{s}, \boldsymbol{y})\f$ pairs kept by the limited-memory BFGS update; the oldest pair is dropped once full.*/
+    bool qn_has_prev = false; /**< whether \ref qn_G_prev and \ref qn_dU_prev hold the previous quasi-Newton iteration.*/
+    #ifdef WITH_MPI
+    std::deque<Teuchos::RCP<TpetraMultiVector>> qn_s; /**< displacement changes \f$\boldsymbol{s}_i = \boldsymbol{U}_{i+1} - \boldsymbol{U}_i\f$, newest last.*/
+    std::deque<Teuchos::RCP<TpetraMultiVector>> qn_y; /**< out-of-balance changes \f$\boldsymbol{y}_i = \boldsymbol{G}_{i+1} - \boldsymbol{G}_i\f$, newest last.*/
+    std::deque<real> qn_rho; /**< \f$1/(\boldsymbol{y}_i\cdot\boldsymbol{s}_i)\f$ for each stored pair.*/
+    Teuchos::RCP<TpetraMultiVector> qn_G_prev;
+    Teuchos::RCP<TpetraMultiVector> qn_dU_prev;
+    #else
+    std::deque<vec> qn_s; /**< displacement changes \f$\boldsymbol{s}_i = \boldsymbol{U}_{i+1} - \boldsymbol{U}_i\f$, newest last.*/
+    std::deque<vec> qn_y; /**< out-of-balance changes \f$\boldsymbol{y}_i = \boldsymbol{G}_{i+1} - \boldsymbol{G}_i\f$, newest last.*/
+    std::deque<real> qn_rho; /**< \f$1/(\boldsymbol{y}_i\cdot\boldsymbol{s}_i)\f$ for each stored pair.*/
+    vec qn_G_prev;
+    vec qn_dU_prev;
+    #endif
+
+        #ifndef WITH_MPI
+        /**
+         * @brief factorises \f$\boldsymbol{K}\f$ with \f$\boldsymbol{LDL}^T\f$ if the \ref Assembler uses symmetric storage, and with LU otherwise.
+         * @details the LDLT factorisation is rejected if any pivot in \f$\boldsymbol{D}\f$ is not positive as the unpivoted factorisation is unreliable for indefinite matrices (e.g. past a limit point). In that case the full matrix is recovered from the upper triangle and factorised with LU.
+         * @param assembler the \ref Assembler object holding \f$\boldsymbol{K}\f$.
+         */
+        void factorise_K(Assembler& assembler)
+        {
+            ++num_factorisations;
+            deltaU_factors_cached = true;
+            ldlt_factorised = false;
+            if (assembler.symmetric_storage)
+            {
+                symmetric_solver.compute(assembler.K);
+                if (symmetric_solver.info() == Eigen::Success && (symmetric_solver.vectorD().array() > 0.0).all())
+                {
+                    ldlt_factorised = true;
+                    #if LF_VERBOSE
+                    std::cout << "Factorisation successful." << std::endl;
+                    #endif
+                    return;
+                }
+                ++num_lu_fallbacks;
+                #if LF_VERBOSE
+                std::cout << "LDLT factorisation detected an indefinite matrix; falling back to LU." << std::endl;
+                #endif
+                K_full = assembler.K.selfadjointView<Eigen::Upper>();
+            }
+            const spmat& K = assembler.symmetric_storage ? K_full : assembler.K;
+            // Compute the ordering permutation vector from the structural pattern of A
+            solver.analyzePattern(K); 
+            // Compute the numerical factorization 
+            solver.factorize(K); 
+            
+            if (solver.info() == Eigen::Success)
+            {
+                #if LF_VERBOSE
+                std::cout << "Factorisation successful." << std::endl;
+                #endif
+            } else {
+                std::cout << "ERROR: Factorisation unsuccessful! Matrix is:" << std::endl;
+                // convert to dense matrix to print correctly
+                std::cout << Eigen::MatrixXd(K) << std::endl;
+                std::exit(1);
+            }
+        }
+        #else
+        /**
+         * @brief creates the Amesos2 solver for the given left and right hand sides, using \ref symmetric_solver_name if the \ref Assembler uses symmetric storage and the backend is available.
+         */
+        Teuchos::RCP<Amesos2::Solver<TpetraCrsMatrix, TpetraMultiVector>> create_amesos2_solver(Assembler& assembler, Teuchos::RCP<TpetraMultiVector> lhs, Teuchos::RCP<TpetraMultiVector> rhs)
+        {
+            if (assembler.symmetric_storage && Amesos2::query(symmetric_solver_name))
+            {
+                return Amesos2::create<TpetraCrsMatrix,TpetraMultiVector>(symmetric_solver_name, assembler.K, lhs, rhs);
+            }
+            return Amesos2::create<TpetraCrsMatrix,TpetraMultiVector>("klu2", assembler.K, lhs, rhs);
+        }
+
+        /**
+         * @brief runs the factorisation and solve of an Amesos2 solver; if a symmetric backend fails (e.g. for an indefinite matrix) both solvers are replaced by klu2 for the rest of the analysis; see \ref fall_back_to_lu.
+         */
+        void factorise_and_solve(Teuchos::RCP<Amesos2::Solver<TpetraCrsMatrix, TpetraMultiVector>>& amesos_solver, Assembler& assembler)
+        {
+            factorise(amesos_solver, assembler);
+            CommunicationTimer communication("direct_solve");
+            amesos_solver->solve();
+        }
+
+        /**
+         * @brief runs the symbolic and numeric factorisation of an Amesos2 solver without solving; falls back to klu2 as in \ref factorise_and_solve.
+         */
+        void factorise(Teuchos::RCP<Amesos2::Solver<TpetraCrsMatrix, TpetraMultiVector>>& amesos_solver, Assembler& assembler)
+        {
+            ++num_factorisations;
+            CommunicationTimer communication("direct_factorisation");
+            try
+            {
+                amesos_solver->symbolicFactorization().numericFactorization();
+            }
+            catch (const std::runtime_error& e)
+            {
+                if (!assembler.symmetric_storage)
+                {
+                    throw;
+                }
+                ++num_lu_fallbacks;
+                fall_back_to_lu(assembler);
+                // amesos_solver refers to U_solver or dU_solver, which now hold klu2.
+                amesos_solver->symbolicFactorization().numericFactorization();
+            }
+        }
+
+        /**
+         * @brief stops treating \f$\boldsymbol{K}\f$ as symmetric and moves both \ref U_solver and \ref dU_solver to klu2, so that neither is left on the symmetric backend without a fallback.
+         */
+        void fall_back_to_lu(Assembler& assembler)
+        {
+            assembler.symmetric_storage = false;
+            U_solver = Amesos2::create<TpetraCrsMatrix,TpetraMultiVector>("klu2", assembler.K, U_rcp, P_rcp);
+            dU_solver = Amesos2::create<TpetraCrsMatrix,TpetraMultiVector>("klu2", assembler.K, dU_rcp, G_rcp);
+            deltaU_factors_cached = false;
+        }
+        #endif
     public:
         /**
          * @brief creates a Teuchos::RCP that points to the memory in the Assembler that holds \f$\boldsymbol{U}\f$, \f$d\boldsymbol{U}\f$ and \f$\boldsymbol{P}\f$.
@@ -53,46 +182,35 @@ class BasicSolver {
             // using GO = std::remove_reference_t<decltype(*assembler.K)>::global_ordinal_type;
             // using ST = std::remove_reference_t<decltype(*assembler.K)>::scalar_type;
 
-            U_solver = Amesos2::create<TpetraCrsMatrix,TpetraMultiVector>("klu2", assembler.K, U_rcp, P_rcp);
-            dU_solver = Amesos2::create<TpetraCrsMatrix,TpetraMultiVector>("klu2", assembler.K, dU_rcp, G_rcp);
+            U_solver = create_amesos2_solver(assembler, U_rcp, P_rcp);
+            dU_solver = create_amesos2_solver(assembler, dU_rcp, G_rcp);
             #endif
         }
 
         /**
-         * @brief solves for U using the global matrices contained in \ref Assembler; uses Eigen's SparseLU solver.
+         * @brief Get the number of times the symmetric factorisation was abandoned in favour of LU.
+         */
+        int get_num_lu_fallbacks() const {return num_lu_fallbacks;}
+
+        /**
+         * @brief solves for U using the global matrices contained in \ref Assembler; uses Eigen's SparseLU solver, or SimplicialLDLT if the \ref Assembler uses symmetric storage.
          * 
          * @param assembler 
          */
         void solve_for_U(Assembler& assembler)
         {
             #ifndef WITH_MPI
-            
-            // Compute the ordering permutation vector from the structural pattern of A
-            solver.analyzePattern(assembler.K); 
-            // Compute the numerical factorization 
-            solver.factorize(assembler.K); 
-            //Use the factors to solve the linear system 
-            
-            if (solver.info() == Eigen::Success)
-            {
-                #if LF_VERBOSE
-                std::cout << "Factorisation successful." << std::endl;
-                #endif
-            } else {
-                std::cout << "ERROR: Factorisation unsuccessfull! Matrix is:" << std::endl;
-                // convert to dense matrix to print correctly
-                std::cout << Eigen::MatrixXd(assembler.K) << std::endl;
-
-                
-                std::exit(1);
-            }
-            assembler.U = solver.solve(assembler.P); 
+            factorise_K(assembler);
+            if (ldlt_factorised)
+                assembler.U = symmetric_solver.solve(assembler.P);
+            else
+                assembler.U = solver.solve(assembler.P); 
             if (VERBOSE_NLB)
             {
                 std::cout << "The solution is:" << std::endl << assembler.U << std::endl;
             }    
             #else
-            U_solver->symbolicFactorization().numericFactorization().solve();
+            factorise_and_solve(U_solver, assembler);
             #endif
         }
         
@@ -106,33 +224,198 @@ class BasicSolver {
         void solve_for_deltaU(Assembler& assembler)
         {
             #ifndef WITH_MPI
-            // Compute the ordering permutation vector from the structural pattern of A
-            solver.analyzePattern(assembler.K); 
-            // Compute the numerical factorization 
-            solver.factorize(assembler.K); 
-            //Use the factors to solve the linear system 
-            
-            if (solver.info() == Eigen::Success)
-            {
-                #if LF_VERBOSE
-                std::cout << "Factorisation successful." << std::endl;
-                #endif
-            } else {
-                std::cout << "ERROR: Factorisation unsuccessful! Matrix is:" << std::endl;
-                // convert to dense matrix to print correctly
-                std::cout << Eigen::MatrixXd(assembler.K) << std::endl;
-
-                
-                std::exit(1);
-            }
-            assembler.dU = solver.solve(assembler.G);
+            factorise_K(assembler);
+            if (ldlt_factorised)
+                assembler.dU = symmetric_solver.solve(assembler.G);
+            else
+                assembler.dU = solver.solve(assembler.G);
             assembler.dU = -assembler.dU; 
             if (VERBOSE_NLB)
             {    
                 std::cout << "dU is:" << std::endl << assembler.dU << std::endl;
             }
             #else
-            dU_solver->symbolicFactorization().numericFactorization().solve();
+            factorise_and_solve(dU_solver, assembler);
+            deltaU_factors_cached = true;
+            #endif
+        }
+
+        /**
+         * @brief solves for \f$\Delta \boldsymbol{U}\f$ as \ref solve_for_deltaU does, but with the factors of the last \f$\boldsymbol{K}\f$ that was factorised for \f$\Delta \boldsymbol{U}\f$ instead of factorising the current \f$\boldsymbol{K}\f$.
+         * 
+         * @param assembler the \ref Assembler holding the right hand side \f$\boldsymbol{G}\f$.
+         * @return false, leaving \f$\Delta \boldsymbol{U}\f$ unchanged, if no factorisation is held yet.
+         */
+        bool solve_for_deltaU_with_cached_factorisation(Assembler& assembler)
+        {
+            if (!deltaU_factors_cached)
+                return false;
+            #ifndef WITH_MPI
+            if (ldlt_factorised)
+                assembler.dU = symmetric_solver.solve(assembler.G);
+            else
+                assembler.dU = solver.solve(assembler.G);
+            assembler.dU = -assembler.dU;
+            #else
+            CommunicationTimer communication("direct_solve");
+            dU_solver->solve();
+            #endif
+            return true;
+        }
+
+        /**
+         * @brief Set the number of \f$(\boldsymbol{s}, \boldsymbol{y})\f$ pairs kept by the limited-memory BFGS update.
+         */
+        void set_max_quasi_newton_updates(int max_updates) {max_qn_updates = std::max(1, max_updates);}
+
+        /**
+         * @brief Get the number of numeric factorisations of \f$\boldsymbol{K}\f$ performed so far.
+         */
+        int get_num_factorisations() const {return num_factorisations;}
+
+        /**
+         * @brief Get the number of BFGS pairs currently held.
+         */
+        int get_num_quasi_newton_updates() const {return qn_s.size();}
+
+        /**
+         * @brief factorises the current \f$\boldsymbol{K}\f$ to be used as \f$\boldsymbol{K}_0\f$ by \ref solve_for_deltaU_quasi_newton, and discards the BFGS history built on the previous factorisation.
+         *
+         * @param assembler the \ref Assembler holding a freshly assembled \f$\boldsymbol{K}\f$.
+         */
+        void factorise_for_quasi_newton(Assembler& assembler)
+        {
+            #ifndef WITH_MPI
+            factorise_K(assembler);
+            #else
+            factorise(dU_solver, assembler);
+            deltaU_factors_cached = true;
+            #endif
+            reset_quasi_newton_history();
+        }
+
+        /**
+         * @brief discards the BFGS history, e.g. after \f$\boldsymbol{U}\f$ was changed by a predictor rather than by \ref solve_for_deltaU_quasi_newton.
+         */
+        void reset_quasi_newton_history()
+        {
+            qn_s.clear();
+            qn_y.clear();
+            qn_rho.clear();
+            qn_has_prev = false;
+        }
+
+        /**
+         * @brief solves for \f$\Delta \boldsymbol{U} = -\boldsymbol{H}\boldsymbol{G}\f$ where \f$\boldsymbol{H}\f$ is the limited-memory BFGS approximation of the inverse tangent built on the cached factorisation \f$\boldsymbol{K}_0\f$.
+         *
+         * @details the pair \f$\boldsymbol{s} = \Delta \boldsymbol{U}_{prev}\f$, \f$\boldsymbol{y} = \boldsymbol{G} - \boldsymbol{G}_{prev}\f$ from the previous call is added to the history if it satisfies the curvature condition \f$\boldsymbol{y}\cdot\boldsymbol{s} > 0\f$; otherwise it is skipped to keep \f$\boldsymbol{H}\f$ positive definite.
+         * \f$\boldsymbol{H}\boldsymbol{G}\f$ is then evaluated with the two-loop recursion, where the only solve is one forward/backward substitution with the factors of \f$\boldsymbol{K}_0\f$.
+         * Requires a previous call to \ref factorise_for_quasi_newton, and \f$\boldsymbol{U}\f$ must only change through the returned \f$\Delta \boldsymbol{U}\f$ between calls.
+         * @param assembler the \ref Assembler holding the current \f$\boldsymbol{G}\f$.
+         */
+        void solve_for_deltaU_quasi_newton(Assembler& assembler)
+        {
+            #ifndef WITH_MPI
+            vec G = assembler.G.toDense();
+            if (qn_has_prev)
+            {
+                vec y = G - qn_G_prev;
+                real ys = y.dot(qn_dU_prev);
+                if (ys > 1e-12*y.norm()*qn_dU_prev.norm())
+                {
+                    if ((int)qn_s.size() == max_qn_updates)
+                    {
+                        qn_s.pop_front();
+                        qn_y.pop_front();
+                        qn_rho.pop_front();
+                    }
+                    qn_s.push_back(qn_dU_prev);
+                    qn_y.push_back(y);
+                    qn_rho.push_back(1.0/ys);
+                }
+            }
+            int m = qn_s.size();
+            std::vector<real> a(m);
+            vec q = G;
+            for (int i = m - 1; i >= 0; --i)
+            {
+                a[i] = qn_rho[i]*qn_s[i].dot(q);
+                q -= a[i]*qn_y[i];
+            }
+            vec r = ldlt_factorised ? vec(symmetric_solver.solve(q)) : vec(solver.solve(q));
+            for (int i = 0; i < m; ++i)
+            {
+                real b = qn_rho[i]*qn_y[i].dot(r);
+                r += (a[i] - b)*qn_s[i];
+            }
+            qn_G_prev = G;
+            qn_dU_prev = -r;
+            qn_has_prev = true;
+            assembler.dU = qn_dU_prev.sparseView();
+            if (VERBOSE_NLB)
+            {
+                std::cout << "dU is:" << std::endl << assembler.dU << std::endl;
+            }
+            #else
+            // in the distributed build U -= dU, so dU = HG and s = -dU.
+            Teuchos::Array<real> dot(1);
+            if (qn_has_prev)
+            {
+                Teuchos::RCP<TpetraMultiVector> y = Teuchos::rcp(new TpetraMultiVector(assembler.G, Teuchos::Copy));
+                y->update(-1.0, *qn_G_prev, 1.0);
+                Teuchos::RCP<TpetraMultiVector> s = Teuchos::rcp(new TpetraMultiVector(*qn_dU_prev, Teuchos::Copy));
+                s->scale(-1.0);
+                Teuchos::Array<typename TpetraMultiVector::mag_type> y_norm(1), s_norm(1);
+                {
+                    CommunicationTimer communication("quasi_newton_reductions");
+                    y->norm2(y_norm);
+                    s->norm2(s_norm);
+                    y->dot(*s, dot);
+                }
+                if (dot[0] > 1e-12*y_norm[0]*s_norm[0])
+                {
+                    if ((int)qn_s.size() == max_qn_updates)
+                    {
+                        qn_s.pop_front();
+                        qn_y.pop_front();
+                        qn_rho.pop_front();
+                    }
+                    qn_s.push_back(s);
+                    qn_y.push_back(y);
+                    qn_rho.push_back(1.0/dot[0]);
+                }
+            }
+            int m = qn_s.size();
+            std::vector<real> a(m);
+            Teuchos::RCP<TpetraMultiVector> q = Teuchos::rcp(new TpetraMultiVector(assembler.G, Teuchos::Copy));
+            for (int i = m - 1; i >= 0; --i)
+            {
+                {
+                    CommunicationTimer communication("quasi_newton_reductions");
+                    qn_s[i]->dot(*q, dot);
+                }
+                a[i] = qn_rho[i]*dot[0];
+                q->update(-a[i], *qn_y[i], 1.0);
+            }
+            // r = K0^{-1} q is written straight into dU.
+            dU_solver->setB(q);
+            {
+                CommunicationTimer communication("direct_solve");
+                dU_solver->solve();
+            }
+            dU_solver->setB(G_rcp);
+            for (int i = 0; i < m; ++i)
+            {
+                {
+                    CommunicationTimer communication("quasi_newton_reductions");
+                    qn_y[i]->dot(assembler.dU, dot);
+                }
+                real b = qn_rho[i]*dot[0];
+                assembler.dU.update(a[i] - b, *qn_s[i], 1.0);
+            }
+            qn_G_prev = Teuchos::rcp(new TpetraMultiVector(assembler.G, Teuchos::Copy));
+            qn_dU_prev = Teuchos::rcp(new TpetraMultiVector(assembler.dU, Teuchos::Copy));
+            qn_has_prev = true;
             #endif
         }
         
@@ -0,0 +1,115 @@
+#ifndef BINARY_MESH_TESTS_HPP
+#define BINARY_MESH_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+class BinaryMeshTests : public ::testing::Test {
+  public:
+    GlobalMesh line_mesh;
+    BinaryMeshData mesh_data;
+    std::string file_name = (std::filesystem::temp_directory_path()/"blaze_binary_mesh_test.blzmesh").string();
+    int divisions = 10;
+
+    void SetUp() override {
+        std::pair<NodeIdCoordsPairsVector, ElemIdNodeIdPairVector> mesh_maps = line_mesh.map_a_line_mesh(divisions, std::vector<coords>{{0.0, 0.0, 0.0}, {10.0, 0.0, 0.0}});
+        // write the elements in reverse to check that the file is stored in ID order.
+        for (auto& node : mesh_maps.first)
+        {
+            mesh_data.node_ids.push_back(node.first);
+            mesh_data.node_coords.insert(mesh_data.node_coords.end(), node.second.data(), node.second.data() + 3);
+        }
+        for (auto elem = mesh_maps.second.rbegin(); elem != mesh_maps.second.rend(); ++elem)
+        {
+            mesh_data.elem_ids.push_back(elem->first);
+            mesh_data.elem_node_ids.insert(mesh_data.elem_node_ids.end(), elem->second.begin(), elem->second.end());
+            mesh_data.elem_node_offsets.push_back(mesh_data.elem_node_ids.size());
+            mesh_data.elem_section_ids.push_back(0);
+            mesh_data.elem_material_ids.push_back(0);
+        }
+        write_binary_mesh(file_name, mesh_data);
+    }
+    void TearDown() override {
+        std::filesystem::remove(file_name);
+    }
+};
+
+TEST_F(BinaryMeshTests, ReadAllRoundTrips)
+{
+    BinaryMeshData read_data = BinaryMeshReader(file_name).read_all();
+    EXPECT_EQ(read_data.node_ids, mesh_data.node_ids);
+    EXPECT_EQ(read_data.node_coords, mesh_data.node_coords);
+    ASSERT_EQ(read_data.num_elements(), mesh_data.num_elements());
+    for (size_t e = 0; e < read_data.num_elements(); ++e)
+    {
+        size_t original = mesh_data.num_elements() - 1 - e;
+        EXPECT_EQ(read_data.elem_ids[e], mesh_data.elem_ids[original]);
+        EXPECT_EQ(read_data.elem_node_ids[2*e], mesh_data.elem_node_ids[2*original]);
+        EXPECT_EQ(read_data.elem_node_ids[2*e + 1], mesh_data.elem_node_ids[2*original + 1]);
+    }
+}
+
+TEST_F(BinaryMeshTests, PartitionsCoverMesh)
+{
+    BinaryMeshReader reader(file_name);
+    int num_ranks = 3;
+    std::vector<unsigned> owned_nodes;
+    std::set<unsigned> elements;
+    for (int rank = 0; rank < num_ranks; ++rank)
+    {
+        BinaryMeshPartition partition = reader.read_partition(rank, num_ranks);
+        owned_nodes.insert(owned_nodes.end(), partition.mesh.node_ids.begin(), partition.mesh.node_ids.begin() + partition.num_owned_nodes);
+        elements.insert(partition.mesh.elem_ids.begin(), partition.mesh.elem_ids.end());
+        for (size_t i = 0; i < partition.mesh.num_nodes(); ++i)
+            EXPECT_EQ(partition.node_ranks[i] == rank, i < partition.num_owned_nodes);
+        // every node of the rank's elements must be on the rank.
+        std::set<unsigned> rank_nodes(partition.mesh.node_ids.begin(), partition.mesh.node_ids.end());
+        for (unsigned node_id : partition.mesh.elem_node_ids)
+            EXPECT_TRUE(rank_nodes.count(node_id));
+    }
+    EXPECT_EQ(owned_nodes, mesh_data.node_ids);
+    EXPECT_EQ(elements, std::set<unsigned>(mesh_data.elem_ids.begin(), mesh_data.elem_ids.end()));
+}
+
+TEST_F(BinaryMeshTests, ModelFromBinaryFileMatchesLineMesh)
+{
+    Model model;
+    BasicSection sect(2.06e11, 0.0125, 0.0004570000);
+    model.create_mesh_from_binary_file(file_name, NonlinearElastic, sect);
+    EXPECT_EQ(model.glob_mesh.get_num_nodes(), divisions + 1);
+    EXPECT_EQ(model.glob_mesh.get_num_elems(), divisions);
+    EXPECT_NEAR(model.glob_mesh.get_node_by_record_id(divisions + 1, "all")->get_coords()[0], 10.0, 1e-12);
+}
+
+/**
+ * @brief checks that a model started from a setup snapshot, with only the loads and records assigned again, has the same DoFs and reaches the same solution as the model that wrote it.
+ * 
+ */
+TEST(SetupSnapshot, MatchesFreshSetup)
+{
+    int divisions = 10;
+    real y_load = -2e6;
+    std::string prefix = (std::filesystem::temp_directory_path()/"blaze_setup_snapshot_test").string();
+    Model fresh_model;
+    build_solver_test_cantilever(fresh_model, divisions, 10.0, y_load);
+    fresh_model.write_setup_snapshot(prefix);
+    fresh_model.initialise_solution_parameters(1.0, 10, 1e-4, 30);
+    fresh_model.solve(-1);
+
+    Model snapshot_model;
+    BasicSection sect(2.06e11, 0.0125, 0.0004570000);
+    snapshot_model.create_mesh_from_setup_snapshot(prefix, NonlinearElastic, sect);
+    std::filesystem::remove(Model::get_setup_snapshot_file_name(prefix, 0));
+    EXPECT_TRUE(snapshot_model.restraints.empty());
+    snapshot_model.load_manager.create_a_nodal_load_by_id(std::vector<unsigned>{(unsigned)(divisions+1)}, std::set<int>{2}, std::vector<real>{y_load}, snapshot_model.glob_mesh);
+    snapshot_model.scribe.track_nodes_by_id(std::set<unsigned>{(unsigned)(divisions+1)}, std::set<int>{0, 2}, snapshot_model.glob_mesh);
+    snapshot_model.initialise_restraints_n_loads();
+    EXPECT_EQ(snapshot_model.glob_mesh.get_ndofs(), fresh_model.glob_mesh.get_ndofs());
+    EXPECT_EQ(snapshot_model.glob_mesh.get_num_elems(), divisions);
+    snapshot_model.initialise_solution_parameters(1.0, 10, 1e-4, 30);
+    snapshot_model.solve(-1);
+
+    EXPECT_DOUBLE_EQ(get_solver_test_tip_disp(snapshot_model, 2), get_solver_test_tip_disp(fresh_model, 2));
+    EXPECT_DOUBLE_EQ(get_solver_test_tip_disp(snapshot_model, 0), get_solver_test_tip_disp(fresh_model, 0));
+}
+
+#endif
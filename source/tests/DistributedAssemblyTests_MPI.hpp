@@ -319,4 +319,84 @@ class DistributedModelSimplySuportedUdlPlastic : public ::testing::Test {
     }
 
   }
+
+  /**
+   * @brief a simply supported elastic beam with a negative Young's modulus and symmetric stiffness storage, so that \f$\boldsymbol{K}\f$ is negative definite and the Cholesky factorisation fails.
+   */
+  class DistributedModelSymmetricFallback : public ::testing::Test {
+    public:
+      Model model;
+      
+      int divisions = 20;
+      real beam_length = 5.0;
+      real y_udl = -1e4; // N/m
+      real youngs_modulus = -2.06e11;
+      real moment_of_inertia = 0.0004570000;
+      
+      unsigned mid_node = (divisions/2) + 1;
+      std::vector<unsigned> loaded_nodes = std::vector<unsigned>(divisions - 1);
+      int tracked_dof = 2;
+      
+      int rank = 0;
+      
+      NodalRestraint end_restraints_1;
+      NodalRestraint end_restraints_2;
+      NodalRestraint out_of_plane_restraint; 
+      
+      void SetUp() override {
+          if (!Amesos2::query("cholmod"))
+          {
+              GTEST_SKIP() << "Amesos2 was built without cholmod; there is no symmetric factorisation to fall back from.";
+          }
+          get_my_rank(rank);
+          BasicSection sect(youngs_modulus, 0.0125, moment_of_inertia);
+          model.create_distributed_line_mesh(divisions, {{0.0, 0.0, 0.0}, {beam_length, 0.0, 0.0}}, LinearElastic, sect);
+
+          std::set<unsigned> end_nodes_1 = {1};
+          std::set<unsigned> end_nodes_2 = {unsigned(1 + divisions)};
+          end_restraints_1.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4});
+          end_restraints_1.assign_distributed_nodes_by_record_id(end_nodes_1, model.glob_mesh);
+          end_restraints_2.assign_dofs_restraints(std::set<int>{1, 2, 3, 4});
+          end_restraints_2.assign_distributed_nodes_by_record_id(end_nodes_2, model.glob_mesh);
+
+          std::iota(loaded_nodes.begin(), loaded_nodes.end(), 2);
+          out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
+          out_of_plane_restraint.assign_distributed_nodes_by_record_id(loaded_nodes, model.glob_mesh);
+
+          model.restraints.push_back(end_restraints_1);
+          model.restraints.push_back(end_restraints_2);
+          model.restraints.push_back(out_of_plane_restraint);
+
+          real y_load = y_udl*beam_length/(divisions - 1);
+          model.load_manager.create_a_distributed_nodal_load_by_id(loaded_nodes, std::set<int>{tracked_dof}, std::vector<real>{y_load}, model.glob_mesh);
+          model.scribe.track_distributed_nodes_by_id(rank ,std::vector<unsigned>{mid_node}, std::set<int>{tracked_dof}, model.glob_mesh);
+
+          model.set_symmetric_stiffness(true);
+          model.initialise_restraints_n_loads();
+          model.initialise_solution_parameters(1.0, 1, 1e-3, 10);
+        }
+      void TearDown() override {
+  }
+  };
+
+  TEST_F(DistributedModelSymmetricFallback, BothSolversFallBackToLU)
+  {
+    // the solution procedure only uses the dU solver, so it is the one that first fails with cholmod.
+    model.solve(-1);
+    EXPECT_EQ(model.solver.get_num_lu_fallbacks(), 1);
+    EXPECT_FALSE(model.assembler.get_symmetric_storage());
+
+    // the U solver was also moved to klu2, so it must neither rethrow nor fall back a second time.
+    EXPECT_NO_THROW(model.solver.solve_for_U(model.assembler));
+    EXPECT_EQ(model.solver.get_num_lu_fallbacks(), 1);
+
+    if (model.glob_mesh.owns_node_record_id(mid_node))
+    {
+        std::vector<Record> record_library = model.scribe.get_record_library();
+        std::vector<real> disp_data = record_library.back().get_recorded_data()[tracked_dof];
+
+        real correct_disp = 5*y_udl*std::pow(beam_length, 4)/(384*youngs_modulus*moment_of_inertia);
+        EXPECT_NEAR(disp_data.back(), correct_disp, std::abs(PERCENT_TOLERANCE*correct_disp));
+    }
+  }
 #endif 
\ No newline at end of file
@@ -0,0 +1,69 @@
+#ifndef DISTRIBUTED_DYNAMICS_TESTS_HPP
+#define DISTRIBUTED_DYNAMICS_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+#define DISTRIBUTED_DYNAMIC_DENSITY 7850.0
+
+/**
+ * @brief the cantilever of \ref CantileverBeamDynamic, distributed over the ranks.
+ */
+class DistributedCantileverBeamDynamic : public ::testing::Test {
+    public:
+      Model model;
+      int divisions = 5;
+      real y_load = -1e3;
+      unsigned tracked_node_id = divisions + 1;
+      int tracked_dof = 2;
+      real beam_length = 10.0;
+      real static_disp = y_load*std::pow(beam_length, 3)/(3*(2.06e11)*(0.0004570000));
+      // first natural frequency of a cantilever: \omega_1 = 1.875^2 \sqrt{EI/(\rho A L^4)}
+      real omega_1 = 1.875*1.875*std::sqrt(2.06e11*0.0004570000/(DISTRIBUTED_DYNAMIC_DENSITY*0.0125*std::pow(beam_length, 4)));
+      real period_1 = 2*M_PI/omega_1;
+
+      int rank = 0;
+      NodalRestraint end_restraint;
+      NodalRestraint out_of_plane_restraint;
+
+      void SetUp() override {
+          get_my_rank(rank);
+          BasicSection sect(2.06e11, 0.0125, 0.0004570000);
+          model.create_distributed_line_mesh(divisions, {{0.0, 0.0, 0.0}, {beam_length, 0.0, 0.0}}, LinearElastic, sect);
+
+          end_restraint.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4, 5});
+          end_restraint.assign_distributed_nodes_by_record_id(std::set<unsigned>{1}, model.glob_mesh);
+          model.restraints.push_back(end_restraint);
+
+          std::vector<unsigned> free_nodes(divisions);
+          std::iota(free_nodes.begin(), free_nodes.end(), 2);
+          out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
+          out_of_plane_restraint.assign_distributed_nodes_by_record_id(free_nodes, model.glob_mesh);
+          model.restraints.push_back(out_of_plane_restraint);
+
+          model.load_manager.create_a_distributed_nodal_load_by_id(std::vector<unsigned>{tracked_node_id}, std::set<int>{tracked_dof}, std::vector<real>{y_load}, model.glob_mesh);
+          model.scribe.track_distributed_nodes_by_id(rank, std::vector<unsigned>{tracked_node_id}, std::set<int>{tracked_dof}, model.glob_mesh);
+          model.initialise_restraints_n_loads();
+      }
+      void TearDown() override {
+  }
+};
+
+/**
+ * @brief checks that the distributed explicit analysis settles on the static tip deflection, as \ref CantileverBeamDynamic does in the serial build.
+ */
+TEST_F(DistributedCantileverBeamDynamic, DampedResponseSettlesOnStaticSolution)
+{
+    // 40% of critical damping in the first mode.
+    real damping_alpha = 2*0.4*omega_1;
+    model.initialise_dynamic_parameters(1.0, 4*period_1, 0.0, DISTRIBUTED_DYNAMIC_DENSITY, damping_alpha, 0.0, 20);
+    model.solve_dynamic(-1);
+    if (model.glob_mesh.owns_node_record_id(tracked_node_id))
+    {
+        real disp = model.glob_mesh.get_node_by_id(tracked_node_id)->get_nodal_displacement(tracked_dof);
+        EXPECT_NEAR(disp, static_disp, std::abs(PERCENT_TOLERANCE*static_disp));
+    } else {
+        GTEST_SKIP() << "Rank " << rank  << " does not own the node; skipping check.";
+    }
+}
+
+#endif
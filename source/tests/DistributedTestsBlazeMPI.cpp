@@ -2,6 +2,7 @@
 #include "DistributedManagersTests_MPI.hpp"
 #include "TimeKeeperTests_MPI.hpp"
 #include "DistributedAssemblyTests_MPI.hpp"
+#include "DistributedDynamicsTests_MPI.hpp"
 int main(int argc, char* argv[])
 {
   ::testing::InitGoogleTest(&argc, argv);
@@ -217,4 +217,25 @@ TEST_F(ElasticPlasticMaterialTest, IncrementStrainCyclicNonZeroPlastic)
     EXPECT_NEAR(calculated_plastic_strain, correct_plastic_strain, BASIC_TOLERANCE);
 }
 
-#endif
\ No newline at end of file
+/**
+ * @brief checks that \ref Material1D::revert_state discards a trial increment and returns exactly to the committed state.
+ * 
+ */
+TEST_F(ElasticPlasticMaterialTest, RevertRestoresCommittedState)
+{
+    Steel.increment_strain(1.1*yield_strain);
+    Steel.commit_state();
+    real committed_stress = Steel.get_stress();
+    real committed_plastic_strain = Steel.get_plastic_strain();
+
+    Steel.increment_strain(0.5*yield_strain);
+    EXPECT_GT(Steel.get_stress(), committed_stress);
+    Steel.revert_state();
+
+    EXPECT_NEAR(Steel.get_stress(), committed_stress, BASIC_TOLERANCE);
+    EXPECT_NEAR(Steel.get_plastic_strain(), committed_plastic_strain, BASIC_TOLERANCE);
+    EXPECT_NEAR(Steel.get_strain(), Steel.get_starting_strain(), BASIC_TOLERANCE);
+    EXPECT_FALSE(Steel.is_elastic());
+}
+
+#endif
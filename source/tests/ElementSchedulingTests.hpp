@@ -0,0 +1,65 @@
+#ifndef ELEMENT_SCHEDULING_TESTS_HPP
+#define ELEMENT_SCHEDULING_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+/**
+ * @brief checks that the cost-balanced element chunks cover every element once, and that the busy and idle time of each thread is reported after a solution.
+ * 
+ */
+TEST(ElementScheduling, ChunksCoverAllElements)
+{
+    int divisions = 10;
+    Model model;
+    build_solver_test_cantilever(model, divisions, 10.0, -2e6);
+    model.initialise_solution_parameters(1.0, 5, 1e-4, 30);
+    model.solve(-1);
+
+    std::vector<size_t> chunk_starts = model.glob_mesh.get_element_chunk_starts();
+    ASSERT_GE(chunk_starts.size(), 2);
+    EXPECT_EQ(chunk_starts.front(), 0);
+    EXPECT_EQ(chunk_starts.back(), (size_t)divisions);
+    for (size_t i = 1; i < chunk_starts.size(); ++i)
+        EXPECT_LT(chunk_starts[i-1], chunk_starts[i]);
+
+    auto [busy, idle] = model.solution_procedure.get_element_update_thread_durations();
+    ASSERT_EQ(busy.size(), (size_t)get_max_num_threads());
+    ASSERT_EQ(idle.size(), busy.size());
+    EXPECT_GT(std::accumulate(busy.begin(), busy.end(), 0.0), 0.0);
+    for (size_t thread = 0; thread < busy.size(); ++thread)
+        EXPECT_GE(idle[thread], 0.0);
+}
+
+/**
+ * @brief checks that with unequal element costs each chunk made by \ref GlobalMesh::balance_element_chunks is within one element cost of an equal share of the total, although the chunks then hold different numbers of elements.
+ * 
+ */
+TEST(ElementScheduling, BalancedChunksBoundCostSpread)
+{
+    int divisions = 64;
+    int num_threads = 2;
+    Model model;
+    BasicSection sect(2.06e11, 0.0125, 0.0004570000);
+    model.create_line_mesh(divisions, {{0.0, 0.0, 0.0}, {10.0, 0.0, 0.0}}, LinearElastic, sect);
+    // the first quarter of the elements are ten times as costly, as yielded elements at a fixed end would be.
+    std::vector<std::uint64_t> costs(divisions, 100);
+    std::fill(costs.begin(), costs.begin() + divisions/4, 1000);
+    model.glob_mesh.set_element_costs(costs);
+    model.glob_mesh.balance_element_chunks(num_threads);
+
+    std::vector<size_t> chunk_starts = model.glob_mesh.get_element_chunk_starts();
+    size_t num_chunks = chunk_starts.size() - 1;
+    ASSERT_GT(num_chunks, 1);
+    EXPECT_EQ(chunk_starts.back(), (size_t)divisions);
+    std::uint64_t max_cost = *std::max_element(costs.begin(), costs.end());
+    real equal_share = static_cast<real>(std::accumulate(costs.begin(), costs.end(), std::uint64_t(0)))/num_chunks;
+    ASSERT_LT(max_cost, equal_share);
+    for (size_t chunk = 0; chunk < num_chunks; ++chunk)
+    {
+        std::uint64_t chunk_cost = std::accumulate(costs.begin() + chunk_starts[chunk], costs.begin() + chunk_starts[chunk + 1], std::uint64_t(0));
+        EXPECT_LE(std::abs(static_cast<real>(chunk_cost) - equal_share), static_cast<real>(max_cost));
+    }
+    EXPECT_LT(chunk_starts[1] - chunk_starts[0], chunk_starts[num_chunks] - chunk_starts[num_chunks - 1]);
+}
+
+#endif
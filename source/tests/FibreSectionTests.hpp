@@ -468,4 +468,79 @@ TEST_F(FibreSectionTangentConstitutiveMatrixHardening, CheckDtPostYield)
     EXPECT_NEAR(percent_error_00, 0.0, PERCENT_TOLERANCE);
     EXPECT_NEAR(percent_error_11, 0.0, PERCENT_TOLERANCE);
 }
-#endif 
+class FibreSectionElasticFastPath : public ::testing::Test {
+  public:
+    ElasticPlasticMaterial hardening_steel = ElasticPlasticMaterial(YOUNGS_MODULUS, YIELD_STRENGTH, 0.01*YOUNGS_MODULUS);
+    BeamColumnFiberSection fast_section;
+    BeamColumnFiberSection fibre_section;
+    real axial_yield_strain = YIELD_STRENGTH/YOUNGS_MODULUS;
+    real yield_curvature = 2*axial_yield_strain/467.2e-3;
+
+    void SetUp() override {
+        initialise_I_section(fast_section, hardening_steel, 0.0, 19.6e-3, 192.8e-3, 11.4e-3, 467.2e-3, 10, 40);
+        initialise_I_section(fibre_section, hardening_steel, 0.0, 19.6e-3, 192.8e-3, 11.4e-3, 467.2e-3, 10, 40);
+        fibre_section.set_elastic_fast_path(false);
+    }
+
+    /**
+     * @brief applies the same strain to both sections and checks that forces and tangents agree.
+     */
+    void apply_and_compare(real axial_strain, real curvature, bool commit)
+    {
+        vec eps = make_xd_vec(2);
+        eps << axial_strain, curvature;
+        fast_section.update_section_state(eps);
+        fibre_section.update_section_state(eps);
+        EXPECT_NEAR(fast_section.get_axial_force(), fibre_section.get_axial_force(), 1e-6*std::abs(fibre_section.get_axial_force()) + 1e-6);
+        EXPECT_NEAR(fast_section.get_moment_yy(), fibre_section.get_moment_yy(), 1e-6*std::abs(fibre_section.get_moment_yy()) + 1e-6);
+        EXPECT_NEAR(fast_section.get_D_t()(1,1), fibre_section.get_D_t()(1,1), 1e-6*fibre_section.get_D_t()(1,1));
+        if (commit)
+        {
+            fast_section.update_section_starting_state();
+            fibre_section.update_section_starting_state();
+        }
+    }
+};
+
+/**
+ * @brief checks that the closed-form elastic update of \ref BeamColumnFiberSection matches the fibre integration before and after yield, and that it is used while the section is elastic.
+ * 
+ */
+TEST_F(FibreSectionElasticFastPath, MatchesFibreIntegration)
+{
+    apply_and_compare(0.1*axial_yield_strain, 0.2*yield_curvature, false);
+    apply_and_compare(0.2*axial_yield_strain, 0.3*yield_curvature, true);
+    EXPECT_EQ(fast_section.get_num_fast_updates(), 2);
+    apply_and_compare(0.2*axial_yield_strain, 1.5*yield_curvature, true);
+    apply_and_compare(0.2*axial_yield_strain, 0.5*yield_curvature, true);
+    EXPECT_FALSE(fast_section.is_all_elastic());
+    EXPECT_EQ(fibre_section.get_num_fast_updates(), 0);
+}
+/**
+ * @brief checks that copies of a \ref BeamColumnFiberSection share their fibre geometry and only allocate fibre states once they yield.
+ * 
+ */
+TEST_F(FibreSectionElasticFastPath, SharesGeometryUntilYield)
+{
+    BeamColumnFiberSection gauss_point_section(fast_section);
+    EXPECT_EQ(gauss_point_section.get_geometry_use_count(), 2);
+    EXPECT_NEAR(gauss_point_section.get_A(), fast_section.get_A(), BASIC_TOLERANCE);
+
+    vec eps = make_xd_vec(2);
+    eps << 0.2*axial_yield_strain, 0.3*yield_curvature;
+    gauss_point_section.update_section_state(eps);
+    gauss_point_section.update_section_starting_state();
+    EXPECT_FALSE(gauss_point_section.has_own_fibres());
+
+    eps(1) = 1.5*yield_curvature;
+    gauss_point_section.update_section_state(eps);
+    EXPECT_TRUE(gauss_point_section.has_own_fibres());
+    EXPECT_FALSE(fast_section.has_own_fibres());
+
+    std::vector<real> areas = {1e-4};
+    std::vector<real> ys = {0.0};
+    fast_section.add_fibres(&hardening_steel, areas, ys);
+    EXPECT_EQ(gauss_point_section.get_geometry_use_count(), 1);
+    EXPECT_NEAR(fast_section.get_A() - gauss_point_section.get_A(), 1e-4, BASIC_TOLERANCE);
+}
+#endif
@@ -0,0 +1,141 @@
+#ifndef MATERIAL_BATCH_TESTS_HPP
+#define MATERIAL_BATCH_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+class MaterialBatchTest : public ::testing::Test {
+  public:
+    real yield_strain = YIELD_STRENGTH/YOUNGS_MODULUS;
+    MenegottoPintoMaterial::Parameters mp_parameters = {YOUNGS_MODULUS, YIELD_STRENGTH, HARDENING_RATIO_MAT};
+    MenegottoPintoMaterial mp_steel = MenegottoPintoMaterial(mp_parameters);
+
+    void SetUp() override {
+        
+    }
+    void TearDown() override {
+}
+};
+
+/**
+ * @details checks that a \ref MaterialBatch of \ref ElasticPlasticMaterial points follows the same cyclic path as the per-point material.
+ * 
+ */
+TEST_F(MaterialBatchTest, ElasticPlasticMatchesScalar)
+{
+    ElasticPlasticMaterial steel(YOUNGS_MODULUS, YIELD_STRENGTH, HARDENING_RATIO_MAT*YOUNGS_MODULUS);
+    std::vector<ElasticPlasticMaterial> scalar_points(3, steel);
+    std::vector<ElasticPlasticMaterial::Parameters> parameters(3, steel.get_parameters());
+    std::vector<ElasticPlasticMaterial::State> initial_states(3, steel.get_starting_state());
+    MaterialBatch<ElasticPlasticMaterial> batch;
+    batch.initialise(initial_states);
+
+    std::vector<real> strain_history = {0.5, 1.5, 3.0, 1.0, -2.0, -0.5, 2.5};
+    for (real strain : strain_history)
+    {
+        std::span<real> strain_increments = batch.get_strain_increments();
+        for (size_t i = 0; i < 3; ++i)
+        {
+            strain_increments[i] = (i + 1)*strain*yield_strain - batch.get_starting_state(i, parameters[i]).strain;
+            scalar_points[i].increment_strain(strain_increments[i]);
+            scalar_points[i].update_starting_state();
+        }
+        batch.increment_strains(parameters);
+        batch.commit();
+        for (size_t i = 0; i < 3; ++i)
+        {
+            EXPECT_EQ(batch.get_current_states()[i].stress, scalar_points[i].get_stress());
+            EXPECT_EQ(batch.get_current_states()[i].E_t, scalar_points[i].get_E_t());
+            EXPECT_EQ(batch.get_current_states()[i].plastic_strain, scalar_points[i].get_plastic_strain());
+        }
+    }
+}
+
+/**
+ * @details checks that compact storage of the committed states only rounds the stresses to single precision, and recovers the tangents exactly.
+ * 
+ */
+TEST_F(MaterialBatchTest, CompactStorageMatchesFullPrecision)
+{
+    ElasticPlasticMaterial steel(YOUNGS_MODULUS, YIELD_STRENGTH, HARDENING_RATIO_MAT*YOUNGS_MODULUS);
+    std::vector<ElasticPlasticMaterial::Parameters> parameters(2, steel.get_parameters());
+    std::vector<ElasticPlasticMaterial::State> initial_states(2, steel.get_starting_state());
+    MaterialBatch<ElasticPlasticMaterial> full_batch, compact_batch;
+    full_batch.initialise(initial_states);
+    compact_batch.set_compact_storage(true, parameters);
+    compact_batch.initialise(initial_states);
+
+    std::vector<real> strain_history = {0.5, 1.5, 3.0, 1.0, -2.0, -0.5, 2.5};
+    for (real strain : strain_history)
+    {
+        for (auto* batch : {&full_batch, &compact_batch})
+        {
+            std::span<real> strain_increments = batch->get_strain_increments();
+            for (size_t i = 0; i < 2; ++i)
+                strain_increments[i] = (i + 1)*strain*yield_strain - batch->get_starting_state(i, parameters[i]).strain;
+            batch->increment_strains(parameters);
+            batch->commit();
+        }
+        for (size_t i = 0; i < 2; ++i)
+        {
+            EXPECT_NEAR(compact_batch.get_current_states()[i].stress, full_batch.get_current_states()[i].stress, 1e-6*YIELD_STRENGTH);
+            EXPECT_EQ(compact_batch.get_current_states()[i].E_t, full_batch.get_current_states()[i].E_t);
+        }
+    }
+    EXPECT_GT(compact_batch.get_max_stress_rounding(), 0.0);
+    EXPECT_LT(compact_batch.get_max_stress_rounding(), 1e-7*2*YIELD_STRENGTH);
+}
+
+/**
+ * @details checks that monotonic loading of \ref MenegottoPintoMaterial approaches the hardening asymptote \f$ f_y + bE_0(\varepsilon - \varepsilon_y)\f$ and is initially elastic.
+ * 
+ */
+TEST_F(MaterialBatchTest, MenegottoPintoMonotonicEnvelope)
+{
+    mp_steel.increment_strain(0.1*yield_strain);
+    EXPECT_NEAR(mp_steel.get_stress(), 0.1*YIELD_STRENGTH, PERCENT_TOLERANCE*0.1*YIELD_STRENGTH);
+    mp_steel.increment_strain(10*yield_strain);
+    real asymptote_stress = YIELD_STRENGTH + HARDENING_RATIO_MAT*YIELD_STRENGTH*9;
+    EXPECT_NEAR(mp_steel.get_stress(), asymptote_stress, 0.01*asymptote_stress);
+    EXPECT_NEAR(mp_steel.get_E_t(), HARDENING_RATIO_MAT*YOUNGS_MODULUS, 0.01*YOUNGS_MODULUS);
+}
+
+/**
+ * @details checks that \ref MenegottoPintoMaterial unloads with the initial stiffness after a strain reversal, and that the reversal is reverted with the state.
+ * 
+ */
+TEST_F(MaterialBatchTest, MenegottoPintoReversal)
+{
+    mp_steel.increment_strain(5*yield_strain);
+    mp_steel.commit_state();
+    real reversal_stress = mp_steel.get_stress();
+    mp_steel.increment_strain(-0.01*yield_strain);
+    EXPECT_NEAR(mp_steel.get_E_t(), YOUNGS_MODULUS, PERCENT_TOLERANCE*YOUNGS_MODULUS);
+    EXPECT_NEAR(mp_steel.get_stress(), reversal_stress - 0.01*YIELD_STRENGTH, PERCENT_TOLERANCE*0.01*YIELD_STRENGTH);
+    mp_steel.revert_state();
+    EXPECT_EQ(mp_steel.get_current_state().direction, 1);
+    mp_steel.increment_strain(-20*yield_strain);
+    EXPECT_LT(mp_steel.get_stress(), -YIELD_STRENGTH);
+}
+
+/**
+ * @details checks that a \ref BeamColumnFiberSection with \ref MenegottoPintoMaterial fibres integrates their stresses and never takes the elastic fast path.
+ * 
+ */
+TEST_F(MaterialBatchTest, MenegottoPintoFibreSection)
+{
+    BeamColumnFiberSection section;
+    std::vector<real> areas = {1e-3, 1e-3};
+    std::vector<real> ys = {-0.1, 0.1};
+    section.add_fibres(&mp_steel, areas, ys);
+    vec eps = make_xd_vec(2);
+    eps << 0.1*yield_strain, 0.0;
+    section.update_section_state(eps);
+    EXPECT_EQ(section.get_num_fast_updates(), 0);
+    EXPECT_TRUE(section.has_own_fibres());
+
+    MenegottoPintoMaterial fibre(mp_parameters);
+    fibre.increment_strain(0.1*yield_strain);
+    EXPECT_NEAR(section.get_axial_force(), 2e-3*fibre.get_stress(), BASIC_TOLERANCE);
+    EXPECT_NEAR(section.get_D_t()(0,0), 2e-3*fibre.get_E_t(), BASIC_TOLERANCE*YOUNGS_MODULUS);
+}
+#endif
@@ -84,6 +84,48 @@ TEST_F(RestraintTests, RestrainedDoFsFreeNode)
     EXPECT_EQ(inactive_dofs.size(), 3);
 }
 
+TEST_F(RestraintTests, MeshLayoutMatchesNodeDoFs)
+{
+    const MeshLayout& layout = model.glob_mesh.get_layout();
+    ASSERT_EQ(layout.num_nodes(), divisions + 1);
+    ASSERT_EQ(layout.num_elements(), divisions);
+    EXPECT_EQ(layout.dof_offsets[layout.num_nodes()], model.glob_mesh.get_ndofs());
+    for (size_t i = 0; i < layout.num_nodes(); ++i)
+    {
+        std::set<int> active_dofs = layout.nodes[i]->get_active_dofs();
+        ASSERT_EQ(layout.dof_offsets[i + 1] - layout.dof_offsets[i], (int)active_dofs.size());
+        int j = layout.dof_offsets[i];
+        for (int dof : active_dofs)
+        {
+            EXPECT_EQ(layout.dofs[j], dof);
+            EXPECT_EQ(layout.U_indices[j], layout.nodes[i]->get_nz_i() + (j - layout.dof_offsets[i]));
+            ++j;
+        }
+    }
+}
+
+TEST_F(RestraintTests, MeshLayoutRebuiltAfterRenumbering)
+{
+    const MeshLayout& layout = model.glob_mesh.get_layout();
+    int ndofs = layout.dof_offsets[layout.num_nodes()];
+    std::shared_ptr<Node> node = model.glob_mesh.get_node_by_id(2);
+    node->fix_dof(*node->get_active_dofs().begin());
+    model.glob_mesh.count_dofs();
+    const MeshLayout& renumbered_layout = model.glob_mesh.get_layout();
+    ASSERT_EQ(renumbered_layout.num_nodes(), divisions + 1);
+    EXPECT_EQ(renumbered_layout.dof_offsets[renumbered_layout.num_nodes()], ndofs - 1);
+    for (size_t i = 0; i < renumbered_layout.num_nodes(); ++i)
+    {
+        int j = renumbered_layout.dof_offsets[i];
+        for (int dof : renumbered_layout.nodes[i]->get_active_dofs())
+        {
+            EXPECT_EQ(renumbered_layout.dofs[j], dof);
+            EXPECT_EQ(renumbered_layout.U_indices[j], renumbered_layout.nodes[i]->get_nz_i() + (j - renumbered_layout.dof_offsets[i]));
+            ++j;
+        }
+    }
+}
+
 class LoadTests : public ::testing::Test {
   public:
     Model model;
@@ -157,6 +199,20 @@ TEST_F(LoadTests, UnloadedNodeTotalLoads)
     EXPECT_NEAR(std::accumulate(loads.begin(), loads.end(), 0), 0.0, BASIC_TOLERANCE);
 }
 
+TEST_F(LoadTests, AssembledPMatchesNodalLoads)
+{
+    std::shared_ptr<Node> node = model.glob_mesh.get_node_by_id(divisions+1);
+    int row = node->get_nz_i() + 1; // DoF 1 is the first active DoF of the free node.
+    for (int step = 1; step <= 3; ++step)
+    {
+        model.load_manager.increment_loads(0.5);
+        model.glob_mesh.calc_nodal_contributions_to_P();
+        model.assembler.assemble_global_P(model.glob_mesh);
+        EXPECT_EQ(model.assembler.get_P().nonZeros(), 1);
+        EXPECT_NEAR(model.assembler.get_P().coeff(row, 0), 0.5*step*y_load, BASIC_TOLERANCE);
+    }
+}
+
 class ScribeTests : public ::testing::Test {
   public:
     Model model;
@@ -191,4 +191,109 @@ class CantileverBeamPlastic : public ::testing::Test {
       EXPECT_NEAR(disp_data.back(), correct_disp, tolerance);
   }
 
+  /**
+   * @brief a cantilever loaded between its first-yield and plastic moments, solved with full-precision and with compact storage of the committed fibre states.
+   */
+  class CantileverBeamPlasticCompactState : public ::testing::Test {
+    public:
+      CommonSectionDefinitions common;
+      real beam_length = 5.0;
+      real y_load = -0.99*common.correct_plastic_moment/beam_length;
+      int divisions = 10;
+      int nsteps = 50;
+      int tracked_dof = 2;
+
+      /**
+       * @brief builds the cantilever in \p model up to \ref Model::initialise_solution_parameters.
+       */
+      void build_cantilever(Model& model, bool compact_state)
+      {
+          BeamColumnFiberSection section(common.I_section);
+          section.set_compact_state_storage(compact_state);
+          model.create_line_mesh(divisions, {{0.0, 0.0, 0.0}, {beam_length, 0.0, 0.0}}, PLASTIC_ELEMENT_TYPE, section);
+
+          NodalRestraint end_restraint;
+          end_restraint.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4, 5});
+          end_restraint.assign_nodes_by_record_id(std::set<int>{1}, model.glob_mesh);
+          model.restraints.push_back(end_restraint);
+
+          std::vector<unsigned> free_nodes(divisions);
+          std::iota(free_nodes.begin(), free_nodes.end(), 2);
+          NodalRestraint out_of_plane_restraint;
+          out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
+          out_of_plane_restraint.assign_nodes_by_record_id(free_nodes, model.glob_mesh);
+          model.restraints.push_back(out_of_plane_restraint);
+
+          model.load_manager.create_a_nodal_load_by_id(std::vector<unsigned>{(unsigned)(divisions+1)}, std::set<int>{tracked_dof}, std::vector<real>{y_load}, model.glob_mesh);
+          model.scribe.track_nodes_by_id(std::set<unsigned>{(unsigned)(divisions+1)}, std::set<int>{tracked_dof}, model.glob_mesh);
+          model.initialise_restraints_n_loads();
+          model.initialise_solution_parameters(1.0, nsteps, 1e-4, 30);
+      }
+
+      real solve_cantilever(bool compact_state)
+      {
+          Model model;
+          build_cantilever(model, compact_state);
+          model.solve(-1);
+          return model.scribe.get_record_library().back().get_recorded_data()[tracked_dof].back();
+      }
+
+      void SetUp() override {
+          common.initialise_section();
+      }
+  };
+
+  /**
+   * @brief checks that storing the committed fibre states in single precision changes the plastic tip displacement by less than \f$10^{-5}\f$ relative.
+   */
+  TEST_F(CantileverBeamPlasticCompactState, MatchesFullPrecision)
+  {
+      real full_disp = solve_cantilever(false);
+      real compact_disp = solve_cantilever(true);
+      real elastic_disp = y_load*std::pow(beam_length, 3)/(3*(YOUNGS_MODULUS)*(common.moment_of_inertia));
+      EXPECT_GT(std::abs(full_disp), 1.05*std::abs(elastic_disp));
+      EXPECT_NEAR(compact_disp, full_disp, 1e-5*std::abs(full_disp));
+  }
+
+  /**
+   * @brief the same plastic cantilever, solved in one go with checkpoints, and restarted from a checkpoint written after yielding.
+   */
+  class CantileverBeamPlasticRestart : public CantileverBeamPlasticCompactState {
+    public:
+      std::string checkpoint_prefix = (std::filesystem::temp_directory_path()/"blaze_restart_test").string();
+      int checkpoint_interval = 10;
+
+      void TearDown() override {
+          for (int completed_steps = checkpoint_interval; completed_steps <= nsteps; completed_steps += checkpoint_interval)
+              std::filesystem::remove(Checkpointer::get_file_name(checkpoint_prefix, completed_steps, 0));
+      }
+  };
+
+  /**
+   * @brief checks that a restarted analysis continues from the restored load step and reproduces the recorded history of the uninterrupted analysis, including the committed plastic state and the secant predictor history.
+   */
+  TEST_F(CantileverBeamPlasticRestart, MatchesUninterruptedAnalysis)
+  {
+      Model full_model;
+      build_cantilever(full_model, false);
+      full_model.set_predictor(SecantPredictor);
+      full_model.set_checkpointing(checkpoint_interval, checkpoint_prefix);
+      full_model.solve(-1);
+      std::vector<real> full_history = full_model.scribe.get_record_library().back().get_recorded_data()[tracked_dof];
+
+      Model restarted_model;
+      build_cantilever(restarted_model, false);
+      restarted_model.set_predictor(SecantPredictor);
+      restarted_model.restart_from_checkpoint(checkpoint_prefix, 3*checkpoint_interval);
+      restarted_model.solve(-1);
+      std::vector<real> restarted_history = restarted_model.scribe.get_record_library().back().get_recorded_data()[tracked_dof];
+
+      ASSERT_EQ(restarted_history.size(), full_history.size());
+      for (size_t i = 0; i < full_history.size(); ++i)
+      {
+          EXPECT_NEAR(restarted_history[i], full_history[i], 1e-9*std::abs(full_history.back()));
+      }
+      EXPECT_LT(restarted_model.solution_procedure.get_num_iterations(), full_model.solution_procedure.get_num_iterations());
+  }
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,106 @@
+#ifndef SCALING_STUDY_TESTS_HPP
+#define SCALING_STUDY_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+class ScalingStudyTests : public ::testing::Test {
+  public:
+    ScalingStudy study;
+    std::filesystem::path output_dir = std::filesystem::temp_directory_path()/"blaze_scaling_study_test";
+
+    void read_spec(std::string mode)
+    {
+        std::istringstream spec("# comments and blank lines are skipped\n\n"
+                                "mode = " + mode + "\n"
+                                "ranks = 1 2 4\n"
+                                "threads = 1\n"
+                                "nbays = 3  # doubled with the workers in weak scaling\n"
+                                "nfloors = 2\n"
+                                "output_dir = " + output_dir.string() + "\n");
+        study.read_spec(spec);
+    }
+
+    /**
+     * @brief writes the timers file `Blaze` would write for a run, with the rank durations given.
+     */
+    void write_timers_file(const ScalingRun& run, std::vector<double> all_durations)
+    {
+        std::ofstream out(study.get_run_name(run) + ".csv");
+        out << "rank,timer,duration" << std::endl;
+        for (size_t rank = 0; rank < all_durations.size(); ++rank)
+        {
+            out << rank << ",all," << all_durations[rank] << std::endl;
+        }
+    }
+
+    void SetUp() override {
+        std::filesystem::create_directories(output_dir);
+    }
+    void TearDown() override {
+        std::filesystem::remove_all(output_dir);
+    }
+};
+
+TEST_F(ScalingStudyTests, WeakScalingGrowsTheFrame)
+{
+    read_spec("weak");
+    std::vector<ScalingRun> runs = study.plan_runs();
+    ASSERT_EQ(runs.size(), 3);
+    EXPECT_EQ(runs[0].nbays, 3);
+    EXPECT_EQ(runs[1].nbays, 6);
+    EXPECT_EQ(runs[2].nbays, 12);
+    EXPECT_EQ(runs[2].nfloors, 2);
+    std::string command = study.get_run_command(runs[2]);
+    EXPECT_NE(command.find("mpirun -n 4 bin/Blaze"), std::string::npos);
+    EXPECT_NE(command.find("--nbays 12 --nfloors 2 --timers_file"), std::string::npos);
+}
+
+TEST_F(ScalingStudyTests, StrongScalingDatasetFromTimersFiles)
+{
+    read_spec("strong");
+    std::vector<ScalingRun> runs = study.plan_runs();
+    write_timers_file(runs[0], {8.0});
+    write_timers_file(runs[1], {4.0, 4.0});
+    write_timers_file(runs[2], {1.0, 2.0, 3.0, 2.0});
+    study.analyse();
+    const std::vector<ScalingResult>& results = study.get_results();
+    ASSERT_EQ(results.size(), 3);
+    EXPECT_DOUBLE_EQ(results[1].speedup, 2.0);
+    EXPECT_DOUBLE_EQ(results[1].efficiency, 1.0);
+    EXPECT_DOUBLE_EQ(results[1].stats.imbalance, 0.0);
+    EXPECT_DOUBLE_EQ(results[2].stats.min, 1.0);
+    EXPECT_DOUBLE_EQ(results[2].stats.mean, 2.0);
+    EXPECT_DOUBLE_EQ(results[2].stats.imbalance, 0.5);
+    EXPECT_DOUBLE_EQ(results[2].speedup, 8.0/3.0);
+    EXPECT_DOUBLE_EQ(results[2].efficiency, 2.0/3.0);
+
+    // the same runs 20% slower are caught against the dataset above.
+    std::string baseline_file = (output_dir/"baseline.csv").string();
+    std::ofstream baseline(baseline_file);
+    study.write_dataset(baseline);
+    baseline.close();
+    EXPECT_EQ(study.check_against_baseline(baseline_file, 0.1), 0);
+    write_timers_file(runs[2], {1.2, 2.4, 3.6, 2.4});
+    study.analyse();
+    EXPECT_EQ(study.check_against_baseline(baseline_file, 0.1), 1);
+}
+
+TEST_F(ScalingStudyTests, ReadsTimeKeeperDurations)
+{
+    TimeKeeper time_keeper;
+    time_keeper.add_timers({"assembly", "all"});
+    time_keeper.start_timer("all");
+    time_keeper.stop_timer("all");
+    time_keeper.collect_rank_durations({"assembly", "all"});
+    std::string file_name = (output_dir/"timers.csv").string();
+    std::ofstream out(file_name);
+    time_keeper.write_rank_durations_csv(out, {"assembly", "all"});
+    out.close();
+    std::map<std::string, std::vector<double>> durations = ScalingStudy::read_timers_file(file_name);
+    ASSERT_EQ(durations.size(), 2);
+    ASSERT_EQ(durations["all"].size(), 1);
+    EXPECT_NEAR(durations["all"][0], time_keeper.get_timer_duration("all"), 1e-9); // written with 10 significant digits.
+    EXPECT_DOUBLE_EQ(durations["assembly"][0], 0.0);
+}
+
+#endif
@@ -86,4 +86,162 @@ TEST_F(ScribeOnlyTests, CheckTrackedNodeDataValueTwice)
     EXPECT_NEAR(tracked_dof_vector[1], 2.0, BASIC_TOLERANCE);
 }
 
-#endif 
\ No newline at end of file
+TEST_F(ScribeOnlyTests, RecordEveryNStepsKeepsEveryNthStep)
+{
+    scribe.set_recording_policy(RecordEveryNSteps, 3);
+    for (int step = 1; step <= 7; ++step)
+    {
+        node->set_nodal_displacement(tracked_dof, step);
+        scribe.write_to_records();
+    }
+    Record record = scribe.get_record_library().back();
+    EXPECT_EQ(record.get_recorded_steps(), std::vector<int>({3, 6}));
+    EXPECT_EQ(record.get_recorded_data()[tracked_dof], std::vector<real>({3.0, 6.0}));
+}
+
+TEST_F(ScribeOnlyTests, RecordOnChangeSkipsSmallChanges)
+{
+    scribe.set_recording_policy(RecordOnChange, 1, 0.5);
+    for (real disp : {1.0, 1.2, 1.4, 1.6, 1.6, 3.0})
+    {
+        node->set_nodal_displacement(tracked_dof, disp);
+        scribe.write_to_records();
+    }
+    Record record = scribe.get_record_library().back();
+    EXPECT_EQ(record.get_recorded_steps(), std::vector<int>({1, 4, 6}));
+    EXPECT_EQ(record.get_recorded_data()[tracked_dof], std::vector<real>({1.0, 1.6, 3.0}));
+}
+
+TEST_F(ScribeOnlyTests, RecordReductionsKeepsNoHistory)
+{
+    std::shared_ptr<Node> other_node = std::make_shared<Node>(2, xyz);
+    scribe.track_nodes_by_ptr({other_node}, std::set<int>{tracked_dof});
+    scribe.set_recording_policy(RecordReductions);
+    for (real disp : {1.0, -2.0, 0.5})
+    {
+        node->set_nodal_displacement(tracked_dof, disp);
+        other_node->set_nodal_displacement(tracked_dof, 2*disp);
+        scribe.write_to_records();
+    }
+    Record record = scribe.get_record_library().front();
+    EXPECT_TRUE(record.get_recorded_data()[tracked_dof].empty());
+    EXPECT_NEAR(record.get_reduction(tracked_dof).max, 1.0, BASIC_TOLERANCE);
+    EXPECT_NEAR(record.get_reduction(tracked_dof).min, -2.0, BASIC_TOLERANCE);
+    EXPECT_EQ(record.get_reduction(tracked_dof).min_step, 2);
+
+    DoFReduction group_reduction = scribe.get_group_reduction(tracked_dof);
+    EXPECT_NEAR(group_reduction.max, 2.0, BASIC_TOLERANCE);
+    EXPECT_NEAR(group_reduction.get_envelope(), 4.0, BASIC_TOLERANCE);
+}
+
+/**
+ * @brief a smooth response with a kink, like the displacement of a node that yields part way through the analysis.
+ */
+inline std::vector<real> make_smooth_history(int num_values)
+{
+    std::vector<real> values(num_values);
+    for (int i = 0; i < num_values; ++i)
+    {
+        real t = i*0.01;
+        values[i] = (t < 2.0) ? -0.003*t : -0.006 - 0.02*(t - 2.0) + 1e-4*std::sin(3*t);
+    }
+    return values;
+}
+
+TEST(HistoryEncoding, XorRoundTripIsExact)
+{
+    std::vector<real> values = make_smooth_history(500);
+    values.insert(values.end(), {0.0, -0.0, 1e300, -1e-300, 0.0, 0.0});
+    std::string encoded = encode_history(values, XorHistory, 0.0);
+    std::vector<real> decoded = decode_history(encoded, values.size(), XorHistory, 0.0);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(std::bit_cast<std::uint64_t>(decoded[i]), std::bit_cast<std::uint64_t>(values[i]));
+    }
+    EXPECT_LT(encoded.size(), values.size()*sizeof(real));
+}
+
+TEST(HistoryEncoding, QuantisedStaysWithinErrorBound)
+{
+    real error_bound = 1e-6;
+    std::vector<real> values = make_smooth_history(500);
+    std::string encoded = encode_history(values, QuantisedHistory, error_bound);
+    std::vector<real> decoded = decode_history(encoded, values.size(), QuantisedHistory, error_bound);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_LE(std::abs(decoded[i] - values[i]), error_bound*(1 + 1e-9));
+    }
+    EXPECT_LT(encoded.size(), encode_history(values, XorHistory, 0.0).size());
+}
+
+TEST_F(ScribeOnlyTests, FlushedHistoryReadsBack)
+{
+    std::string file_prefix = (std::filesystem::temp_directory_path()/"blaze_scribe_test").string();
+    scribe.set_history_output(file_prefix);
+    std::vector<real> values = make_smooth_history(30);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        node->set_nodal_displacement(tracked_dof, values[i]);
+        scribe.write_to_records();
+        if (i == 11)
+            scribe.flush_records();
+    }
+    EXPECT_EQ(scribe.get_record_library().back().get_recorded_steps().size(), values.size() - 12);
+    scribe.finish_recording();
+    EXPECT_TRUE(scribe.get_record_library().back().get_recorded_steps().empty());
+
+    std::string file_name = Scribe::get_history_file_name(file_prefix, 0);
+    auto histories = read_history_file(file_name);
+    std::filesystem::remove(file_name);
+    ASSERT_EQ(histories.size(), 1);
+    DoFHistory& history = histories.at({1, tracked_dof});
+    ASSERT_EQ(history.steps.size(), values.size());
+    EXPECT_EQ(history.steps.front(), 1);
+    EXPECT_EQ(history.steps.back(), int(values.size()));
+    EXPECT_EQ(history.values, values);
+}
+
+/**
+ * @brief checks that the full-field snapshots hold the displacement of every node and are listed in the XDMF file.
+ * 
+ */
+TEST(FieldOutput, SnapshotsMatchNodalDisplacements)
+{
+    int divisions = 10;
+    std::string prefix = (std::filesystem::temp_directory_path()/"blaze_field_output_test").string();
+    Model model;
+    build_solver_test_cantilever(model, divisions, 10.0, -2e6);
+    model.initialise_solution_parameters(1.0, 10, 1e-4, 30);
+    model.set_field_output(5, prefix);
+    model.solve(-1);
+
+    size_t num_nodes = divisions + 1;
+    size_t num_elements = divisions;
+    size_t num_element_forces = 3;
+    size_t file_size = (9*num_nodes + (num_element_forces + 1)*num_elements)*sizeof(real) + (num_nodes + 3*num_elements)*sizeof(std::uint32_t);
+    EXPECT_TRUE(std::filesystem::exists(FieldWriter::get_file_name(prefix, 5)));
+    std::string file_name = FieldWriter::get_file_name(prefix, 10);
+    ASSERT_EQ(std::filesystem::file_size(file_name), file_size);
+
+    std::ifstream file(file_name, std::ios::binary);
+    std::vector<real> translations(3*num_nodes);
+    file.seekg(3*num_nodes*sizeof(real));
+    file.read(reinterpret_cast<char*>(translations.data()), translations.size()*sizeof(real));
+    for (size_t i = 0; i < num_nodes; ++i)
+    {
+        std::shared_ptr<Node> node = model.glob_mesh.get_node_by_record_id(i + 1, "all");
+        EXPECT_DOUBLE_EQ(translations[3*i], node->get_nodal_displacement(0));
+        EXPECT_DOUBLE_EQ(translations[3*i + 1], node->get_nodal_displacement(2));
+    }
+    EXPECT_DOUBLE_EQ(translations[3*divisions + 1], get_solver_test_tip_disp(model, 2));
+
+    std::ifstream xdmf(prefix + ".xdmf");
+    std::string xdmf_text((std::istreambuf_iterator<char>(xdmf)), std::istreambuf_iterator<char>());
+    EXPECT_NE(xdmf_text.find("step_5"), std::string::npos);
+    EXPECT_NE(xdmf_text.find("step_10"), std::string::npos);
+    std::filesystem::remove(FieldWriter::get_file_name(prefix, 5));
+    std::filesystem::remove(file_name);
+    std::filesystem::remove(prefix + ".xdmf");
+}
+
+#endif
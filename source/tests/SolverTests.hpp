@@ -0,0 +1,132 @@
+#ifndef SOLVER_TESTS_HPP
+#define SOLVER_TESTS_HPP
+
+#include <functional>
+#include "TestHelpers.hpp"
+
+/**
+ * @brief a solver configuration checked against the default LU solution of the cantilever built by \ref build_solver_test_cantilever.
+ */
+struct SolverConfiguration {
+    std::string name;
+    std::function<void(Model&)> configure; /**< called before the cantilever is built.*/
+    real relative_tolerance; /**< allowed difference from the tip displacement of the LU solution.*/
+    std::function<void(Model& lu_model, Model& model)> check_solver; /**< assertions specific to the configuration.*/
+};
+
+class SolverConfigurationTests : public ::testing::TestWithParam<SolverConfiguration> {
+  public:
+    Model lu_model;
+    Model model;
+    int divisions = 10;
+    real beam_length = 10.0;
+    real y_load = -2e6; // large enough to require several Newton iterations per step.
+
+    void SetUp() override {
+        build_solver_test_cantilever(lu_model, divisions, beam_length, y_load);
+        lu_model.initialise_solution_parameters(1.0, 10, 1e-4, 30);
+        lu_model.solve(-1);
+
+        GetParam().configure(model);
+        build_solver_test_cantilever(model, divisions, beam_length, y_load);
+        model.initialise_solution_parameters(1.0, 10, 1e-4, 30);
+        model.solve(-1);
+    }
+};
+
+TEST_P(SolverConfigurationTests, MatchesLUSolution)
+{
+    real lu_disp = get_solver_test_tip_disp(lu_model, 2);
+    real disp = get_solver_test_tip_disp(model, 2);
+    EXPECT_NEAR(disp, lu_disp, std::abs(GetParam().relative_tolerance*lu_disp));
+}
+
+TEST_P(SolverConfigurationTests, SolverSpecificChecks)
+{
+    GetParam().check_solver(lu_model, model);
+}
+
+INSTANTIATE_TEST_SUITE_P(SolverTests, SolverConfigurationTests, ::testing::Values(
+    SolverConfiguration{"SymmetricLDLT",
+        [](Model& model) {model.set_symmetric_stiffness(true);}, 1e-6,
+        [](Model&, Model& model) {
+            // no fallback for a positive definite K.
+            EXPECT_EQ(model.solver.get_num_lu_fallbacks(), 0);
+        }},
+    SolverConfiguration{"MatrixFree",
+        [](Model& model) {model.set_matrix_free(true);}, 1e-4,
+        [](Model&, Model& model) {
+            MatrixFreeSolver& mf_solver = model.solution_procedure.get_matrix_free_solver();
+            EXPECT_GT(mf_solver.get_num_solves(), 0);
+            EXPECT_GE(mf_solver.get_num_krylov_iterations(), mf_solver.get_num_solves());
+        }},
+    SolverConfiguration{"QuasiNewton",
+        [](Model& model) {model.set_quasi_newton(true, 10);}, 1e-4,
+        [](Model& lu_model, Model& model) {
+            // reuses the factorisation within a load step.
+            EXPECT_LT(model.solver.get_num_factorisations(), lu_model.solver.get_num_factorisations());
+        }},
+    SolverConfiguration{"TangentPredictor",
+        [](Model& model) {model.set_predictor(TangentPredictor);}, 1e-4,
+        [](Model& lu_model, Model& model) {
+            EXPECT_LT(model.solution_procedure.get_num_iterations(), lu_model.solution_procedure.get_num_iterations());
+            // the prediction reuses the factorisation of the previous step, saving one factorisation in each of the 9 steps after the first.
+            EXPECT_LE(model.solver.get_num_factorisations(), lu_model.solver.get_num_factorisations() - 9);
+        }},
+    SolverConfiguration{"SecantPredictor",
+        [](Model& model) {model.set_predictor(SecantPredictor);}, 1e-4,
+        [](Model& lu_model, Model& model) {
+            EXPECT_LT(model.solution_procedure.get_num_iterations(), lu_model.solution_procedure.get_num_iterations());
+        }}),
+    [](const ::testing::TestParamInfo<SolverConfiguration>& info) {return info.param.name;});
+
+/**
+ * @brief checks that skipping elements that did not move gives the same solution as re-evaluating every element, and that the first iteration of each load step is skipped entirely.
+ * 
+ */
+TEST(ElementSkipping, MatchesFullReevaluation)
+{
+    int divisions = 10;
+    int nsteps = 10;
+    Model skipping_model;
+    build_solver_test_cantilever(skipping_model, divisions, 10.0, -2e6);
+    skipping_model.initialise_solution_parameters(1.0, nsteps, 1e-4, 30);
+    skipping_model.solve(-1);
+
+    Model full_model;
+    build_solver_test_cantilever(full_model, divisions, 10.0, -2e6);
+    full_model.set_element_skip_tolerance(-1.0);
+    full_model.initialise_solution_parameters(1.0, nsteps, 1e-4, 30);
+    full_model.solve(-1);
+
+    EXPECT_DOUBLE_EQ(get_solver_test_tip_disp(skipping_model, 2), get_solver_test_tip_disp(full_model, 2));
+    EXPECT_EQ(skipping_model.solution_procedure.get_num_iterations(), full_model.solution_procedure.get_num_iterations());
+    EXPECT_GE(skipping_model.solution_procedure.get_num_skipped_element_updates(), nsteps*divisions);
+    EXPECT_EQ(full_model.solution_procedure.get_num_skipped_element_updates(), 0);
+}
+
+TEST(MatrixFreeProduct, MatchesAssembledStiffness)
+{
+    Model model;
+    build_solver_test_cantilever(model, 4, 4.0, -1e5);
+    std::vector<spnz> triplets;
+    for (int i = 0; i < model.glob_mesh.get_num_elems(); ++i)
+    {
+        std::vector<spnz> elem_triplets = model.glob_mesh.get_elem_by_id(i + 1)->get_global_stiffness_triplets();
+        triplets.insert(triplets.end(), elem_triplets.begin(), elem_triplets.end());
+    }
+    int ndofs = model.glob_mesh.get_ndofs();
+    spmat K = make_spd_mat(ndofs, ndofs);
+    K.setFromTriplets(triplets.begin(), triplets.end());
+
+    vec v = vec::LinSpaced(ndofs, 1.0, 2.0);
+    vec Kv;
+    model.glob_mesh.calc_stiffness_product(v, Kv);
+    vec diagonal;
+    model.glob_mesh.calc_stiffness_diagonal(diagonal);
+    vec Kv_assembled = K*v;
+    EXPECT_NEAR((Kv - Kv_assembled).norm(), 0.0, 1e-9*Kv_assembled.norm());
+    EXPECT_NEAR((diagonal - vec(K.diagonal())).norm(), 0.0, 1e-9*diagonal.norm());
+}
+
+#endif
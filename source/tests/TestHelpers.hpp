@@ -9,6 +9,7 @@
 #include <vector>
 #include <numeric>
 #include <cmath>
+#include <filesystem>
 #include <unistd.h>
 
 #include "gtest/gtest.h"
@@ -18,6 +19,7 @@
 
 #include "maths_defaults.hpp"
 #include "MPIWrappers.hpp"
+#include "ThreadPlacement.hpp"
 #include "node.hpp"
 
 #include "BeamElementBaseClass.hpp"
@@ -27,14 +29,18 @@
 
 
 #include "ElasticPlasticMaterial.hpp"
+#include "MenegottoPintoMaterial.hpp"
+#include "MaterialBatch.hpp"
 #include "MaterialFibre.hpp"
 #include "BeamColumnFiberSection.hpp"
 #include "Nonlinear2DPlasticBeamElement.hpp"
 
+#include "BinaryMesh.hpp"
 #include "global_mesh.hpp"
 #include "NodalLoad.hpp"
 #include "Scribe.hpp"
 #include "Model.hpp"
+#include "ScalingStudy.hpp"
 //@}
 /**
  * @name basic definitions
@@ -281,4 +287,38 @@ void check_vector_contents(std::vector<int_like> checked_vec, stl_container chec
     }
 }
 //@}
-#endif
\ No newline at end of file
+
+/**
+ * @brief builds a 2D cantilever of nonlinear elastic elements with a tip load in y, ready for \ref Model::initialise_solution_parameters.
+ */
+void build_solver_test_cantilever(Model& model, int divisions, real beam_length, real y_load)
+{
+    BasicSection sect(2.06e11, 0.0125, 0.0004570000);
+    model.create_line_mesh(divisions, {{0.0, 0.0, 0.0}, {beam_length, 0.0, 0.0}}, NonlinearElastic, sect);
+
+    NodalRestraint end_restraint;
+    end_restraint.assign_dofs_restraints(std::set<int>{0, 1, 2, 3, 4, 5});
+    end_restraint.assign_nodes_by_record_id(std::set<int>{1}, model.glob_mesh);
+    model.restraints.push_back(end_restraint);
+
+    std::vector<unsigned> free_nodes(divisions);
+    std::iota(free_nodes.begin(), free_nodes.end(), 2);
+    NodalRestraint out_of_plane_restraint;
+    out_of_plane_restraint.assign_dofs_restraints(std::set<int>{1, 3, 4});
+    out_of_plane_restraint.assign_nodes_by_record_id(free_nodes, model.glob_mesh);
+    model.restraints.push_back(out_of_plane_restraint);
+
+    model.load_manager.create_a_nodal_load_by_id(std::vector<unsigned>{(unsigned)(divisions+1)}, std::set<int>{2}, std::vector<real>{y_load}, model.glob_mesh);
+    model.scribe.track_nodes_by_id(std::set<unsigned>{(unsigned)(divisions+1)}, std::set<int>{0, 2}, model.glob_mesh);
+    model.initialise_restraints_n_loads();
+}
+
+/**
+ * @brief the last recorded displacement of the tip of a cantilever built by \ref build_solver_test_cantilever.
+ */
+real get_solver_test_tip_disp(Model& model, int dof)
+{
+    return model.scribe.get_record_library().back().get_recorded_data()[dof].back();
+}
+
+#endif
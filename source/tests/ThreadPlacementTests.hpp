@@ -0,0 +1,21 @@
+#ifndef THREAD_PLACEMENT_TESTS_HPP
+#define THREAD_PLACEMENT_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+/**
+ * @brief checks that the CPU of every thread is found, and that the NUMA domain lookup never fails with an error.
+ * 
+ */
+TEST(ThreadPlacement, FindsEveryThread)
+{
+    std::vector<int> cpus = get_thread_cpus();
+    ASSERT_EQ(cpus.size(), (size_t)get_max_num_threads());
+    for (int cpu : cpus)
+    {
+        EXPECT_GE(cpu, 0);
+        EXPECT_GE(get_numa_domain_of_cpu(cpu), -1);
+    }
+}
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef TIME_KEEPER_TESTS_HPP
+#define TIME_KEEPER_TESTS_HPP
+
+#include "TestHelpers.hpp"
+
+TEST(TimeKeeperTests, SplitsCommunicationFromCompute)
+{
+    TimeKeeper time_keeper;
+    time_keeper.add_timers({"assembly", "all"});
+    double site_duration_before = CommunicationTimer::get_site_durations().count("test_exchange") ? CommunicationTimer::get_site_durations().at("test_exchange") : 0.0;
+    time_keeper.start_timer("all");
+    usleep(2000);
+    time_keeper.start_timer("assembly");
+    {
+        CommunicationTimer communication("test_exchange");
+        usleep(5000);
+    }
+    time_keeper.stop_timer("assembly");
+    time_keeper.stop_timer("all");
+
+    double communication = CommunicationTimer::get_site_durations().at("test_exchange") - site_duration_before;
+    EXPECT_GE(communication, 4e-3);
+    // the communication is counted in both the timers running around it.
+    EXPECT_DOUBLE_EQ(time_keeper.get_communication_duration("assembly"), communication);
+    EXPECT_DOUBLE_EQ(time_keeper.get_communication_duration("all"), communication);
+    EXPECT_GE(time_keeper.get_compute_duration("all"), 1.5e-3);
+    EXPECT_NEAR(time_keeper.get_compute_duration("assembly") + communication, time_keeper.get_timer_duration("assembly"), 1e-12);
+
+    time_keeper.collect_rank_durations({"assembly"}, true);
+    std::stringstream timers_csv;
+    time_keeper.write_rank_durations_csv(timers_csv, {"assembly"});
+    std::string line;
+    std::vector<std::string> timers;
+    while (std::getline(timers_csv, line))
+    {
+        timers.push_back(line.substr(0, line.rfind(',')));
+    }
+    EXPECT_EQ(timers, (std::vector<std::string>{"rank,timer", "0,assembly", "0,assembly:compute", "0,assembly:communication"}));
+}
+
+TEST(TimeKeeperTests, AddsDurationsMeasuredOutside)
+{
+    TimeKeeper time_keeper;
+    time_keeper.add_timers({"assembly"});
+    time_keeper.start_timer("assembly");
+    usleep(1000);
+    time_keeper.stop_timer("assembly");
+    double measured = time_keeper.get_timer_duration("assembly");
+
+    ExecutionTimer task_timer;
+    task_timer.start();
+    usleep(1000);
+    task_timer.stop();
+    time_keeper.add_duration("assembly", task_timer.get_duration());
+    EXPECT_DOUBLE_EQ(time_keeper.get_timer_duration("assembly"), measured + task_timer.get_duration());
+    EXPECT_DOUBLE_EQ(time_keeper.get_communication_duration("assembly"), 0.0);
+}
+
+#endif
@@ -43,4 +43,18 @@ class TimeKeeperParallelTests : public ::testing::Test {
     }
     
   }
+  TEST_F(TimeKeeperParallelTests, communication_wait_split)
+  {
+    // the ranks arrive at the barrier one after the other, so all but the last wait there.
+    time_keeper.start_timer(timer_names[0]);
+    usleep(100000*rank);
+    {
+        CommunicationTimer communication("test_barrier");
+        MPI_Barrier(MPI_COMM_WORLD);
+    }
+    time_keeper.stop_timer(timer_names[0]);
+    EXPECT_NEAR(time_keeper.get_communication_duration(timer_names[0]), 0.1*(num_ranks - 1 - rank), 0.05);
+    EXPECT_NEAR(time_keeper.get_compute_duration(timer_names[0]), 0.1*rank, 0.05);
+    time_keeper.log_phase_balance({timer_names[0]});
+  }
 #endif
\ No newline at end of file
@@ -1,11 +1,18 @@
 #include "ElasticPlasticMaterialTests.hpp"
 #include "FibreSectionTests.hpp"
+#include "MaterialBatchTests.hpp"
 #include "BeamElementTests.hpp"
 #include "NodalLoadTests.hpp"
 #include "ScribeTest.hpp"
 #include "PlasticBeamElementTests.hpp"
 #include "ModelTests.hpp"
+#include "BinaryMeshTests.hpp"
 #include "PlasticModelTests.hpp"
+#include "SolverTests.hpp"
+#include "ElementSchedulingTests.hpp"
+#include "TimeKeeperTests.hpp"
+#include "ThreadPlacementTests.hpp"
+#include "ScalingStudyTests.hpp"
 
 #include "gtest/gtest.h"
 
@@ -1,5 +1,6 @@
 #include "ElasticVerificationTests.hpp"
 #include "PlasticVerificationTests.hpp"
+#include "DynamicVerificationTests.hpp"
 #include "gtest/gtest.h"
 
 int main(int argc, char **argv) {